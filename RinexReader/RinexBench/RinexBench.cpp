@@ -0,0 +1,368 @@
+/*
+* RinexBench.cpp : Times the Rinex readers stage by stage on synthetic or given files.
+*  Created on: Oct 17, 2026
+*  Author: Aaron Boda
+*
+*  RinexBench [options]
+*    --version 2|3    Rinex version of the synthetic files (3)
+*    --hours H        Length of the synthetic files (24)
+*    --interval S     Sampling interval in seconds (30)
+*    --gps N --glo N --gal N   Satellites per system (32, 24, 24), v2 files are GPS only
+*    --types N        Observation types per system (8), at most 9 for v2
+*    --blank R        Share of blank observations (0.02)
+*    --seed N         Seed of the generator (1), equal seeds give identical files
+*    --repeat N       Runs per stage, the best one is reported (5)
+*    --dir PATH       Where synthetic files are written (BenchData)
+*    --obs FILE --nav FILE     Time existing files instead, memory mapped stages need them uncompressed
+*    --verify DIR     Only checks the decompression of the fixtures in DIR (RinexReader/Input/Compressed)
+*                     against their plain references, exits with 1 on a mismatch
+*
+*  Built with RINEX_INSTRUMENT=1 it also prints the counters and stage timers of each stage as JSON
+*/
+
+#include "pch.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "InputStream.h"
+#include "KeplerBatch.h"
+#include "Instrumentation.h"
+#include "EpochRange.h"
+#include "Rinex2Nav.h"
+#include "Rinex2Obs.h"
+#include "Rinex3Nav.h"
+#include "Rinex3Obs.h"
+#include "SyntheticRinex.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+using namespace std;
+
+// *** ALLOCATION COUNTER
+// Every operator new of the program goes through here, so a stage's allocations are the difference of two readings
+static atomic<size_t> g_allocs(0);
+static atomic<size_t> g_allocBytes(0);
+
+void* operator new(size_t size) {
+	g_allocs.fetch_add(1, memory_order_relaxed);
+	g_allocBytes.fetch_add(size, memory_order_relaxed);
+	if (void* p = malloc(size > 0 ? size : 1)) { return p; }
+	throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Outcome of a stage: input consumed and items (headers, epochs, records) produced by one run
+struct StageRun {
+	size_t bytes;
+	size_t items;
+};
+
+// Best of several runs of a stage, allocations and instrumentation are those of the last run
+struct StageResult {
+	string name;
+	string unit;
+	StageRun run;
+	double seconds;
+	size_t allocs;
+	size_t allocBytes;
+	InstrumentSnapshot counters;
+};
+
+// Runs a stage repeatedly and keeps the fastest run
+template <typename Stage>
+StageResult timeStage(const string& name, const string& unit, int repeats, Stage stage) {
+	StageResult result;
+	result.name = name;
+	result.unit = unit;
+	result.seconds = 0;
+	for (int i = 0; i < max(repeats, 1); i++) {
+		size_t allocs = g_allocs.load();
+		size_t allocBytes = g_allocBytes.load();
+		instrumentReset();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		result.run = stage();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		result.allocs = g_allocs.load() - allocs;
+		result.allocBytes = g_allocBytes.load() - allocBytes;
+		result.counters = instrumentSnapshot();
+		if (i == 0 || seconds < result.seconds) { result.seconds = seconds; }
+	}
+	return result;
+}
+
+// Header of a memory mapped observation file
+template <typename Reader>
+StageRun mappedHeader(const MappedFile& file) {
+	Reader reader;
+	string_view text = file.view();
+	reader.obsHeader(text);
+	return StageRun{ file.size() - text.size(), 1 };
+}
+
+// Epochs of a memory mapped observation file, the header is parsed outside the timed loop by EpochRange
+template <typename Reader>
+StageRun mappedEpochs(const string& filename) {
+	EpochRange<Reader> range;
+	if (!range.open(filename)) { return StageRun{ 0, 0 }; }
+	size_t epochs = 0;
+	range.forEach([&epochs](const typename EpochRange<Reader>::Epoch&) { epochs++; });
+	return StageRun{ 0, epochs };
+}
+
+// Epochs read through the istream interface, as the example program does
+StageRun streamEpochs(const string& filename, int version) {
+	InputStream fin(filename);
+	size_t epochs = 0;
+	if (version == 2) {
+		Rinex2Obs OBS;
+		ofstream nolog;
+		OBS.obsHeader(fin);
+		while (!(fin >> std::ws).eof()) {
+			if (fin.fail()) { break; }
+			OBS.clearObs();
+			OBS.obsEpoch(fin, nolog, OBS._header.nObsTypes);
+			epochs++;
+		}
+	}
+	else {
+		Rinex3Obs OBS;
+		OBS.obsHeader(fin);
+		while (!(fin >> std::ws).eof()) {
+			if (fin.fail()) { break; }
+			OBS.obsEpoch(fin);
+			epochs++;
+		}
+	}
+	return StageRun{ 0, epochs };
+}
+
+// Whole navigation file
+StageRun navRecords(const string& filename, int version) {
+	InputStream fin(filename);
+	size_t records = 0;
+	if (version == 2) {
+		Rinex2Nav NAV;
+		NAV.readNav(fin);
+		for (const auto& prnNav : NAV._navDataGPS) { records += prnNav.second.size(); }
+	}
+	else {
+		Rinex3Nav NAV;
+		NAV.readMixed(fin);
+		for (const auto& prnNav : NAV._navGPS) { records += prnNav.second.size(); }
+		for (const auto& prnNav : NAV._navGLO) { records += prnNav.second.size(); }
+		for (const auto& prnNav : NAV._navGAL) { records += prnNav.second.size(); }
+	}
+	return StageRun{ 0, records };
+}
+
+// Batch of the GPS and GALILEO records of a navigation file, each evaluated at 16 epochs a minute apart
+void orbitBatch(const string& filename, int version, KeplerBatch& batch, vector<GpsTime>& times) {
+	InputStream fin(filename);
+	const int nEpochs = 16;
+	if (version == 2) {
+		Rinex2Nav NAV;
+		NAV.readNav(fin);
+		for (const auto& prnNav : NAV._navDataGPS) {
+			for (const Rinex2Nav::DataGPS& eph : prnNav.second) {
+				for (int i = 0; i < nEpochs; i++) { batch.add(eph); times.push_back(eph.gpsTime + i * 60.0); }
+			}
+		}
+	}
+	else {
+		Rinex3Nav NAV;
+		NAV.readMixed(fin);
+		for (const auto& prnNav : NAV._navGPS) {
+			for (const Rinex3Nav::DataGPS& eph : prnNav.second) {
+				for (int i = 0; i < nEpochs; i++) { batch.add(eph); times.push_back(eph.gpsTime + i * 60.0); }
+			}
+		}
+		for (const auto& prnNav : NAV._navGAL) {
+			for (const Rinex3Nav::DataGAL& eph : prnNav.second) {
+				for (int i = 0; i < nEpochs; i++) { batch.add(eph); times.push_back(eph.gpsTime + i * 60.0); }
+			}
+		}
+	}
+}
+
+// One line of the report
+void printResult(const StageResult& r) {
+	double mb = r.run.bytes / 1.0e6;
+	double rate = (r.seconds > 0) ? mb / r.seconds : 0;
+	double itemRate = (r.seconds > 0) ? r.run.items / r.seconds : 0;
+	double allocsPerItem = (r.run.items > 0) ? static_cast<double>(r.allocs) / r.run.items : 0;
+	double bytesPerItem = (r.run.items > 0) ? static_cast<double>(r.allocBytes) / r.run.items : 0;
+	cout << left << setw(24) << r.name << right << fixed
+		<< setw(10) << setprecision(3) << mb
+		<< setw(12) << setprecision(3) << r.seconds * 1000
+		<< setw(10) << setprecision(1) << rate
+		<< setw(14) << setprecision(0) << itemRate << " " << left << setw(8) << (r.unit + "/s") << right
+		<< setw(12) << setprecision(2) << allocsPerItem
+		<< setw(14) << setprecision(0) << bytesPerItem << "\n";
+}
+
+// *** DECOMPRESSION FIXTURES
+// Whole decompressed text of a file read through InputStream
+static string readAll(const string& filename, bool& corrupt) {
+	InputStream fin(filename);
+	string text;
+	char buffer[1 << 14];
+	while (fin.read(buffer, sizeof(buffer)) || fin.gcount() > 0) { text.append(buffer, static_cast<size_t>(fin.gcount())); }
+	corrupt = fin.corrupt();
+	return text;
+}
+
+// Each compressed fixture must give back its plain reference byte for byte, the truncated one
+// must be flagged corrupt and give back a prefix of it
+static int verifyCompressed(const string& dir) {
+	struct Fixture {
+		const char* file;
+		const char* reference;
+		bool truncated;
+	};
+	static const Fixture fixtures[] = {
+		{ "OBS.rnx.gz", "OBS.rnx", false },
+		{ "OBS_MULTI.rnx.gz", "OBS.rnx", false },
+		{ "OBS.rnx.Z", "OBS.rnx", false },
+		{ "OBS.crx", "OBS.rnx", false },
+		{ "OBS.crx.gz", "OBS.rnx", false },
+		{ "OBS.19d", "OBS.19o", false },
+		{ "OBS_TRUNC.rnx.gz", "OBS.rnx", true }
+	};
+	int failures = 0;
+	for (const Fixture& fixture : fixtures) {
+		bool corrupt = false, plainCorrupt = false;
+		string text = readAll(dir + "/" + fixture.file, corrupt);
+		string reference = readAll(dir + "/" + fixture.reference, plainCorrupt);
+		bool ok = !reference.empty() && !plainCorrupt && corrupt == fixture.truncated &&
+			(fixture.truncated ? text.size() < reference.size() && reference.compare(0, text.size(), text) == 0 : text == reference);
+		cout << (ok ? "OK    " : "FAIL  ") << fixture.file << " (" << text.size() << " of " << reference.size() << " bytes"
+			<< (corrupt ? ", corrupt" : "") << ")\n";
+		if (!ok) { failures++; }
+	}
+	return (failures == 0) ? 0 : 1;
+}
+
+// The program starts and ends inside main.
+int main(int argc, char* argv[])
+{
+	// *** OPTIONS
+	SyntheticRinex::Config config = SyntheticRinex::defaults();
+	int repeats = 5;
+	string dir = "BenchData";
+	string filePathObs, filePathNav;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		string key = argv[i];
+		string value = argv[i + 1];
+		if (key == "--version") { config.version = stoi(value); }
+		else if (key == "--hours") { config.hours = stod(value); }
+		else if (key == "--interval") { config.interval = stod(value); }
+		else if (key == "--gps") { config.nGPS = stoi(value); }
+		else if (key == "--glo") { config.nGLO = stoi(value); }
+		else if (key == "--gal") { config.nGAL = stoi(value); }
+		else if (key == "--types") { config.nObsTypes = stoi(value); }
+		else if (key == "--blank") { config.blankRatio = stod(value); }
+		else if (key == "--seed") { config.seed = static_cast<uint32_t>(stoul(value)); }
+		else if (key == "--repeat") { repeats = stoi(value); }
+		else if (key == "--dir") { dir = value; }
+		else if (key == "--obs") { filePathObs = value; }
+		else if (key == "--nav") { filePathNav = value; }
+		else if (key == "--verify") { return verifyCompressed(value); }
+		else {
+			cout << "ERROR: Unknown option " << key << "\n";
+			return 1;
+		}
+	}
+
+	// *** INPUT FILES, generated unless given
+	int version = config.version;
+	if (filePathObs.empty() || filePathNav.empty()) {
+		filesystem::create_directories(dir);
+		string ext = (config.version == 2) ? ".19" : ".rnx";
+		filePathObs = dir + "/SYNT_OBS" + ext + ((config.version == 2) ? "o" : "");
+		filePathNav = dir + "/SYNT_NAV" + ext + ((config.version == 2) ? "n" : "");
+		SyntheticRinex generator(config);
+		if (!generator.writeObs(filePathObs) || !generator.writeNav(filePathNav)) {
+			cout << "ERROR: Cannot write synthetic files to " << dir << "\n";
+			return 1;
+		}
+		version = (config.version == 2) ? 2 : 3;
+		cout << "Synthetic Rinex " << version << ": " << config.hours << " h at " << config.interval << " s, "
+			<< generator.nEpochs() << " epochs, GPS/GLO/GAL " << config.nGPS << "/" << config.nGLO << "/" << config.nGAL
+			<< ", " << config.nObsTypes << " types, seed " << config.seed << "\n";
+	}
+	else {
+		FileIO FIO;
+		InputStream fin(filePathObs);
+		int type = 0;
+		FIO.checkRinexVersionType(version, type, fin);
+	}
+	if (version != 2 && version != 3) {
+		cout << "ERROR: Unsupported Rinex version in " << filePathObs << "\n";
+		return 1;
+	}
+	size_t obsBytes = static_cast<size_t>(filesystem::file_size(filePathObs));
+	size_t navBytes = static_cast<size_t>(filesystem::file_size(filePathNav));
+	cout << "OBS: " << filePathObs << " (" << obsBytes << " bytes)\n";
+	cout << "NAV: " << filePathNav << " (" << navBytes << " bytes)\n\n";
+
+	// *** STAGES
+	vector<StageResult> results;
+	MappedFile obsFile;
+	obsFile.open(filePathObs);
+	// The header is short, it is timed over more runs to steady the result
+	results.push_back(timeStage("obs header (mapped)", "header", repeats * 20, [&]() {
+		return (version == 2) ? mappedHeader<Rinex2Obs>(obsFile) : mappedHeader<Rinex3Obs>(obsFile);
+	}));
+	size_t headerBytes = results.back().run.bytes;
+	obsFile.close();
+	results.push_back(timeStage("obs epochs (mapped)", "epoch", repeats, [&]() {
+		StageRun run = (version == 2) ? mappedEpochs<Rinex2Obs>(filePathObs) : mappedEpochs<Rinex3Obs>(filePathObs);
+		run.bytes = obsBytes - headerBytes;
+		return run;
+	}));
+	results.push_back(timeStage("obs epochs (stream)", "epoch", repeats, [&]() {
+		StageRun run = streamEpochs(filePathObs, version);
+		run.bytes = obsBytes;
+		return run;
+	}));
+	results.push_back(timeStage("nav records (stream)", "record", repeats, [&]() {
+		StageRun run = navRecords(filePathNav, version);
+		run.bytes = navBytes;
+		return run;
+	}));
+
+	// Satellite position, velocity and clock of every record, with the scalar code and with AVX2 if the processor has it
+	KeplerBatch batch;
+	vector<GpsTime> times;
+	OrbitStates states;
+	orbitBatch(filePathNav, version, batch, times);
+	batch.setSimd(false);
+	results.push_back(timeStage("orbits (scalar)", "state", repeats, [&]() {
+		batch.compute(times.data(), states);
+		return StageRun{ 0, batch.size() };
+	}));
+	if (KeplerBatch::simdAvailable()) {
+		batch.setSimd(true);
+		results.push_back(timeStage("orbits (avx2)", "state", repeats, [&]() {
+			batch.compute(times.data(), states);
+			return StageRun{ 0, batch.size() };
+		}));
+	}
+
+	// *** REPORT
+	cout << left << setw(24) << "stage" << right << setw(10) << "MB" << setw(12) << "best ms" << setw(10) << "MB/s"
+		<< setw(23) << "throughput" << setw(12) << "allocs/item" << setw(14) << "bytes/item" << "\n";
+	for (const StageResult& r : results) { printResult(r); }
+	// Builds with RINEX_INSTRUMENT=1 also break each stage down (timers slow the stages themselves)
+	if (instrumentEnabled()) {
+		cout << "\n";
+		for (const StageResult& r : results) { cout << left << setw(24) << r.name << r.counters.json() << "\n"; }
+	}
+	return 0;
+}
@@ -0,0 +1,345 @@
+/*
+* SyntheticRinex.cpp
+* Generates reproducible Rinex v2.11 / v3.03 observation and navigation files for benchmarking
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "SyntheticRinex.h"
+#include "TimeUtils.h"
+#include <cstdarg>
+#include <cstdio>
+
+using namespace std;
+
+// Files start on this day, at midnight
+static const int START_YEAR = 2019;
+static const int START_MONTH = 1;
+static const int START_DAY = 25;
+static const double PI = 3.14159265358979;
+
+// Observation codes handed out in this order, the first nObsTypes of a system go into the header
+static const char* const TYPES_GPS[] = { "C1C", "L1C", "D1C", "S1C", "C2W", "L2W", "D2W", "S2W", "C5X",
+	"L5X", "D5X", "S5X", "C1W", "L1W", "C2X", "L2X", "D2X", "S2X" };
+static const char* const TYPES_GLO[] = { "C1C", "L1C", "D1C", "S1C", "C2P", "L2P", "D2P", "S2P", "C1P",
+	"L1P", "C2C", "L2C", "D1P", "S1P", "D2C", "S2C" };
+static const char* const TYPES_GAL[] = { "C1X", "L1X", "D1X", "S1X", "C5X", "L5X", "D5X", "S5X", "C7X",
+	"L7X", "D7X", "S7X", "C8X", "L8X", "D8X", "S8X" };
+static const char* const TYPES_V2[] = { "C1", "L1", "D1", "S1", "P2", "L2", "D2", "S2", "P1" };
+
+// Appends formatted text to a line buffer
+static void appendf(string& s, const char* format, ...) {
+	char text[256];
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	if (n > 0) { s.append(text, min(static_cast<size_t>(n), sizeof(text) - 1)); }
+}
+
+// Header line, the label starts in column 61
+static void headerLine(string& s, const string& content, const char* label) {
+	size_t start = s.size();
+	s += content;
+	s.resize(start + 60, ' ');
+	s += label;
+	s += '\n';
+}
+
+// Civil date of a day count since 1970-01-01
+static void civilFromDays(int64_t z, int& y, int& m, int& d) {
+	z += 719468;
+	int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	int64_t doe = z - era * 146097;
+	int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	int64_t mp = (5 * doy + 2) / 153;
+	d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+	m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+	y = static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+}
+
+// Calendar fields of an offset in seconds from the start of the file
+static void calendar(double t, int& y, int& mo, int& d, int& h, int& mi, double& s) {
+	GpsTime start = GpsTime::fromCalendar(START_YEAR, START_MONTH, START_DAY, 0, 0, 0);
+	GpsTime epoch0 = GpsTime::fromCalendar(1970, 1, 1, 0, 0, 0);
+	int64_t days = static_cast<int64_t>(floor((start - epoch0) / 86400.0));
+	int64_t day = static_cast<int64_t>(floor(t / 86400.0));
+	civilFromDays(days + day, y, mo, d);
+	double sod = t - day * 86400.0;
+	h = static_cast<int>(sod / 3600);
+	mi = static_cast<int>((sod - h * 3600) / 60);
+	s = sod - h * 3600 - mi * 60;
+}
+
+// Carrier wavelength in meters from the band of an observation code
+static double wavelength(char band) {
+	switch (band) {
+	case '1': return 0.190293673;
+	case '2': return 0.244210213;
+	case '5': return 0.254828049;
+	case '7': return 0.248349369;
+	case '8': return 0.251547001;
+	default: return 0.2;
+	}
+}
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+SyntheticRinex::SyntheticRinex(const Config& config) : _config(config), _state(config.seed != 0 ? config.seed : 1) {
+	if (_config.version != 2) { _config.version = 3; }
+	// Rinex v2 files are GPS only for the v2 reader
+	if (_config.version == 2) {
+		_config.nGLO = 0;
+		_config.nGAL = 0;
+	}
+	const char systems[] = { 'G', 'R', 'E' };
+	for (char sys : systems) {
+		for (int prn = 1; prn <= nSats(sys); prn++) {
+			SatTrack track;
+			track.sys = sys;
+			track.prn = prn;
+			track.range = uniform(20.0e6, 26.0e6);
+			track.rate = uniform(-800.0, 800.0);
+			track.snr = uniform(35.0, 52.0);
+			_tracks.push_back(track);
+		}
+	}
+}
+SyntheticRinex::~SyntheticRinex() {}
+
+SyntheticRinex::Config SyntheticRinex::defaults() {
+	Config config;
+	config.version = 3;
+	config.hours = 24;
+	config.interval = 30;
+	config.nGPS = 32;
+	config.nGLO = 24;
+	config.nGAL = 24;
+	config.nObsTypes = 8;
+	config.blankRatio = 0.02;
+	config.seed = 1;
+	return config;
+}
+
+// xorshift32
+uint32_t SyntheticRinex::random() {
+	_state ^= _state << 13;
+	_state ^= _state >> 17;
+	_state ^= _state << 5;
+	return _state;
+}
+
+size_t SyntheticRinex::nEpochs() const {
+	if (_config.interval <= 0) { return 0; }
+	return static_cast<size_t>(floor(_config.hours * 3600 / _config.interval + 1e-9));
+}
+
+int SyntheticRinex::nSats(char sys) const {
+	switch (sys) {
+	case 'G': return min(max(_config.nGPS, 0), 32);
+	case 'R': return min(max(_config.nGLO, 0), 24);
+	case 'E': return min(max(_config.nGAL, 0), 36);
+	default: return 0;
+	}
+}
+
+// Observation codes written for a system
+vector<string> SyntheticRinex::obsTypes(char sys) const {
+	const char* const* table = TYPES_GPS;
+	size_t n = sizeof(TYPES_GPS) / sizeof(TYPES_GPS[0]);
+	if (_config.version == 2) { table = TYPES_V2; n = sizeof(TYPES_V2) / sizeof(TYPES_V2[0]); }
+	else if (sys == 'R') { table = TYPES_GLO; n = sizeof(TYPES_GLO) / sizeof(TYPES_GLO[0]); }
+	else if (sys == 'E') { table = TYPES_GAL; n = sizeof(TYPES_GAL) / sizeof(TYPES_GAL[0]); }
+	n = min(n, static_cast<size_t>(max(_config.nObsTypes, 1)));
+	return vector<string>(table, table + n);
+}
+
+// ********************************************************************************
+// Observation File
+
+void SyntheticRinex::obsHeader(ostream& out) {
+	string s;
+	int y, mo, d, h, mi; double sec;
+	calendar(0, y, mo, d, h, mi, sec);
+	if (_config.version == 2) {
+		headerLine(s, "     2.11           OBSERVATION DATA    G (GPS)", "RINEX VERSION / TYPE");
+	}
+	else {
+		headerLine(s, "     3.03           OBSERVATION DATA    M (MIXED)", "RINEX VERSION / TYPE");
+	}
+	headerLine(s, "SyntheticRinex      RinexBench", "PGM / RUN BY / DATE");
+	headerLine(s, "SYNT", "MARKER NAME");
+	headerLine(s, "   918130.0800 -4346072.6500  4561977.9000", "APPROX POSITION XYZ");
+	headerLine(s, "        0.1000        0.0000        0.0000", "ANTENNA: DELTA H/E/N");
+	if (_config.version == 2) {
+		vector<string> types = obsTypes('G');
+		string line;
+		appendf(line, "%6d", static_cast<int>(types.size()));
+		for (const string& type : types) { appendf(line, "%6s", type.c_str()); }
+		headerLine(s, line, "# / TYPES OF OBSERV");
+	}
+	else {
+		const char systems[] = { 'G', 'R', 'E' };
+		for (char sys : systems) {
+			if (nSats(sys) == 0) { continue; }
+			vector<string> types = obsTypes(sys);
+			// 13 codes per line, continuation lines are indented
+			for (size_t i = 0; i < types.size(); i += 13) {
+				string line;
+				if (i == 0) { appendf(line, "%c  %3d", sys, static_cast<int>(types.size())); }
+				else { line.append(6, ' '); }
+				for (size_t k = i; k < min(i + 13, types.size()); k++) { appendf(line, " %s", types[k].c_str()); }
+				headerLine(s, line, "SYS / # / OBS TYPES");
+			}
+		}
+	}
+	string line;
+	appendf(line, "%10.3f", _config.interval);
+	headerLine(s, line, "INTERVAL");
+	line.clear();
+	appendf(line, "  %4d    %2d    %2d    %2d    %2d   %10.7f     GPS", y, mo, d, h, mi, sec);
+	headerLine(s, line, "TIME OF FIRST OBS");
+	headerLine(s, "", "END OF HEADER");
+	out.write(s.data(), s.size());
+}
+
+// One epoch of all satellites, values move along each satellite's track
+void SyntheticRinex::obsEpoch(ostream& out, size_t epoch) {
+	double t = epoch * _config.interval;
+	int y, mo, d, h, mi; double sec;
+	calendar(t, y, mo, d, h, mi, sec);
+	string s;
+	int nSatsAll = static_cast<int>(_tracks.size());
+	if (_config.version == 2) {
+		appendf(s, " %02d %2d %2d %2d %2d%11.7f  0%3d", y % 100, mo, d, h, mi, sec, nSatsAll);
+		// 12 satellites per line
+		for (int i = 0; i < nSatsAll; i++) {
+			if (i > 0 && i % 12 == 0) { s += "\n"; s.append(32, ' '); }
+			appendf(s, "%c%02d", _tracks[i].sys, _tracks[i].prn);
+		}
+		s += '\n';
+	}
+	else {
+		appendf(s, "> %04d %02d %02d %02d %02d %010.7f  0%3d\n", y, mo, d, h, mi, sec, nSatsAll);
+	}
+	for (const SatTrack& track : _tracks) {
+		vector<string> types = obsTypes(track.sys);
+		double range = track.range + track.rate * t;
+		size_t start = s.size();
+		if (_config.version != 2) { appendf(s, "%c%02d", track.sys, track.prn); }
+		for (size_t k = 0; k < types.size(); k++) {
+			// Rinex v2 records wrap after 5 observations
+			if (_config.version == 2 && k > 0 && k % 5 == 0) { s += '\n'; }
+			if (uniform() < _config.blankRatio) {
+				s.append(16, ' ');
+				continue;
+			}
+			char kind = types[k][0];
+			double lambda = wavelength(types[k][1]);
+			double value;
+			if (kind == 'L') { value = range / lambda + uniform(-0.01, 0.01); }
+			else if (kind == 'D') { value = -track.rate / lambda; }
+			else if (kind == 'S') { value = track.snr + uniform(-1.0, 1.0); }
+			else { value = range + uniform(-1.5, 1.5); }
+			char lli = (kind == 'L' && uniform() < 0.001) ? '1' : ' ';
+			char ssi = (kind == 'L' || kind == 'C' || kind == 'P') ? static_cast<char>('0' + min(9, static_cast<int>(track.snr / 6))) : ' ';
+			appendf(s, "%14.3f%c%c", value, lli, ssi);
+		}
+		// Trailing blanks are not written, like most receivers' converters
+		size_t last = s.find_last_not_of(' ');
+		s.resize((last == string::npos || last < start) ? start : last + 1);
+		s += '\n';
+	}
+	out.write(s.data(), s.size());
+}
+
+bool SyntheticRinex::writeObs(const string& filename) {
+	ofstream out(filename, ios::binary | ios::trunc);
+	if (!out.is_open()) { return false; }
+	obsHeader(out);
+	size_t n = nEpochs();
+	for (size_t i = 0; i < n; i++) { obsEpoch(out, i); }
+	return out.good();
+}
+
+// ********************************************************************************
+// Navigation File
+
+void SyntheticRinex::navHeader(ostream& out) {
+	string s;
+	if (_config.version == 2) {
+		headerLine(s, "     2.11           N: GPS NAV DATA", "RINEX VERSION / TYPE");
+		headerLine(s, "SyntheticRinex      RinexBench", "PGM / RUN BY / DATE");
+		headerLine(s, "    0.1118D-07  0.2235D-07 -0.5960D-07 -0.1192D-06", "ION ALPHA");
+		headerLine(s, "    0.1167D+06  0.1638D+06 -0.6554D+05 -0.5243D+06", "ION BETA");
+	}
+	else {
+		headerLine(s, "     3.03           NAVIGATION DATA     MIXED", "RINEX VERSION / TYPE");
+		headerLine(s, "SyntheticRinex      RinexBench", "PGM / RUN BY / DATE");
+		headerLine(s, "GPSA   1.1176E-08  2.2352E-08 -5.9605E-08 -1.1921E-07", "IONOSPHERIC CORR");
+		headerLine(s, "GPSB   1.1674E+05  1.6384E+05 -6.5536E+04 -5.2429E+05", "IONOSPHERIC CORR");
+		headerLine(s, "GPUT -9.3132257462E-10-9.769962617E-15 233472 2037", "TIME SYSTEM CORR");
+	}
+	headerLine(s, "    18", "LEAP SECONDS");
+	headerLine(s, "", "END OF HEADER");
+	out.write(s.data(), s.size());
+}
+
+// One broadcast record, parameters are drawn around typical values of each system
+void SyntheticRinex::navRecord(ostream& out, char sys, int prn, double t) {
+	int y, mo, d, h, mi; double sec;
+	calendar(t, y, mo, d, h, mi, sec);
+	GpsTime time = GpsTime::fromCalendar(y, mo, d, h, mi, sec);
+	vector<double> p;
+	if (sys == 'R') {
+		p = { uniform(-1e-4, 1e-4), 0.0, time.sow(),
+			uniform(-25000.0, 25000.0), uniform(-3.5, 3.5), uniform(-3e-9, 3e-9), 0.0,
+			uniform(-25000.0, 25000.0), uniform(-3.5, 3.5), uniform(-3e-9, 3e-9), static_cast<double>(prn % 14 - 7),
+			uniform(-25000.0, 25000.0), uniform(-3.5, 3.5), uniform(-3e-9, 3e-9), 0.0 };
+	}
+	else {
+		bool gal = sys == 'E';
+		double iod = static_cast<double>(random() % 1024);
+		p = { uniform(-5e-4, 5e-4), uniform(-1e-11, 1e-11), 0.0,
+			iod, uniform(-100.0, 100.0), uniform(3e-9, 5e-9), uniform(-PI, PI),
+			uniform(-5e-6, 5e-6), uniform(0.0, 0.02), uniform(-5e-6, 5e-6), gal ? uniform(5440.5, 5440.7) : uniform(5153.5, 5153.8),
+			time.sow(), uniform(-2e-7, 2e-7), uniform(-PI, PI), uniform(-2e-7, 2e-7),
+			gal ? uniform(0.95, 0.99) : uniform(0.94, 0.98), uniform(100.0, 350.0), uniform(-PI, PI), uniform(-9e-9, -7e-9),
+			uniform(-5e-10, 5e-10), gal ? 516.0 : 1.0, static_cast<double>(time.week()), 0.0,
+			gal ? 3.12 : 2.0, 0.0, uniform(-1e-8, 1e-8), gal ? uniform(-1e-8, 1e-8) : iod,
+			time.sow() - 30, gal ? 0.0 : 4.0 };
+		if (gal) { p.pop_back(); }
+	}
+	string s;
+	if (_config.version == 2) {
+		appendf(s, "%02d %02d %02d %02d %02d %02d%5.1f", prn, y % 100, mo, d, h, mi, sec);
+	}
+	else {
+		appendf(s, "%c%02d %04d %02d %02d %02d %02d %02d", sys, prn, y, mo, d, h, mi, static_cast<int>(sec));
+	}
+	// Three parameters after the epoch, four on each following line
+	const char* indent = (_config.version == 2) ? "   " : "    ";
+	for (size_t i = 0; i < p.size(); i++) {
+		if (i >= 3 && (i - 3) % 4 == 0) { s += '\n'; s += indent; }
+		appendf(s, "%19.12e", p[i]);
+	}
+	s += '\n';
+	out.write(s.data(), s.size());
+}
+
+// GPS every 2 hours, Galileo every hour and GLONASS every 30 minutes
+bool SyntheticRinex::writeNav(const string& filename) {
+	ofstream out(filename, ios::binary | ios::trunc);
+	if (!out.is_open()) { return false; }
+	navHeader(out);
+	double duration = _config.hours * 3600;
+	const char systems[] = { 'G', 'R', 'E' };
+	for (char sys : systems) {
+		double step = (sys == 'G') ? 7200 : (sys == 'E') ? 3600 : 1800;
+		for (int prn = 1; prn <= nSats(sys); prn++) {
+			for (double t = 0; t < duration; t += step) { navRecord(out, sys, prn, t); }
+		}
+	}
+	return out.good();
+}
@@ -0,0 +1,74 @@
+#pragma once
+/*
+* SyntheticRinex.h
+* Generates reproducible Rinex v2.11 / v3.03 observation and navigation files for benchmarking
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include <cstdint>
+
+#ifndef SYNTHETICRINEX_H_
+#define SYNTHETICRINEX_H_
+
+class SyntheticRinex
+{
+public:
+	// Data Structures
+	struct Config {
+		// 2 (GPS only, as read by Rinex2Obs) or 3 (mixed)
+		int version;
+		double hours;
+		// Sampling interval in seconds
+		double interval;
+		int nGPS;
+		int nGLO;
+		int nGAL;
+		// Observation types per system, Rinex v2 headers are limited to 9
+		int nObsTypes;
+		// Share of observations left blank
+		double blankRatio;
+		uint32_t seed;
+	};
+
+	// CONSTRUCTOR
+	explicit SyntheticRinex(const Config& config);
+	// DESTRUCTOR
+	~SyntheticRinex();
+
+	// Functions
+	bool writeObs(const std::string& filename);
+	bool writeNav(const std::string& filename);
+	size_t nEpochs() const;
+	// Default configuration, one day at 30 s of a full GPS, GLONASS and Galileo sky
+	static Config defaults();
+
+private:
+	// Pseudo random numbers, identical on every platform for a given seed
+	uint32_t random();
+	double uniform() { return random() / 4294967296.0; }
+	double uniform(double a, double b) { return a + (b - a) * uniform(); }
+
+	void obsHeader(std::ostream& out);
+	void obsEpoch(std::ostream& out, size_t epoch);
+	void navHeader(std::ostream& out);
+	void navRecord(std::ostream& out, char sys, int prn, double t);
+	std::vector<std::string> obsTypes(char sys) const;
+	int nSats(char sys) const;
+
+	// Geometry of one satellite, ranges change linearly over the day
+	struct SatTrack {
+		char sys;
+		int prn;
+		double range;
+		double rate;
+		double snr;
+	};
+
+	Config _config;
+	uint32_t _state;
+	std::vector<SatTrack> _tracks;
+};
+
+#endif /* SYNTHETICRINEX_H_ */
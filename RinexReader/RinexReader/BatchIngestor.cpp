@@ -0,0 +1,155 @@
+/*
+* BatchIngestor.cpp
+* Reads the observation and navigation files of many stations on a thread pool
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "BatchIngestor.h"
+#include "FileIO.h"
+#include "InputStream.h"
+
+using namespace std;
+
+// Version from the first line, the stream is put back to its start for the reader
+// Going through InputStream means compressed files work too
+static int rinexStreamVersion(InputStream& fin) {
+	int version = 0, type = 0;
+	try {
+		FileIO FIO;
+		FIO.checkRinexVersionType(version, type, fin);
+	}
+	catch (const exception&) {
+		version = 0;
+	}
+	fin.clear();
+	fin.seekg(0);
+	return (version >= 2 && version <= 4) ? version : 0;
+}
+
+int rinexFileVersion(const string& filename) {
+	InputStream fin(filename);
+	return fin.is_open() ? rinexStreamVersion(fin) : 0;
+}
+
+// CONSTRUCTOR
+BatchIngestor::BatchIngestor(unsigned nThreads) : _pool(nThreads) {}
+
+vector<StationResult> BatchIngestor::run(const vector<StationFiles>& stations, const SinkFactory& makeSink) {
+	vector<StationResult> results(stations.size(), StationResult{ false, 0, 0, string() });
+	// One entry per navigation file, counting the stations that use it
+	map<string, NavEntry> navs;
+	vector<NavEntry*> navOf(stations.size());
+	for (size_t i = 0; i < stations.size(); i++) {
+		navOf[i] = &navs[stations[i].navFile];
+		navOf[i]->users++;
+	}
+	// Stations sharing a navigation file go one after the other, so each set is held for as short as possible
+	vector<size_t> order(stations.size());
+	for (size_t i = 0; i < order.size(); i++) { order[i] = i; }
+	stable_sort(order.begin(), order.end(), [&stations](size_t a, size_t b) { return stations[a].navFile < stations[b].navFile; });
+
+	for (size_t station : order) {
+		_pool.submit([this, station, &stations, &results, &navOf, &makeSink] {
+			const StationFiles& files = stations[station];
+			StationResult& result = results[station];
+			unique_ptr<StationSink> sink = makeSink ? makeSink(station, files) : nullptr;
+			shared_ptr<const NavSet> nav = acquireNav(*navOf[station], files.navFile, result.error);
+			if (nav) { readStation(files, nav, sink.get(), result); }
+			if (sink) { sink->finish(result); }
+			nav.reset();
+			releaseNav(*navOf[station]);
+		});
+	}
+	_pool.wait();
+	return results;
+}
+
+// The first station needing the file parses it, the others wait for it and share the result
+// A station without a navigation file gets an empty set
+shared_ptr<const NavSet> BatchIngestor::acquireNav(NavEntry& entry, const string& filename, string& error) {
+	lock_guard<mutex> lock(entry.mutex);
+	if (!entry.loaded) {
+		entry.loaded = true;
+		shared_ptr<NavSet> nav = make_shared<NavSet>();
+		if (!filename.empty()) {
+			InputStream fin(filename);
+			nav->version = fin.is_open() ? rinexStreamVersion(fin) : 0;
+			try {
+				if (!fin.is_open()) { entry.error = "Cannot open navigation file " + filename; }
+				else if (nav->version >= 3) { nav->nav3.readMixed(fin); }
+				else if (nav->version == 2) { nav->nav2.readNav(fin); }
+				else { entry.error = "Unknown Rinex version of navigation file " + filename; }
+			}
+			catch (const exception& e) {
+				entry.error = "Navigation file " + filename + ": " + e.what();
+			}
+			if (entry.error.empty() && fin.corrupt()) { entry.error = "Corrupt navigation file " + filename; }
+		}
+		if (entry.error.empty()) { entry.nav = nav; }
+	}
+	error = entry.error;
+	return entry.nav;
+}
+
+// The set is dropped with its last station, a later run parses it again
+void BatchIngestor::releaseNav(NavEntry& entry) {
+	lock_guard<mutex> lock(entry.mutex);
+	if (--entry.users == 0) { entry.nav.reset(); }
+}
+
+// Streams the epochs of one observation file to its sink
+void BatchIngestor::readStation(const StationFiles& files, const shared_ptr<const NavSet>& nav, StationSink* sink,
+	StationResult& result) {
+	InputStream fin(files.obsFile);
+	if (!fin.is_open()) {
+		result.error = "Cannot open observation file " + files.obsFile;
+		return;
+	}
+	result.version = rinexStreamVersion(fin);
+	try {
+		// Rinex 4 observation files have the Rinex 3 layout
+		if (result.version >= 3) {
+			Rinex3Obs OBS;
+			OBS.obsHeader(fin);
+			if (sink) { sink->header(OBS._Header, *nav); }
+			while (!(fin >> std::ws).eof()) {
+				if (fin.fail()) { break; }
+				OBS.obsEpoch(fin);
+				// Event records at the end of the file leave no epoch behind
+				if (OBS._EpochObs.epochRecord.empty()) { continue; }
+				result.nEpochs++;
+				if (sink) { sink->epoch(OBS._EpochObs); }
+			}
+		}
+		else if (result.version == 2) {
+			Rinex2Obs OBS;
+			// The v2 reader writes epoch problems to a log, batches do not keep one
+			ofstream log;
+			OBS.obsHeader(fin);
+			if (sink) { sink->header(OBS._header, *nav); }
+			while (!(fin >> std::ws).eof()) {
+				if (fin.fail()) { break; }
+				OBS.clearObs();
+				OBS.obsEpoch(fin, log, OBS._header.nObsTypes);
+				if (OBS._obsDataGPS.epochRecord.empty()) { continue; }
+				result.nEpochs++;
+				if (sink) { sink->epoch(OBS._obsDataGPS); }
+			}
+		}
+		else {
+			result.error = "Unknown Rinex version of observation file " + files.obsFile;
+			return;
+		}
+	}
+	catch (const exception& e) {
+		result.error = "Observation file " + files.obsFile + ": " + e.what();
+		return;
+	}
+	if (fin.corrupt()) {
+		result.error = "Corrupt observation file " + files.obsFile;
+		return;
+	}
+	result.ok = true;
+}
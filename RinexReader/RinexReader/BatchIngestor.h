@@ -0,0 +1,109 @@
+#pragma once
+/*
+* BatchIngestor.h
+* Reads the observation and navigation files of many stations on a thread pool
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex2Nav.h"
+#include "Rinex2Obs.h"
+#include "Rinex3Nav.h"
+#include "Rinex3Obs.h"
+#include "ThreadPool.h"
+#include <functional>
+#include <memory>
+
+#ifndef BATCHINGESTOR_H_
+#define BATCHINGESTOR_H_
+
+// Observation and navigation files of one station, plain or compressed
+struct StationFiles {
+	std::string obsFile;
+	std::string navFile;
+};
+
+// Outcome of one station
+struct StationResult {
+	bool ok;
+	// Rinex version of the observation file, 0 if it could not be read
+	int version;
+	size_t nEpochs;
+	std::string error;
+};
+
+// A navigation file parsed once and shared read only by every station using it
+// Only the reader of the file's version holds data
+struct NavSet {
+	int version = 0;
+	Rinex2Nav nav2;
+	// Rinex 3 and 4
+	Rinex3Nav nav3;
+};
+
+// Receives the data of one station in file order
+// A sink is only used by the worker reading its station, it does not need locking
+class StationSink
+{
+public:
+	// DESTRUCTOR
+	virtual ~StationSink() {}
+
+	// Functions
+	// Once the header is read, nav stays valid until finish() returns
+	virtual void header(const Rinex3Obs::ObsHeaderInfo& /*header*/, const NavSet& /*nav*/) {}
+	virtual void header(const Rinex2Obs::ObsHeaderInfo& /*header*/, const NavSet& /*nav*/) {}
+	// Each epoch, the storage is reused for the next one
+	virtual void epoch(const Rinex3Obs::ObsEpochInfo& /*epoch*/) {}
+	virtual void epoch(const Rinex2Obs::ObsEpochInfo& /*epoch*/) {}
+	// Last call, also made when the station failed
+	virtual void finish(const StationResult& /*result*/) {}
+};
+
+// Stations are processed whole, one per worker, and their epochs are streamed to the sink one at a time,
+// so memory stays at one epoch per worker plus the navigation sets in use
+// Navigation files are parsed on first use and shared by all stations naming the same file (eg: one
+// broadcast file per day). Stations are started grouped by navigation file and a set is released
+// once its last station finished, so only the sets of the stations in progress are held
+class BatchIngestor
+{
+public:
+	// Makes the sink of a station, station is its position in the list
+	// Called from the workers, possibly for several stations at the same time
+	typedef std::function<std::unique_ptr<StationSink>(size_t station, const StationFiles& files)> SinkFactory;
+
+	// CONSTRUCTOR
+	// Zero threads picks one per hardware thread
+	explicit BatchIngestor(unsigned nThreads = 0);
+
+	// Functions
+	// Reads every station and blocks until all are done, results[i] belongs to stations[i]
+	// A station that cannot be read is reported in its result and does not stop the others
+	std::vector<StationResult> run(const std::vector<StationFiles>& stations, const SinkFactory& makeSink);
+	unsigned threads() const { return _pool.size(); }
+
+private:
+	// A navigation file, loaded by the first station needing it
+	struct NavEntry {
+		std::mutex mutex;
+		std::shared_ptr<const NavSet> nav;
+		bool loaded = false;
+		std::string error;
+		// Stations of this run still to use it
+		size_t users = 0;
+	};
+
+	std::shared_ptr<const NavSet> acquireNav(NavEntry& entry, const std::string& filename, std::string& error);
+	void releaseNav(NavEntry& entry);
+	void readStation(const StationFiles& files, const std::shared_ptr<const NavSet>& nav, StationSink* sink,
+		StationResult& result);
+
+	// Attributes
+	ThreadPool _pool;
+};
+
+// Rinex version (2, 3 or 4) from the first line of a file, 0 if it is not recognized
+int rinexFileVersion(const std::string& filename);
+
+#endif /* BATCHINGESTOR_H_ */
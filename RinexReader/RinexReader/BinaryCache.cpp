@@ -0,0 +1,157 @@
+/*
+* BinaryCache.cpp
+* Versioned binary snapshot of parsed Rinex data, read back through a memory mapping
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "BinaryCache.h"
+#include <cstdio>
+#include <filesystem>
+
+using namespace std;
+
+static const char CACHE_MAGIC[8] = { 'R', 'N', 'X', 'C', 'A', 'C', 'H', 'E' };
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+
+// Sections are padded to keep every record array 8 byte aligned
+static uint64_t align8(uint64_t n) { return (n + 7) & ~static_cast<uint64_t>(7); }
+
+// Size and modification time of a file
+bool sourceStamp(const string& filename, uint64_t& size, int64_t& time) {
+	error_code ec;
+	size = filesystem::file_size(filename, ec);
+	if (ec) { return false; }
+	filesystem::file_time_type mtime = filesystem::last_write_time(filename, ec);
+	if (ec) { return false; }
+	time = static_cast<int64_t>(mtime.time_since_epoch().count());
+	return true;
+}
+
+// Cache next to its source
+string defaultCacheFile(const string& sourceFile) {
+	return sourceFile + ".cache";
+}
+
+// ********************************************************************************
+// Cache Writer
+
+// CONSTRUCTOR
+CacheWriter::CacheWriter(CacheKind kind) : _kind(kind) {}
+
+// Copies the records of a section
+void CacheWriter::add(uint32_t id, const void* records, uint32_t recordSize, uint64_t count) {
+	CacheSection section = { id, recordSize, 0, count };
+	_sections.push_back(section);
+	const char* bytes = static_cast<const char*>(records);
+	_data.push_back(vector<char>(bytes, bytes + recordSize * count));
+}
+
+// Writes header, section table and data
+bool CacheWriter::write(const string& cacheFile, const string& sourceFile) const {
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+	header.version = CACHE_VERSION;
+	header.kind = _kind;
+	if (!sourceStamp(sourceFile, header.sourceSize, header.sourceTime)) { return false; }
+	header.nSections = static_cast<uint32_t>(_sections.size());
+	header.byteOrder = CACHE_BYTE_ORDER;
+	// Data follows the section table
+	vector<CacheSection> sections = _sections;
+	uint64_t offset = align8(sizeof(CacheHeader) + sections.size() * sizeof(CacheSection));
+	for (size_t i = 0; i < sections.size(); i++) {
+		sections[i].offset = offset;
+		offset = align8(offset + _data[i].size());
+	}
+	string tmpFile = cacheFile + ".tmp";
+	{
+		ofstream fout(tmpFile, ios::binary | ios::trunc);
+		if (!fout.is_open()) { return false; }
+		static const char zeros[8] = { 0 };
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		fout.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(CacheSection));
+		uint64_t pos = sizeof(CacheHeader) + sections.size() * sizeof(CacheSection);
+		for (size_t i = 0; i < sections.size(); i++) {
+			fout.write(zeros, sections[i].offset - pos);
+			fout.write(_data[i].data(), _data[i].size());
+			pos = sections[i].offset + _data[i].size();
+		}
+		fout.write(zeros, align8(pos) - pos);
+		if (!fout.good()) {
+			fout.close();
+			remove(tmpFile.c_str());
+			return false;
+		}
+	}
+	remove(cacheFile.c_str());
+	return rename(tmpFile.c_str(), cacheFile.c_str()) == 0;
+}
+
+// ********************************************************************************
+// Cache Reader
+
+// CONSTRUCTOR
+CacheReader::CacheReader() : _sections(nullptr), _nSections(0) {}
+
+// Maps the cache and checks it still belongs to the source file
+bool CacheReader::open(const string& cacheFile, const string& sourceFile, CacheKind kind) {
+	_sections = nullptr;
+	_nSections = 0;
+	uint64_t size; int64_t time;
+	if (!sourceStamp(cacheFile, size, time) || !sourceStamp(sourceFile, size, time)) { return false; }
+	if (!_file.open(cacheFile)) { return false; }
+	if (_file.size() < sizeof(CacheHeader)) { _file.close(); return false; }
+	const CacheHeader* header = reinterpret_cast<const CacheHeader*>(_file.data());
+	if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0 || header->version != CACHE_VERSION ||
+		header->byteOrder != CACHE_BYTE_ORDER || header->kind != kind ||
+		header->sourceSize != size || header->sourceTime != time ||
+		sizeof(CacheHeader) + header->nSections * sizeof(CacheSection) > _file.size()) {
+		_file.close();
+		return false;
+	}
+	_sections = reinterpret_cast<const CacheSection*>(_file.data() + sizeof(CacheHeader));
+	_nSections = header->nSections;
+	// Every section has to lie within the file
+	for (uint32_t i = 0; i < _nSections; i++) {
+		const CacheSection& s = _sections[i];
+		if (s.offset % 8 != 0 || s.offset > _file.size() || s.recordSize * s.count > _file.size() - s.offset) {
+			_file.close();
+			_sections = nullptr;
+			_nSections = 0;
+			return false;
+		}
+	}
+	return true;
+}
+
+// Start of a section's records in the mapping
+const void* CacheReader::section(uint32_t id, uint32_t recordSize, uint64_t& count) const {
+	count = 0;
+	for (uint32_t i = 0; i < _nSections; i++) {
+		if (_sections[i].id != id) { continue; }
+		if (_sections[i].recordSize != recordSize) { return nullptr; }
+		count = _sections[i].count;
+		return _file.data() + _sections[i].offset;
+	}
+	return nullptr;
+}
+
+bool CacheReader::has(uint32_t id) const {
+	for (uint32_t i = 0; i < _nSections; i++) {
+		if (_sections[i].id == id) { return true; }
+	}
+	return false;
+}
+
+bool CacheReader::get(uint32_t id, vector<double>& values) const {
+	Span<double> s = records<double>(id);
+	values.assign(s.begin(), s.end());
+	return has(id);
+}
+
+bool CacheReader::get(uint32_t id, string& text) const {
+	Span<char> s = records<char>(id);
+	text.assign(s.begin(), s.end());
+	return has(id);
+}
@@ -0,0 +1,127 @@
+#pragma once
+/*
+* BinaryCache.h
+* Versioned binary snapshot of parsed Rinex data, read back through a memory mapping
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "MappedFile.h"
+#include "Span.h"
+#include <cstdint>
+
+#ifndef BINARYCACHE_H_
+#define BINARYCACHE_H_
+
+// Layout of a cache file, all sections start on 8 byte boundaries
+//   CacheHeader | CacheSection[nSections] | section data...
+// Each section holds count fixed-size records, so it can be used in place once mapped
+// The size and modification time of the source file are stamped in the header,
+// a cache whose source changed since is ignored
+// Raised whenever the layout of a section changes, older caches are then ignored
+static const uint32_t CACHE_VERSION = 4;
+
+// What a cache file holds
+enum CacheKind : uint32_t {
+	CACHE_NAV3 = 1,
+	CACHE_OBS2 = 2,
+	CACHE_OBS3 = 3,
+	CACHE_EPOCH_INDEX = 4
+};
+
+// Sections known to the readers
+enum CacheSectionId : uint32_t {
+	// * Navigation records and their per-PRN offset index
+	SEC_NAV_GPS = 1, SEC_NAV_GLO, SEC_NAV_GAL,
+	SEC_NAV_INDEX_GPS, SEC_NAV_INDEX_GLO, SEC_NAV_INDEX_GAL,
+	SEC_NAV_IALPHA, SEC_NAV_IBETA, SEC_NAV_GPUT, SEC_NAV_TIMECORR, SEC_NAV_LEAPSEC,
+	SEC_NAV_BDS, SEC_NAV_QZS, SEC_NAV_SBS, SEC_NAV_IRN,
+	SEC_NAV_INDEX_BDS, SEC_NAV_INDEX_QZS, SEC_NAV_INDEX_SBS, SEC_NAV_INDEX_IRN,
+	SEC_NAV_CNAV_GPS, SEC_NAV_CNAV_QZS, SEC_NAV_CNAV_BDS,
+	SEC_NAV_INDEX_CNAV_GPS, SEC_NAV_INDEX_CNAV_QZS, SEC_NAV_INDEX_CNAV_BDS,
+	// * Rinex 4 system time offset, earth orientation and ionospheric records
+	SEC_NAV_STO, SEC_NAV_EOP, SEC_NAV_ION,
+	// * Observation store columns and their per-satellite offset index
+	SEC_OBS_TIMES = 100, SEC_OBS_CLOCKS, SEC_OBS_TYPES, SEC_OBS_SATS, SEC_OBS_VALUES, SEC_OBS_LLI,
+	// * Observation file header, as text up to and including END OF HEADER
+	SEC_OBS_HEADER = 200,
+	// * Sparse epoch index, its entries and stride, epoch count, header end and version
+	SEC_EPOCH_ENTRIES = 300, SEC_EPOCH_INFO
+};
+
+struct CacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t kind;
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	uint32_t nSections;
+	// Written as 0x01020304, tells caches from machines of the other byte order apart
+	uint32_t byteOrder;
+};
+
+struct CacheSection {
+	uint32_t id;
+	uint32_t recordSize;
+	uint64_t offset;
+	uint64_t count;
+};
+
+// Collects sections in memory and writes them out as one cache file
+class CacheWriter
+{
+public:
+	// CONSTRUCTOR
+	explicit CacheWriter(CacheKind kind);
+
+	// Functions
+	void add(uint32_t id, const void* records, uint32_t recordSize, uint64_t count);
+	template <typename T>
+	void add(uint32_t id, const std::vector<T>& records) { add(id, records.data(), sizeof(T), records.size()); }
+	void add(uint32_t id, const std::string& text) { add(id, text.data(), 1, text.size()); }
+	// Written to a temporary file first and renamed, so readers never see a partial cache
+	bool write(const std::string& cacheFile, const std::string& sourceFile) const;
+
+private:
+	CacheKind _kind;
+	std::vector<CacheSection> _sections;
+	std::vector<std::vector<char>> _data;
+};
+
+// Maps a cache file and hands out its sections in place
+class CacheReader
+{
+public:
+	// CONSTRUCTOR
+	CacheReader();
+
+	// Functions
+	// False when the cache is missing, of another version or kind, or older than its source
+	bool open(const std::string& cacheFile, const std::string& sourceFile, CacheKind kind);
+	// Records of a section, empty when the section is missing or its records are of another size
+	template <typename T>
+	Span<T> records(uint32_t id) const {
+		uint64_t count = 0;
+		const void* data = section(id, sizeof(T), count);
+		return Span<T>(static_cast<const T*>(data), static_cast<size_t>(count));
+	}
+	bool has(uint32_t id) const;
+	bool get(uint32_t id, std::vector<double>& values) const;
+	bool get(uint32_t id, std::string& text) const;
+
+private:
+	const void* section(uint32_t id, uint32_t recordSize, uint64_t& count) const;
+
+	MappedFile _file;
+	const CacheSection* _sections;
+	uint32_t _nSections;
+};
+
+// Functions
+// Size and modification time of a file, false if it cannot be read
+bool sourceStamp(const std::string& filename, uint64_t& size, int64_t& time);
+// Where the cache of a source file goes unless told otherwise
+std::string defaultCacheFile(const std::string& sourceFile);
+
+#endif /* BINARYCACHE_H_ */
@@ -0,0 +1,412 @@
+/*
+* Decompress.cpp
+* Streaming byte sources for plain, gzip (.gz) and Unix compress (.Z) input files
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Decompress.h"
+
+using namespace std;
+
+// Size of the blocks read from the underlying source
+static const size_t INPUT_BLOCK = 1 << 16;
+
+// ********************************************************************************
+// File Source
+
+// Opens the file in binary mode, compressed data must not be translated
+bool FileSource::open(const string& filename) {
+	_file.open(filename, ios::binary);
+	if (!_file.is_open()) {
+		perror("Error while opening file");
+		return false;
+	}
+	return true;
+}
+
+size_t FileSource::read(char* out, size_t n) {
+	_file.read(out, static_cast<streamsize>(n));
+	return static_cast<size_t>(_file.gcount());
+}
+
+// ********************************************************************************
+// Bit Reader
+
+BitReader::BitReader(ByteSource& in) : _in(in), _buf(INPUT_BLOCK), _pos(0), _end(0), _bits(0), _count(0), _overrun(0) {}
+
+bool BitReader::fill() {
+	_pos = 0;
+	_end = _in.read(reinterpret_cast<char*>(_buf.data()), _buf.size());
+	return _end > 0;
+}
+
+bool BitReader::atEnd() {
+	return _count == 0 && _pos == _end && !fill();
+}
+
+// ********************************************************************************
+// Gzip Source
+
+// Base values and extra bits of the length and distance codes (RFC 1951, 3.2.5)
+static const short LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const short DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+// Order in which the code length code lengths are sent
+static const unsigned char CLEN_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// CONSTRUCTOR
+GzipSource::GzipSource(ByteSource& in) : _bits(in), _window(WINDOW_MASK + 1), _wpos(0), _state(MEMBER),
+	_lastBlock(false), _storedLeft(0), _copyLen(0), _copyDist(0), _crc(0xffffffff), _size(0), _members(0),
+	_litCode(nullptr), _distCode(nullptr), _crcTable(CRC_TABLE()) {}
+
+// CRC-32 of the gzip trailer, reflected polynomial 0xEDB88320
+const uint32_t* GzipSource::CRC_TABLE() {
+	struct Table {
+		uint32_t crc[256];
+		Table() {
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t c = i;
+				for (int k = 0; k < 8; k++) { c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; }
+				crc[i] = c;
+			}
+		}
+	};
+	static const Table table;
+	return table.crc;
+}
+
+// Builds the decoding tables from the code lengths of each symbol
+// Incomplete codes are accepted, over-subscribed ones are not
+bool GzipSource::Huffman::build(const unsigned char* lengths, int n) {
+	fill(count, count + 16, 0);
+	for (int i = 0; i < n; i++) { count[lengths[i]]++; }
+	count[0] = 0;
+	int left = 1;
+	for (int len = 1; len < 16; len++) {
+		left <<= 1;
+		left -= count[len];
+		if (left < 0) { return false; }
+	}
+	// Symbols sorted by code length, then by value
+	short offs[16];
+	offs[1] = 0;
+	for (int len = 1; len < 15; len++) { offs[len + 1] = offs[len] + count[len]; }
+	for (int i = 0; i < n; i++) {
+		if (lengths[i] != 0) { symbol[offs[lengths[i]]++] = static_cast<short>(i); }
+	}
+	// Short codes are indexed by their bit reversed value, as they come off the stream
+	fill(fast, fast + (1 << FAST_BITS), 0);
+	int code = 0;
+	int index = 0;
+	for (int len = 1; len <= FAST_BITS; len++) {
+		for (int k = 0; k < count[len]; k++, code++, index++) {
+			int rev = 0;
+			for (int b = 0; b < len; b++) { rev |= ((code >> b) & 1) << (len - 1 - b); }
+			for (int j = rev; j < (1 << FAST_BITS); j += 1 << len) {
+				fast[j] = static_cast<uint16_t>(symbol[index] | (len << 12));
+			}
+		}
+		code <<= 1;
+	}
+	return true;
+}
+
+// Decodes one symbol, -1 for a code that is not in the table
+int GzipSource::decode(const Huffman& h) {
+	uint16_t entry = h.fast[_bits.peek(FAST_BITS)];
+	if (entry != 0) {
+		_bits.drop(entry >> 12);
+		return entry & 0xfff;
+	}
+	// Long codes are walked one bit at a time
+	int code = 0, first = 0, index = 0;
+	for (int len = 1; len < 16; len++) {
+		code |= static_cast<int>(_bits.bits(1));
+		int count = h.count[len];
+		if (code - count < first) { return h.symbol[index + (code - first)]; }
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+	return -1;
+}
+
+// Reads the header of the next gzip member, false at the end of the file
+bool GzipSource::readMember() {
+	if (_bits.atEnd()) {
+		if (_members == 0) { _failed = true; }
+		return false;
+	}
+	uint32_t id1 = _bits.bits(8), id2 = _bits.bits(8);
+	if (id1 != 0x1f || id2 != 0x8b) {
+		// Anything after the last member is ignored, as gzip does
+		if (_members == 0) { _failed = true; }
+		return false;
+	}
+	uint32_t method = _bits.bits(8), flags = _bits.bits(8);
+	if (method != 8) { _failed = true; return false; }
+	// Modification time, extra flags and operating system
+	for (int i = 0; i < 6; i++) { _bits.bits(8); }
+	if (flags & 4) {
+		uint32_t xlen = _bits.bits(16);
+		for (uint32_t i = 0; i < xlen; i++) { _bits.bits(8); }
+	}
+	// Zero terminated file name and comment
+	for (uint32_t flag : { 8u, 16u }) {
+		if (!(flags & flag)) { continue; }
+		while (_bits.bits(8) != 0) {
+			if (_bits.overrun() > 0) { _failed = true; return false; }
+		}
+	}
+	if (flags & 2) { _bits.bits(16); }
+	if (_bits.overrun() > 0) { _failed = true; return false; }
+	_members++;
+	_crc = 0xffffffff;
+	_size = 0;
+	_lastBlock = false;
+	return true;
+}
+
+// Reads the header of a deflate block and sets up its codes
+bool GzipSource::readBlockHeader() {
+	// Codes of fixed blocks (RFC 1951, 3.2.6), built once
+	struct FixedCodes {
+		Huffman lit, dist;
+		FixedCodes() {
+			unsigned char lengths[288];
+			fill(lengths, lengths + 144, 8);
+			fill(lengths + 144, lengths + 256, 9);
+			fill(lengths + 256, lengths + 280, 7);
+			fill(lengths + 280, lengths + 288, 8);
+			lit.build(lengths, 288);
+			fill(lengths, lengths + 30, 5);
+			dist.build(lengths, 30);
+		}
+	};
+	static const FixedCodes fixed;
+	_lastBlock = _bits.bits(1) != 0;
+	switch (_bits.bits(2)) {
+	case 0: {
+		_bits.align();
+		uint32_t len = _bits.bits(16), nlen = _bits.bits(16);
+		if (len != (~nlen & 0xffff)) { return false; }
+		_storedLeft = len;
+		_state = STORED;
+		return true;
+	}
+	case 1:
+		_litCode = &fixed.lit;
+		_distCode = &fixed.dist;
+		_state = CODES;
+		return true;
+	case 2:
+		if (!readDynamicTables()) { return false; }
+		_litCode = &_lit;
+		_distCode = &_dist;
+		_state = CODES;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Code lengths of a dynamic block, themselves Huffman coded
+bool GzipSource::readDynamicTables() {
+	int nLen = static_cast<int>(_bits.bits(5)) + 257;
+	int nDist = static_cast<int>(_bits.bits(5)) + 1;
+	int nCode = static_cast<int>(_bits.bits(4)) + 4;
+	if (nLen > 286 || nDist > 30) { return false; }
+	unsigned char lengths[320] = { 0 };
+	for (int i = 0; i < nCode; i++) { lengths[CLEN_ORDER[i]] = static_cast<unsigned char>(_bits.bits(3)); }
+	Huffman lencode;
+	if (!lencode.build(lengths, 19)) { return false; }
+	int index = 0;
+	while (index < nLen + nDist) {
+		int sym = decode(lencode);
+		if (sym < 0 || _bits.overrun() > 4) { return false; }
+		if (sym < 16) { lengths[index++] = static_cast<unsigned char>(sym); continue; }
+		unsigned char len = 0;
+		int repeat;
+		if (sym == 16) {
+			if (index == 0) { return false; }
+			len = lengths[index - 1];
+			repeat = 3 + static_cast<int>(_bits.bits(2));
+		}
+		else if (sym == 17) { repeat = 3 + static_cast<int>(_bits.bits(3)); }
+		else { repeat = 11 + static_cast<int>(_bits.bits(7)); }
+		if (index + repeat > nLen + nDist) { return false; }
+		while (repeat--) { lengths[index++] = len; }
+	}
+	// A block without an end of block code could never finish
+	if (lengths[256] == 0) { return false; }
+	return _lit.build(lengths, nLen) && _dist.build(lengths + nLen, nDist);
+}
+
+// Inflates up to n bytes, stopping whenever the output is full
+size_t GzipSource::read(char* out, size_t n) {
+	size_t produced = 0;
+	while (produced < n && !_failed && _state != DONE) {
+		// Pending match from the history window
+		if (_copyLen > 0) {
+			size_t k = min(static_cast<size_t>(_copyLen), n - produced);
+			for (size_t i = 0; i < k; i++) {
+				unsigned char c = _window[(_wpos - _copyDist) & WINDOW_MASK];
+				emit(c);
+				out[produced++] = static_cast<char>(c);
+			}
+			_copyLen -= static_cast<int>(k);
+			continue;
+		}
+		switch (_state) {
+		case MEMBER:
+			_state = readMember() ? BLOCK : DONE;
+			break;
+		case BLOCK:
+			if (!readBlockHeader()) { _failed = true; }
+			break;
+		case STORED:
+			if (_storedLeft == 0) { _state = _lastBlock ? TRAILER : BLOCK; break; }
+			{
+				unsigned char c = static_cast<unsigned char>(_bits.bits(8));
+				if (_bits.exhausted()) { _failed = true; break; }
+				emit(c);
+				out[produced++] = static_cast<char>(c);
+				_storedLeft--;
+			}
+			break;
+		case CODES: {
+			// Zeros past the end of input would decode forever
+			if (_bits.overrun() > 4) { _failed = true; break; }
+			int sym = decode(*_litCode);
+			if (sym < 0 || _bits.exhausted()) { _failed = true; }
+			else if (sym < 256) {
+				emit(static_cast<unsigned char>(sym));
+				out[produced++] = static_cast<char>(sym);
+			}
+			else if (sym == 256) { _state = _lastBlock ? TRAILER : BLOCK; }
+			else {
+				sym -= 257;
+				if (sym >= 29) { _failed = true; break; }
+				int len = LENGTH_BASE[sym] + static_cast<int>(_bits.bits(LENGTH_EXTRA[sym]));
+				int dsym = decode(*_distCode);
+				if (dsym < 0 || dsym >= 30) { _failed = true; break; }
+				int dist = DIST_BASE[dsym] + static_cast<int>(_bits.bits(DIST_EXTRA[dsym]));
+				if (static_cast<size_t>(dist) > _wpos || _bits.exhausted()) { _failed = true; break; }
+				_copyLen = len;
+				_copyDist = dist;
+			}
+			break;
+		}
+		case TRAILER: {
+			_bits.align();
+			uint32_t crc = _bits.bits(16);
+			crc |= _bits.bits(16) << 16;
+			uint32_t size = _bits.bits(16);
+			size |= _bits.bits(16) << 16;
+			if (_bits.overrun() > 0 || crc != (_crc ^ 0xffffffff) || size != _size) { _failed = true; }
+			_state = MEMBER;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return produced;
+}
+
+// ********************************************************************************
+// LZW Source
+
+// CONSTRUCTOR
+LzwSource::LzwSource(ByteSource& in) : _bits(in), _started(false), _done(false), _maxBits(16), _nBits(9),
+	_maxCode(511), _freeEnt(257), _blockMode(true), _groupCodes(0), _oldCode(-1), _finChar(0) {}
+
+// Magic bytes followed by the largest code size and the block mode flag
+bool LzwSource::readHeader() {
+	uint32_t id1 = _bits.bits(8), id2 = _bits.bits(8);
+	if (id1 != 0x1f || id2 != 0x9d) { return false; }
+	uint32_t flags = _bits.bits(8);
+	_maxBits = flags & 0x1f;
+	_blockMode = (flags & 0x80) != 0;
+	if (_maxBits < 9 || _maxBits > 16 || _bits.overrun() > 0) { return false; }
+	_prefix.assign(static_cast<size_t>(1) << _maxBits, 0);
+	_suffix.assign(static_cast<size_t>(1) << _maxBits, 0);
+	for (int i = 0; i < 256; i++) { _suffix[i] = static_cast<unsigned char>(i); }
+	_freeEnt = _blockMode ? 257 : 256;
+	return true;
+}
+
+// Codes come in groups of eight, filling a whole number of bytes
+// A change of code size skips what is left of the current group, like compress does
+bool LzwSource::nextCode(int& code) {
+	if (_freeEnt > _maxCode) {
+		for (int i = _groupCodes % 8; i != 0 && i < 8; i++) { _bits.bits(_nBits); }
+		_groupCodes = 0;
+		_nBits++;
+		_maxCode = (_nBits == _maxBits) ? (1 << _maxBits) : (1 << _nBits) - 1;
+	}
+	code = static_cast<int>(_bits.bits(_nBits));
+	_groupCodes++;
+	// A partial code at the end of input is padding
+	return _bits.overrun() == 0;
+}
+
+// Expands codes until n bytes are out
+size_t LzwSource::read(char* out, size_t n) {
+	if (!_started) {
+		_started = true;
+		if (!readHeader()) { _failed = true; _done = true; }
+	}
+	size_t produced = 0;
+	while (produced < n) {
+		if (!_stack.empty()) {
+			out[produced++] = static_cast<char>(_stack.back());
+			_stack.pop_back();
+			continue;
+		}
+		int code;
+		if (_done || !nextCode(code)) { _done = true; break; }
+		if (_oldCode == -1) {
+			if (code >= 256) { _failed = true; _done = true; break; }
+			_oldCode = _finChar = code;
+			_stack.push_back(static_cast<unsigned char>(code));
+			continue;
+		}
+		if (code == 256 && _blockMode) {
+			for (int i = _groupCodes % 8; i != 0 && i < 8; i++) { _bits.bits(_nBits); }
+			_groupCodes = 0;
+			_freeEnt = 256;
+			_nBits = 9;
+			_maxCode = 511;
+			continue;
+		}
+		int inCode = code;
+		// Code defined by this very step (KwKwK)
+		if (code >= _freeEnt) {
+			if (code > _freeEnt) { _failed = true; _done = true; break; }
+			_stack.push_back(static_cast<unsigned char>(_finChar));
+			code = _oldCode;
+		}
+		while (code >= 256) {
+			_stack.push_back(_suffix[code]);
+			code = _prefix[code];
+		}
+		_finChar = code;
+		_stack.push_back(static_cast<unsigned char>(code));
+		if (_freeEnt < (1 << _maxBits)) {
+			_prefix[_freeEnt] = static_cast<uint16_t>(_oldCode);
+			_suffix[_freeEnt] = static_cast<unsigned char>(_finChar);
+			_freeEnt++;
+		}
+		_oldCode = inCode;
+	}
+	return produced;
+}
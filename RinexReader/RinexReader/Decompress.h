@@ -0,0 +1,151 @@
+#pragma once
+/*
+* Decompress.h
+* Streaming byte sources for plain, gzip (.gz) and Unix compress (.Z) input files
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include <cstdint>
+
+#ifndef DECOMPRESS_H_
+#define DECOMPRESS_H_
+
+// A sequential stream of bytes, sources are chained to undo each layer of compression
+class ByteSource
+{
+public:
+	virtual ~ByteSource() {}
+	// Reads up to n bytes into out, returns 0 once the source is exhausted
+	virtual size_t read(char* out, size_t n) = 0;
+	// Set when the input turned out to be corrupt or truncated
+	bool failed() const { return _failed; }
+
+protected:
+	bool _failed = false;
+};
+
+// Bytes of a file as they are on disk
+class FileSource : public ByteSource
+{
+public:
+	bool open(const std::string& filename);
+	size_t read(char* out, size_t n) override;
+
+private:
+	std::ifstream _file;
+};
+
+// Bit level access to a byte source, least significant bit first
+class BitReader
+{
+public:
+	explicit BitReader(ByteSource& in);
+	// Ensures n (<= 32) bits are buffered, zeros are shifted in past the end of input
+	void need(int n) {
+		while (_count < n) {
+			if (_pos == _end && !fill()) { _overrun++; _count += 8; continue; }
+			_bits |= static_cast<uint64_t>(_buf[_pos++]) << _count;
+			_count += 8;
+		}
+	}
+	uint32_t peek(int n) { need(n); return static_cast<uint32_t>(_bits & ((1ULL << n) - 1)); }
+	void drop(int n) { _bits >>= n; _count -= n; }
+	uint32_t bits(int n) { uint32_t v = peek(n); drop(n); return v; }
+	// Discards the bits left in the current byte
+	void align() { drop(_count % 8); }
+	// True once every input byte has been consumed
+	bool atEnd();
+	// Bytes made up past the end of input, more than a few means the stream was truncated
+	int overrun() const { return _overrun; }
+	// True once a made up bit has been consumed, what was decoded since is not real data
+	bool exhausted() const { return _overrun * 8 > _count; }
+
+private:
+	bool fill();
+
+	ByteSource& _in;
+	std::vector<unsigned char> _buf;
+	size_t _pos, _end;
+	uint64_t _bits;
+	int _count;
+	int _overrun;
+};
+
+// Inflates a gzip file (RFC 1951/1952), members following each other are joined
+// Memory is bounded by the 32 KB history window
+class GzipSource : public ByteSource
+{
+public:
+	// CONSTRUCTOR
+	explicit GzipSource(ByteSource& in);
+
+	size_t read(char* out, size_t n) override;
+
+private:
+	// Canonical Huffman code, codes up to FAST_BITS long are decoded with one table lookup
+	static const int FAST_BITS = 9;
+	struct Huffman {
+		short count[16];
+		short symbol[288];
+		// symbol | length << 12, zero when the code is longer than FAST_BITS
+		uint16_t fast[1 << FAST_BITS];
+		bool build(const unsigned char* lengths, int n);
+	};
+	enum State { MEMBER, BLOCK, STORED, CODES, TRAILER, DONE };
+
+	bool readMember();
+	bool readBlockHeader();
+	bool readDynamicTables();
+	int decode(const Huffman& h);
+	void emit(unsigned char c) {
+		_window[_wpos++ & WINDOW_MASK] = c;
+		_crc = _crcTable[(_crc ^ c) & 0xff] ^ (_crc >> 8);
+		_size++;
+	}
+	static const uint32_t* CRC_TABLE();
+
+	static const size_t WINDOW_MASK = 32767;
+	BitReader _bits;
+	std::vector<unsigned char> _window;
+	size_t _wpos;
+	State _state;
+	bool _lastBlock;
+	uint32_t _storedLeft;
+	int _copyLen, _copyDist;
+	uint32_t _crc, _size;
+	int _members;
+	// Codes of the current block, either the fixed ones or the dynamic tables below
+	const Huffman* _litCode;
+	const Huffman* _distCode;
+	Huffman _lit, _dist;
+	const uint32_t* _crcTable;
+};
+
+// Expands a Unix compress (.Z) file, LZW with up to 16 bit codes
+class LzwSource : public ByteSource
+{
+public:
+	// CONSTRUCTOR
+	explicit LzwSource(ByteSource& in);
+
+	size_t read(char* out, size_t n) override;
+
+private:
+	bool readHeader();
+	bool nextCode(int& code);
+
+	BitReader _bits;
+	bool _started, _done;
+	int _maxBits, _nBits, _maxCode, _freeEnt;
+	bool _blockMode;
+	int _groupCodes;
+	int _oldCode, _finChar;
+	std::vector<uint16_t> _prefix;
+	std::vector<unsigned char> _suffix;
+	// Expanded string of the last code, drained back to front
+	std::vector<unsigned char> _stack;
+};
+
+#endif /* DECOMPRESS_H_ */
@@ -0,0 +1,159 @@
+#pragma once
+/*
+* EphemerisIndex.h
+* Per-satellite time index over navigation records for fast ephemeris selection
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex2Nav.h"
+#include "Rinex3Nav.h"
+
+#ifndef EPHEMERISINDEX_H_
+#define EPHEMERISINDEX_H_
+
+// Validity rules of each navigation record type
+// maxAge is the largest distance between observation time and ephemeris time still accepted
+template <typename Eph> struct EphemerisTraits;
+
+template <> struct EphemerisTraits<Rinex2Nav::DataGPS> {
+	static bool healthy(const Rinex2Nav::DataGPS& eph) { return eph.svHealth == 0; }
+	// Fit interval is given in hours, zero stands for the nominal 4 hours
+	static double maxAge(const Rinex2Nav::DataGPS& eph) { return (eph.fit_interval > 0 ? eph.fit_interval : 4.0) * 1800.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataGPS> {
+	static bool healthy(const Rinex3Nav::DataGPS& eph) { return eph.svHealth == 0; }
+	static double maxAge(const Rinex3Nav::DataGPS& eph) { return (eph.fit_interval > 0 ? eph.fit_interval : 4.0) * 1800.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataGLO> {
+	static bool healthy(const Rinex3Nav::DataGLO& eph) { return eph.satHealth == 0; }
+	// Broadcast every 30 minutes
+	static double maxAge(const Rinex3Nav::DataGLO&) { return 1800.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataGAL> {
+	static bool healthy(const Rinex3Nav::DataGAL& eph) { return eph.svHealth == 0; }
+	static double maxAge(const Rinex3Nav::DataGAL&) { return 14400.0; }
+};
+// QZSS and NavIC records are DataGPS and share its rules
+template <> struct EphemerisTraits<Rinex3Nav::DataBDS> {
+	static bool healthy(const Rinex3Nav::DataBDS& eph) { return eph.SatH1 == 0; }
+	// Updated every hour
+	static double maxAge(const Rinex3Nav::DataBDS&) { return 3600.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataSBS> {
+	static bool healthy(const Rinex3Nav::DataSBS& eph) { return eph.satHealth == 0; }
+	static double maxAge(const Rinex3Nav::DataSBS&) { return 600.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataCNAV> {
+	static bool healthy(const Rinex3Nav::DataCNAV& eph) { return eph.svHealth == 0; }
+	// Fit interval of 3 hours
+	static double maxAge(const Rinex3Nav::DataCNAV&) { return 5400.0; }
+};
+template <> struct EphemerisTraits<Rinex3Nav::DataBDSCNAV> {
+	static bool healthy(const Rinex3Nav::DataBDSCNAV& eph) { return eph.svHealth == 0; }
+	static double maxAge(const Rinex3Nav::DataBDSCNAV&) { return 3600.0; }
+};
+
+template <typename Eph>
+class EphemerisIndex
+{
+public:
+	// CONSTRUCTOR
+	EphemerisIndex() {}
+	explicit EphemerisIndex(const std::map<int, std::vector<Eph>>& nav) { build(nav); }
+
+	// Functions
+	// Indexes the per-PRN navigation vectors of a reader, they are referenced and not copied
+	// The index has to be rebuilt if the navigation data changes
+	void build(const std::map<int, std::vector<Eph>>& nav) {
+		_sats.clear();
+		int maxPRN = nav.empty() ? -1 : nav.rbegin()->first;
+		_sats.resize(maxPRN < 0 ? 0 : maxPRN + 1);
+		for (const auto& prnNav : nav) {
+			if (prnNav.first < 0) { continue; }
+			SatIndex& sat = _sats[prnNav.first];
+			sat.records = &prnNav.second;
+			// Unhealthy records can never be selected, so they are left out
+			for (size_t i = 0; i < prnNav.second.size(); i++) {
+				const Eph& eph = prnNav.second[i];
+				if (!EphemerisTraits<Eph>::healthy(eph)) { continue; }
+				Entry entry = { eph.gpsTime, EphemerisTraits<Eph>::maxAge(eph), static_cast<int>(i) };
+				sat.entries.push_back(entry);
+			}
+			// Stable sort keeps file order between records of the same time
+			std::stable_sort(sat.entries.begin(), sat.entries.end(),
+				[](const Entry& a, const Entry& b) { return a.time < b.time; });
+		}
+	}
+
+	// Position in the PRN's navigation vector of the best valid ephemeris at time t, -1 if none
+	// Best is the healthy record closest in time, the earlier one on a tie
+	int findIndex(int prn, GpsTime t) const {
+		const SatIndex* sat = satIndex(prn);
+		if (sat == nullptr || sat->entries.empty()) { return -1; }
+		size_t i = std::lower_bound(sat->entries.begin(), sat->entries.end(), t,
+			[](const Entry& e, GpsTime time) { return e.time < time; }) - sat->entries.begin();
+		return select(*sat, i, t);
+	}
+	const Eph* find(int prn, GpsTime t) const {
+		int i = findIndex(prn, t);
+		return (i < 0) ? nullptr : &(*_sats[prn].records)[i];
+	}
+
+	// Same as find, for observation times that keep increasing
+	// A cursor per satellite walks forward, so a whole file costs O(1) per lookup
+	// Going back in time falls back to a binary search
+	int nextIndex(int prn, GpsTime t) {
+		SatIndex* sat = const_cast<SatIndex*>(satIndex(prn));
+		if (sat == nullptr || sat->entries.empty()) { return -1; }
+		size_t& i = sat->cursor;
+		if (i > 0 && sat->entries[i - 1].time >= t) {
+			i = std::lower_bound(sat->entries.begin(), sat->entries.end(), t,
+				[](const Entry& e, GpsTime time) { return e.time < time; }) - sat->entries.begin();
+		}
+		while (i < sat->entries.size() && sat->entries[i].time < t) { i++; }
+		return select(*sat, i, t);
+	}
+	const Eph* next(int prn, GpsTime t) {
+		int i = nextIndex(prn, t);
+		return (i < 0) ? nullptr : &(*_sats[prn].records)[i];
+	}
+
+	// Rewinds the cursors, for eg: when reading the observations again
+	void resetCursors() {
+		for (SatIndex& sat : _sats) { sat.cursor = 0; }
+	}
+
+private:
+	struct Entry {
+		GpsTime time;
+		double maxAge;
+		int index;
+	};
+	struct SatIndex {
+		const std::vector<Eph>* records = nullptr;
+		std::vector<Entry> entries;
+		size_t cursor = 0;
+	};
+
+	const SatIndex* satIndex(int prn) const {
+		if (prn < 0 || prn >= static_cast<int>(_sats.size())) { return nullptr; }
+		return &_sats[prn];
+	}
+
+	// Picks between the entries either side of t, i being the first one at or after t
+	static int select(const SatIndex& sat, size_t i, GpsTime t) {
+		const Entry* best = nullptr;
+		if (i > 0) { best = &sat.entries[i - 1]; }
+		if (i < sat.entries.size() && (best == nullptr || sat.entries[i].time - t < t - best->time)) {
+			best = &sat.entries[i];
+		}
+		if (best == nullptr || fabs(t - best->time) > best->maxAge) { return -1; }
+		return best->index;
+	}
+
+	std::vector<SatIndex> _sats;
+};
+
+#endif /* EPHEMERISINDEX_H_ */
@@ -0,0 +1,147 @@
+/*
+* EpochIndex.cpp
+* Sparse index of the epochs of an observation file, to start reading at a given time
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "EpochIndex.h"
+#include "BinaryCache.h"
+#include "FieldParser.h"
+#include "MappedFile.h"
+#include "Rinex2Obs.h"
+
+using namespace std;
+
+//  v3: > yyyy mm dd hh mm ss.sssssss  f nnn
+//  v2:  yy mm dd hh mm ss.sssssss  f nnn
+bool epochLineTime(string_view line, double version, double* epoch) {
+	if (version >= 3) {
+		if (line.empty() || line[0] != '>' || intField(line, 31, 1) > 1) { return false; }
+		static const size_t cols[][2] = { {2, 4}, {7, 2}, {10, 2}, {13, 2}, {16, 2}, {18, 11} };
+		for (size_t i = 0; i < 6; i++) { epoch[i] = floatField(line, cols[i][0], cols[i][1]); }
+	}
+	else {
+		if (!Rinex2Obs::isEpochLine(line) || intField(line, 28, 1) > 1) { return false; }
+		static const size_t cols[][2] = { {1, 2}, {4, 2}, {7, 2}, {10, 2}, {13, 2}, {15, 11} };
+		for (size_t i = 0; i < 6; i++) { epoch[i] = floatField(line, cols[i][0], cols[i][1]); }
+		// 80-99 are 1980-1999
+		epoch[0] += (epoch[0] < 80) ? 2000 : 1900;
+	}
+	return true;
+}
+
+// Offset of the first epoch line at or after pos, which has to be the start of a line, text.size() if there is none
+// A v3 epoch line is the only one starting with '>', so the scan jumps from one '>' to the next
+static size_t findEpoch(string_view text, size_t pos, double version, GpsTime& time) {
+	double epoch[6];
+	while (pos < text.size()) {
+		if (version >= 3) {
+			pos = text.find('>', pos);
+			if (pos == string_view::npos) { break; }
+			if (pos > 0 && text[pos - 1] != '\n') {
+				pos++;
+				continue;
+			}
+		}
+		size_t eol = text.find('\n', pos);
+		if (eol == string_view::npos) { eol = text.size(); }
+		string_view line = text.substr(pos, eol - pos);
+		if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+		if (epochLineTime(line, version, epoch)) {
+			time = gpsTime(epoch);
+			return pos;
+		}
+		pos = eol + 1;
+	}
+	return text.size();
+}
+
+// Start of the line after the one at pos
+static size_t nextLineStart(string_view text, size_t pos) {
+	size_t eol = text.find('\n', pos);
+	return (eol == string_view::npos) ? text.size() : eol + 1;
+}
+
+// CONSTRUCTOR
+EpochIndex::EpochIndex() : _stride(DEFAULT_STRIDE), _nEpochs(0), _body(0), _version(0) {}
+
+void EpochIndex::build(string_view text, size_t stride) {
+	const string_view sTokenEND = "END OF HEADER";
+	_entries.clear();
+	_stride = max<size_t>(stride, 1);
+	_nEpochs = 0;
+	_version = floatField(text, 0, 9);
+	size_t found = text.find(sTokenEND);
+	size_t eol = (found == string_view::npos) ? string_view::npos : text.find('\n', found);
+	_body = (eol == string_view::npos) ? text.size() : eol + 1;
+	GpsTime time;
+	for (size_t pos = findEpoch(text, _body, _version, time); pos < text.size();
+		pos = findEpoch(text, nextLineStart(text, pos), _version, time)) {
+		if (_nEpochs % _stride == 0) { _entries.push_back(Entry{ pos, time }); }
+		_nEpochs++;
+	}
+}
+
+// Plain files only, compressed ones have no byte offsets to jump to
+bool EpochIndex::build(const string& filename, size_t stride) {
+	MappedFile file;
+	if (!file.open(filename)) { return false; }
+	build(file.view(), stride);
+	return true;
+}
+
+bool EpochIndex::save(const string& indexFile, const string& sourceFile) const {
+	CacheWriter cache(CACHE_EPOCH_INDEX);
+	cache.add(SEC_EPOCH_ENTRIES, _entries);
+	vector<double> info = { static_cast<double>(_stride), static_cast<double>(_nEpochs), static_cast<double>(_body), _version };
+	cache.add(SEC_EPOCH_INFO, info);
+	return cache.write(indexFile, sourceFile);
+}
+
+bool EpochIndex::load(const string& indexFile, const string& sourceFile) {
+	CacheReader cache;
+	if (!cache.open(indexFile, sourceFile, CACHE_EPOCH_INDEX)) { return false; }
+	vector<double> info;
+	if (!cache.get(SEC_EPOCH_INFO, info) || info.size() < 4 || !cache.has(SEC_EPOCH_ENTRIES)) { return false; }
+	Span<Entry> entries = cache.records<Entry>(SEC_EPOCH_ENTRIES);
+	_entries.assign(entries.begin(), entries.end());
+	_stride = static_cast<size_t>(info[0]);
+	_nEpochs = static_cast<size_t>(info[1]);
+	_body = static_cast<uint64_t>(info[2]);
+	_version = info[3];
+	return true;
+}
+
+bool EpochIndex::open(const string& filename, const string& indexFile, size_t stride) {
+	string indexPath = indexFile.empty() ? defaultIndexFile(filename) : indexFile;
+	if (load(indexPath, filename)) { return true; }
+	if (!build(filename, stride)) { return false; }
+	// An index that cannot be written only costs the next run a scan
+	save(indexPath, filename);
+	return true;
+}
+
+// Next to its source, apart from the cache of the parsed observations
+string EpochIndex::defaultIndexFile(const string& sourceFile) {
+	return sourceFile + ".epochs";
+}
+
+uint64_t EpochIndex::before(GpsTime t) const {
+	// First entry after t, the one before it is the last at or before t
+	vector<Entry>::const_iterator it = upper_bound(_entries.begin(), _entries.end(), t,
+		[](GpsTime time, const Entry& entry) { return time < entry.time; });
+	return (it == _entries.begin()) ? _body : (it - 1)->offset;
+}
+
+uint64_t EpochIndex::seek(string_view text, GpsTime t) const {
+	uint64_t from = before(t);
+	if (from >= text.size()) { return text.size(); }
+	GpsTime time;
+	for (size_t pos = findEpoch(text, static_cast<size_t>(from), _version, time); pos < text.size();
+		pos = findEpoch(text, nextLineStart(text, pos), _version, time)) {
+		if (time >= t) { return pos; }
+	}
+	return text.size();
+}
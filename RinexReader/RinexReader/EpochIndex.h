@@ -0,0 +1,74 @@
+#pragma once
+/*
+* EpochIndex.h
+* Sparse index of the epochs of an observation file, to start reading at a given time
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "TimeUtils.h"
+#include <cstdint>
+
+#ifndef EPOCHINDEX_H_
+#define EPOCHINDEX_H_
+
+// File offset and time of every stride-th epoch line of a Rinex v2 or v3 observation file
+// Built by a byte scan over the epoch lines, the observations are not parsed
+//   EpochIndex index;
+//   index.open("OBS.rnx");
+//   EpochRange<Rinex3Obs> range("OBS.rnx");
+//   range.seek(index, start);
+//   range.forEach([&](const Rinex3Obs::ObsEpochInfo& epoch) { if (epoch.gpsTime >= stop) return false; ...; return true; });
+class EpochIndex
+{
+public:
+	static const size_t DEFAULT_STRIDE = 64;
+
+	struct Entry {
+		uint64_t offset;
+		GpsTime time;
+	};
+
+	// CONSTRUCTOR
+	EpochIndex();
+
+	// Functions
+	// Indexes a whole file held in text, offsets are counted from its first byte
+	void build(std::string_view text, size_t stride = DEFAULT_STRIDE);
+	bool build(const std::string& filename, size_t stride = DEFAULT_STRIDE);
+	// * Persisted next to the observation file, valid until the file changes
+	bool save(const std::string& indexFile, const std::string& sourceFile) const;
+	bool load(const std::string& indexFile, const std::string& sourceFile);
+	// Index of a file read from its index file, built and saved when that is missing or stale
+	bool open(const std::string& filename, const std::string& indexFile = "", size_t stride = DEFAULT_STRIDE);
+	static std::string defaultIndexFile(const std::string& sourceFile);
+
+	// Offset of the last indexed epoch at or before t, the first byte after the header if there is none
+	uint64_t before(GpsTime t) const;
+	// Offset of the first epoch at or after t in the indexed text, text.size() if there is none
+	// Only the epoch lines between the indexed one before t and the result are looked at
+	uint64_t seek(std::string_view text, GpsTime t) const;
+
+	const std::vector<Entry>& entries() const { return _entries; }
+	size_t stride() const { return _stride; }
+	size_t nEpochs() const { return _nEpochs; }
+	uint64_t bodyOffset() const { return _body; }
+	double version() const { return _version; }
+
+private:
+	// Attributes
+	std::vector<Entry> _entries;
+	size_t _stride;
+	size_t _nEpochs;
+	// First byte after END OF HEADER
+	uint64_t _body;
+	double _version;
+};
+
+// Functions
+// Year, month, day, hour, minute and second of an epoch line holding observations (epoch flag 0 or 1)
+// False for any other line, two digit years of Rinex 2 are made full years
+bool epochLineTime(std::string_view line, double version, double* epoch);
+
+#endif /* EPOCHINDEX_H_ */
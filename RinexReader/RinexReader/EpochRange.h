@@ -0,0 +1,147 @@
+#pragma once
+/*
+* EpochRange.h
+* Streaming access to the epochs of an observation file, pull (iterators) and push (visitor) style
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "EpochIndex.h"
+#include "MappedFile.h"
+#include "Rinex2Obs.h"
+#include "Rinex3Obs.h"
+#include <iterator>
+#include <type_traits>
+
+#ifndef EPOCHRANGE_H_
+#define EPOCHRANGE_H_
+
+// How each observation reader parses an epoch from a memory mapped file and where it keeps it
+template <typename Reader> struct EpochReaderTraits;
+
+template <> struct EpochReaderTraits<Rinex3Obs> {
+	typedef Rinex3Obs::ObsHeaderInfo Header;
+	typedef Rinex3Obs::ObsEpochInfo Epoch;
+	static const Header& header(const Rinex3Obs& reader) { return reader._Header; }
+	static const Epoch& epoch(const Rinex3Obs& reader) { return reader._EpochObs; }
+	static bool next(Rinex3Obs& reader, std::string_view& text) { return reader.obsEpoch(text); }
+};
+template <> struct EpochReaderTraits<Rinex2Obs> {
+	typedef Rinex2Obs::ObsHeaderInfo Header;
+	typedef Rinex2Obs::ObsEpochInfo Epoch;
+	static const Header& header(const Rinex2Obs& reader) { return reader._header; }
+	static const Epoch& epoch(const Rinex2Obs& reader) { return reader._obsDataGPS; }
+	static bool next(Rinex2Obs& reader, std::string_view& text) { return reader.obsEpoch(text, reader._header.nObsTypes); }
+};
+
+// An observation file as a single pass sequence of epochs
+// Every epoch is parsed into the same reused storage, the view handed out is valid until the next one is read
+//   for (const Rinex3Obs::ObsEpochInfo& epoch : EpochRange<Rinex3Obs>("OBS.rnx")) { ... }
+template <typename Reader>
+class EpochRange
+{
+public:
+	typedef typename EpochReaderTraits<Reader>::Header Header;
+	typedef typename EpochReaderTraits<Reader>::Epoch Epoch;
+
+	// Input iterator, all copies share the position of the range
+	class iterator
+	{
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef Epoch value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Epoch* pointer;
+		typedef const Epoch& reference;
+
+		iterator() : _range(nullptr) {}
+		reference operator*() const { return _range->current(); }
+		pointer operator->() const { return &_range->current(); }
+		iterator& operator++() {
+			if (!_range->next()) { _range = nullptr; }
+			return *this;
+		}
+		void operator++(int) { ++*this; }
+		bool operator==(const iterator& rhs) const { return _range == rhs._range; }
+		bool operator!=(const iterator& rhs) const { return _range != rhs._range; }
+
+	private:
+		friend class EpochRange;
+		explicit iterator(EpochRange* range) : _range(range) {}
+		EpochRange* _range;
+	};
+
+	// CONSTRUCTOR
+	EpochRange() {}
+	explicit EpochRange(const std::string& filename) { open(filename); }
+	// The mapping is owned, so the object cannot be copied
+	EpochRange(const EpochRange&) = delete;
+	EpochRange& operator=(const EpochRange&) = delete;
+
+	// Functions
+	// Maps the file and reads its header, epochs are read as the range is walked
+	bool open(const std::string& filename) {
+		if (!_file.open(filename)) { return false; }
+		openView(_file.view());
+		return true;
+	}
+	// Same over text already in memory, which has to outlive the range
+	void openView(std::string_view text) {
+		_all = text;
+		_text = text;
+		_reader.obsHeader(_text);
+		_headerText = _all.substr(0, _all.size() - _text.size());
+		_isOpen = true;
+	}
+	bool isOpen() const { return _isOpen; }
+	const Header& header() const { return EpochReaderTraits<Reader>::header(_reader); }
+	// Header lines as they are in the file
+	std::string_view headerText() const { return _headerText; }
+	// Reader holding the observation types, for eg: for specificObsMapper
+	const Reader& reader() const { return _reader; }
+
+	// Moves to the first epoch at or after t, using an index of the same file
+	// The epochs before it are not parsed, false if there is none
+	bool seek(const EpochIndex& index, GpsTime t) {
+		if (!_isOpen || index.bodyOffset() > _all.size()) { return false; }
+		_text = _all.substr(static_cast<size_t>(index.seek(_all, t)));
+		return !_text.empty();
+	}
+
+	// Pull style, begin() reads the first epoch that was not consumed yet
+	iterator begin() { return next() ? iterator(this) : iterator(); }
+	iterator end() { return iterator(); }
+
+	// Push style, visit is called with each remaining epoch in file order
+	// A visitor returning bool stops the walk by returning false
+	// Returns the number of epochs visited
+	template <typename Visitor>
+	size_t forEach(Visitor&& visit) {
+		size_t count = 0;
+		while (next()) {
+			count++;
+			if constexpr (std::is_same<decltype(visit(current())), bool>::value) {
+				if (!visit(current())) { break; }
+			}
+			else {
+				visit(current());
+			}
+		}
+		return count;
+	}
+
+private:
+	bool next() { return _isOpen && EpochReaderTraits<Reader>::next(_reader, _text); }
+	const Epoch& current() const { return EpochReaderTraits<Reader>::epoch(_reader); }
+
+	MappedFile _file;
+	// Whole file and the part not read yet
+	std::string_view _all;
+	std::string_view _text;
+	std::string_view _headerText;
+	Reader _reader;
+	bool _isOpen = false;
+};
+
+#endif /* EPOCHRANGE_H_ */
@@ -0,0 +1,137 @@
+/*
+* FieldParser.cpp
+* Locale-free fixed-column numeric field parsing for Rinex records
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "FieldParser.h"
+#include "Instrumentation.h"
+
+using namespace std;
+
+// Powers of ten that are exactly representable as doubles
+static const double exactPow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// Combines an integer mantissa with a decimal exponent
+// With an exact mantissa and |scale| <= 22 a single multiply/divide rounds exactly like stod
+static double composeDecimal(unsigned long long mantissa, int scale) {
+	double value = static_cast<double>(mantissa);
+	if (mantissa == 0) { return 0.0; }
+	if (mantissa < (1ULL << 53) && scale >= -22 && scale <= 22) {
+		return (scale >= 0) ? value * exactPow10[scale] : value / exactPow10[-scale];
+	}
+	// Rare slow path (very long mantissa or large exponent), at most an ulp off
+	while (scale > 22) { value *= exactPow10[22]; scale -= 22; }
+	while (scale < -22) { value /= exactPow10[22]; scale += 22; }
+	return (scale >= 0) ? value * exactPow10[scale] : value / exactPow10[-scale];
+}
+
+// Parses a floating point field such as "  24797528.782" or "-1.510949805379D-04"
+bool parseFloatField(const char* p, size_t n, double& value) {
+	size_t i = 0;
+	while (i < n && p[i] == ' ') { i++; }
+	if (i == n) {
+		RINEX_COUNT(COUNT_BLANK_FIELDS, 1);
+		return false;
+	}
+	// Sign
+	bool negative = false;
+	if (p[i] == '-' || p[i] == '+') { negative = (p[i] == '-'); i++; }
+	// Mantissa, only the first 19 significant digits are kept
+	unsigned long long mantissa = 0;
+	int nDigits = 0; int scale = 0; bool anyDigit = false;
+	for (; i < n && p[i] >= '0' && p[i] <= '9'; i++) {
+		anyDigit = true;
+		if (nDigits < 19) {
+			mantissa = mantissa * 10 + static_cast<unsigned>(p[i] - '0');
+			if (mantissa != 0) { nDigits++; }
+		}
+		else { scale++; }
+	}
+	if (i < n && p[i] == '.') {
+		for (i++; i < n && p[i] >= '0' && p[i] <= '9'; i++) {
+			anyDigit = true;
+			if (nDigits < 19) {
+				mantissa = mantissa * 10 + static_cast<unsigned>(p[i] - '0');
+				if (mantissa != 0) { nDigits++; }
+				scale--;
+			}
+		}
+	}
+	if (!anyDigit) {
+		RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+		return false;
+	}
+	// Exponent, Fortran writes 'D' where C writes 'E'
+	if (i < n && (p[i] == 'D' || p[i] == 'd' || p[i] == 'E' || p[i] == 'e')) {
+		i++;
+		bool negativeExp = false;
+		if (i < n && (p[i] == '-' || p[i] == '+')) { negativeExp = (p[i] == '-'); i++; }
+		int exponent = 0;
+		for (; i < n && p[i] >= '0' && p[i] <= '9'; i++) {
+			if (exponent < 10000) { exponent = exponent * 10 + (p[i] - '0'); }
+		}
+		scale += negativeExp ? -exponent : exponent;
+	}
+	double result = composeDecimal(mantissa, scale);
+	value = negative ? -result : result;
+	return true;
+}
+
+// Parses an integer field such as a PRN, an epoch component or a flag
+bool parseIntField(const char* p, size_t n, int& value) {
+	size_t i = 0;
+	while (i < n && p[i] == ' ') { i++; }
+	if (i == n) { return false; }
+	bool negative = false;
+	if (p[i] == '-' || p[i] == '+') { negative = (p[i] == '-'); i++; }
+	if (i == n || p[i] < '0' || p[i] > '9') {
+		RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+		return false;
+	}
+	int result = 0;
+	for (; i < n && p[i] >= '0' && p[i] <= '9'; i++) {
+		result = result * 10 + (p[i] - '0');
+	}
+	value = negative ? -result : result;
+	return true;
+}
+
+// Floating point field at a fixed column of a line
+double floatField(string_view line, size_t col, size_t width, double missing) {
+	if (col >= line.size()) {
+		RINEX_COUNT(COUNT_BLANK_FIELDS, 1);
+		return missing;
+	}
+	double value = missing;
+	parseFloatField(line.data() + col, min(width, line.size() - col), value);
+	return value;
+}
+
+// Integer field at a fixed column of a line
+int intField(string_view line, size_t col, size_t width, int missing) {
+	if (col >= line.size()) { return missing; }
+	int value = missing;
+	parseIntField(line.data() + col, min(width, line.size() - col), value);
+	return value;
+}
+
+// Checks whether a fixed column field holds nothing but blanks
+bool isBlankField(string_view line, size_t col, size_t width) {
+	if (col >= line.size()) { return true; }
+	string_view field = line.substr(col, width);
+	return field.find_first_not_of(' ') == string_view::npos;
+}
+
+// Text field at a fixed column of a line, without its leading and trailing blanks
+string_view textField(string_view line, size_t col, size_t width) {
+	if (col >= line.size()) { return string_view(); }
+	string_view field = line.substr(col, width);
+	size_t first = field.find_first_not_of(" \r");
+	if (first == string_view::npos) { return string_view(); }
+	return field.substr(first, field.find_last_not_of(" \r") - first + 1);
+}
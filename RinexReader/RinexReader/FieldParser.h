@@ -0,0 +1,27 @@
+#pragma once
+/*
+* FieldParser.h
+* Locale-free fixed-column numeric field parsing for Rinex records
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+
+#ifndef FIELDPARSER_H_
+#define FIELDPARSER_H_
+
+// Functions
+// Raw parsers, return false for a blank or malformed field and leave value untouched
+// With instrumentation on, blank floating point fields and malformed fields are counted
+// Floating point fields accept F (F14.3) and exponent formats, including Fortran 'D' (D19.12)
+bool parseFloatField(const char* p, size_t n, double& value);
+bool parseIntField(const char* p, size_t n, int& value);
+// Column helpers, fields past the end of a trimmed line are treated as blank (missing)
+double floatField(std::string_view line, size_t col, size_t width, double missing = 0.0);
+int intField(std::string_view line, size_t col, size_t width, int missing = 0);
+bool isBlankField(std::string_view line, size_t col, size_t width);
+// Trimmed of blanks, a view into line
+std::string_view textField(std::string_view line, size_t col, size_t width);
+
+#endif /* FIELDPARSER_H_ */
@@ -30,6 +30,12 @@ void FileIO::fileSafeIn(string filename, ifstream& fin) {
 	}
 }
 
+// File Opener for input that may be compressed (.gz, .Z, Compact Rinex)
+void FileIO::fileSafeIn(string filename, InputStream& fin) {
+	// Errors are reported while opening
+	fin.open(filename);
+}
+
 // A function to generate a LOG File for errors in Observation File
 void FileIO::logger(string output_filename, string input_filename, ofstream& fout) {
 	// Creating NEW LOG file
@@ -58,7 +64,7 @@ void FileIO::fileSafeOut(string output_filename, ofstream& fout) {
 }
 
 // Check Rinex File Version
-void FileIO::checkRinexVersionType(int &rinex_version, int &rinex_type, std::ifstream &fin)
+void FileIO::checkRinexVersionType(int &rinex_version, int &rinex_type, std::istream &fin)
 {
 	const std::string sTokenVER = "RINEX VERSION / TYPE";
 	std::string line; int nLines = 0;
@@ -72,7 +78,10 @@ void FileIO::checkRinexVersionType(int &rinex_version, int &rinex_type, std::ifs
 			std::istringstream iss(line);
 			std::vector<std::string> words{ std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>{} };
 			// Rinex Version
-			if ((std::stod(words[0])) >= 3) {
+			if ((std::stod(words[0])) >= 4) {
+				rinex_version = 4;
+			}
+			else if ((std::stod(words[0])) >= 3) {
 				rinex_version = 3;
 			}
 			else if ((std::stod(words[0])) >= 2) {
@@ -8,6 +8,7 @@
 */
 
 #include "pch.h"
+#include "InputStream.h"
 
 #ifndef FILEIO_H_
 #define FILEIO_H_
@@ -17,8 +18,9 @@ class FileIO
 public:
 	// Function Declarations
 	void fileSafeIn(std::string filename, std::ifstream& fin);
+	void fileSafeIn(std::string filename, InputStream& fin); // plain or compressed Rinex
 	void fileSafeOut(std::string filename, std::ofstream& fout);
-	void checkRinexVersionType(int &version, int &type, std::ifstream &fin);
+	void checkRinexVersionType(int &version, int &type, std::istream &fin);
 	void logger(std::string output_filename, std::string input_filename, std::ofstream& fout);
 
 };
@@ -0,0 +1,116 @@
+/*
+* GlonassOrbit.cpp
+* GLONASS satellite position, velocity and clock by Runge-Kutta integration of the broadcast state vectors
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "GlonassOrbit.h"
+#include <limits>
+
+using namespace std;
+
+// PZ-90 constants: gravitational constant (m^3/s^2), equatorial radius (m), second zonal harmonic, earth rotation (rad/s)
+static const double GM_GLO = 398600.4418e9;
+static const double AE_GLO = 6378136.0;
+static const double J2_GLO = 1082625.75e-9;
+static const double OMEGA_GLO = 7.292115e-5;
+
+// Derivative of the state (x, y, z, vx, vy, vz) in the rotating frame
+// acc is the luni-solar acceleration of the record, taken as constant over its validity
+static void glonassDerivative(const double* s, const double* acc, double* d) {
+	double r2 = s[0] * s[0] + s[1] * s[1] + s[2] * s[2];
+	double r = sqrt(r2);
+	double r3 = r2 * r;
+	double a = 1.5 * J2_GLO * GM_GLO * AE_GLO * AE_GLO / (r3 * r2);
+	double b = 5.0 * s[2] * s[2] / r2;
+	double c = -GM_GLO / r3 - a * (1.0 - b);
+	d[0] = s[3];
+	d[1] = s[4];
+	d[2] = s[5];
+	d[3] = (c + OMEGA_GLO * OMEGA_GLO) * s[0] + 2.0 * OMEGA_GLO * s[4] + acc[0];
+	d[4] = (c + OMEGA_GLO * OMEGA_GLO) * s[1] - 2.0 * OMEGA_GLO * s[3] + acc[1];
+	d[5] = (c - 2.0 * a) * s[2] + acc[2];
+}
+
+// One fourth order Runge-Kutta step of h seconds
+static void glonassStep(double* s, const double* acc, double h) {
+	double k1[6], k2[6], k3[6], k4[6], w[6];
+	glonassDerivative(s, acc, k1);
+	for (int i = 0; i < 6; i++) { w[i] = s[i] + 0.5 * h * k1[i]; }
+	glonassDerivative(w, acc, k2);
+	for (int i = 0; i < 6; i++) { w[i] = s[i] + 0.5 * h * k2[i]; }
+	glonassDerivative(w, acc, k3);
+	for (int i = 0; i < 6; i++) { w[i] = s[i] + h * k3[i]; }
+	glonassDerivative(w, acc, k4);
+	for (int i = 0; i < 6; i++) { s[i] += h / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]); }
+}
+
+// CONSTRUCTOR
+GlonassPropagator::GlonassPropagator(const std::map<int, std::vector<Rinex3Nav::DataGLO>>& nav, double step)
+	: _index(nav), _step(step > 0 ? step : 60.0) {
+	int maxPRN = nav.empty() ? -1 : nav.rbegin()->first;
+	_cache.resize(maxPRN < 0 ? 0 : maxPRN + 1);
+}
+
+void GlonassPropagator::reset() {
+	for (SatCache& sat : _cache) { sat.eph = nullptr; }
+	_index.resetCursors();
+}
+
+// State of one satellite, integrated from the closest grid state on the way from the record's reference time
+bool GlonassPropagator::propagate(int prn, GpsTime t, double* pos, double* vel, double& clockBias, double& clockDrift) {
+	const Rinex3Nav::DataGLO* eph = _index.next(prn, t);
+	if (eph == nullptr || prn < 0 || prn >= static_cast<int>(_cache.size())) { return false; }
+	SatCache& sat = _cache[prn];
+	double dt = t - eph->gpsTime;
+	double h = (dt < 0) ? -_step : _step;
+	// Start again from the record when it changed, or when the time went back past the cached grid state
+	if (sat.eph != eph || sat.offset * h < 0 || fabs(sat.offset) > fabs(dt)) {
+		sat.eph = eph;
+		sat.offset = 0;
+		const double ref[6] = { eph->satPosX, eph->satPosY, eph->satPosZ, eph->satVelX, eph->satVelY, eph->satVelZ };
+		// Records are in km, km/s
+		for (int i = 0; i < 6; i++) { sat.state[i] = ref[i] * 1000.0; }
+	}
+	const double acc[3] = { eph->satAccX * 1000.0, eph->satAccY * 1000.0, eph->satAccZ * 1000.0 };
+	// Whole steps are kept, the remainder is a partial step on a copy
+	while (fabs(dt - sat.offset) >= _step) {
+		glonassStep(sat.state, acc, h);
+		sat.offset += h;
+	}
+	double s[6];
+	for (int i = 0; i < 6; i++) { s[i] = sat.state[i]; }
+	if (dt != sat.offset) { glonassStep(s, acc, dt - sat.offset); }
+	for (int i = 0; i < 3; i++) {
+		pos[i] = s[i];
+		vel[i] = s[i + 3];
+	}
+	clockBias = eph->clockBias + eph->relFreqBias * dt;
+	clockDrift = eph->relFreqBias;
+	return true;
+}
+
+size_t GlonassPropagator::compute(const int* prn, const GpsTime* t, size_t n, OrbitStates& out) {
+	out.resize(n);
+	size_t found = 0;
+	for (size_t i = 0; i < n; i++) {
+		double pos[3], vel[3], clockBias, clockDrift;
+		if (propagate(prn[i], t[i], pos, vel, clockBias, clockDrift)) { found++; }
+		else {
+			double nan = numeric_limits<double>::quiet_NaN();
+			pos[0] = pos[1] = pos[2] = vel[0] = vel[1] = vel[2] = clockBias = clockDrift = nan;
+		}
+		out.x[i] = pos[0]; out.y[i] = pos[1]; out.z[i] = pos[2];
+		out.vx[i] = vel[0]; out.vy[i] = vel[1]; out.vz[i] = vel[2];
+		out.clockBias[i] = clockBias;
+		out.clockDrift[i] = clockDrift;
+	}
+	return found;
+}
+
+size_t GlonassPropagator::compute(int prn, const GpsTime* t, size_t n, OrbitStates& out) {
+	vector<int> prns(n, prn);
+	return compute(prns.data(), t, n, out);
+}
@@ -0,0 +1,54 @@
+#pragma once
+/*
+* GlonassOrbit.h
+* GLONASS satellite position, velocity and clock by Runge-Kutta integration of the broadcast state vectors
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex3Nav.h"
+#include "EphemerisIndex.h"
+#include "KeplerBatch.h"
+
+#ifndef GLONASSORBIT_H_
+#define GLONASSORBIT_H_
+
+// Propagates the PZ-90 state vectors of GLONASS navigation records (GLONASS ICD 2008, A.3.1.2)
+// Integration runs on a grid of fixed steps from the reference time of each record, the last grid state
+// of every satellite is kept, so times that keep advancing only cost the steps in between
+// Results do not depend on the order of requests, a state is the same whether reached step by step or at once
+class GlonassPropagator
+{
+public:
+	// CONSTRUCTOR
+	// The navigation data is referenced and not copied, step is the integration step in seconds
+	explicit GlonassPropagator(const std::map<int, std::vector<Rinex3Nav::DataGLO>>& nav, double step = 60.0);
+
+	// Functions
+	// States of satellites prn[i] at times t[i], eg: one satellite over many epochs or all satellites of an epoch
+	// Position and velocity in ECEF (PZ-90) metres and metres per second, clock in seconds (-TauN + GammaN (t - tb))
+	// Returns how many were found, those without a valid record are NaN
+	size_t compute(const int* prn, const GpsTime* t, size_t n, OrbitStates& out);
+	// One satellite at many times
+	size_t compute(int prn, const GpsTime* t, size_t n, OrbitStates& out);
+	// Drops the cached grid states, for eg: after going back to the start of a file
+	void reset();
+
+private:
+	// Last grid state of a satellite and the record it was integrated from
+	struct SatCache {
+		const Rinex3Nav::DataGLO* eph = nullptr;
+		double offset = 0;
+		double state[6];
+	};
+
+	bool propagate(int prn, GpsTime t, double* pos, double* vel, double& clockBias, double& clockDrift);
+
+	// Attributes
+	EphemerisIndex<Rinex3Nav::DataGLO> _index;
+	std::vector<SatCache> _cache;
+	double _step;
+};
+
+#endif /* GLONASSORBIT_H_ */
@@ -0,0 +1,30 @@
+/*
+* GnssSystem.cpp
+* Satellite system identifiers and packed satellite indices
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "GnssSystem.h"
+
+// Rinex system letter to system index
+int systemIndex(char sys) {
+	switch (sys) {
+	case 'G': return SYS_GPS;
+	case ' ': return SYS_GPS; // Rinex 2 allows a blank identifier for GPS
+	case 'R': return SYS_GLO;
+	case 'E': return SYS_GAL;
+	case 'C': return SYS_BDS;
+	case 'J': return SYS_QZS;
+	case 'S': return SYS_SBS;
+	case 'I': return SYS_IRN;
+	default: return -1;
+	}
+}
+
+// System index to Rinex system letter
+char systemChar(int sys) {
+	static const char letters[SYS_COUNT] = { 'G', 'R', 'E', 'C', 'J', 'S', 'I' };
+	return (sys >= 0 && sys < SYS_COUNT) ? letters[sys] : '?';
+}
@@ -0,0 +1,36 @@
+#pragma once
+/*
+* GnssSystem.h
+* Satellite system identifiers and packed satellite indices
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+
+#ifndef GNSSSYSTEM_H_
+#define GNSSSYSTEM_H_
+
+// Satellite systems, also used to index per-system storage
+enum GnssSystem {
+	SYS_GPS = 0,
+	SYS_GLO,
+	SYS_GAL,
+	SYS_BDS,
+	SYS_QZS,
+	SYS_SBS,
+	SYS_IRN,
+	SYS_COUNT
+};
+
+// Functions
+// Rinex system letter (G, R, E, C, J, S, I) to system index, -1 if unknown
+int systemIndex(char sys);
+char systemChar(int sys);
+
+// A satellite packed into one small integer: system in the high byte, PRN in the low byte
+inline unsigned short packSat(int sys, int prn) { return static_cast<unsigned short>((sys << 8) | (prn & 0xFF)); }
+inline int satSystem(unsigned short sat) { return sat >> 8; }
+inline int satPRN(unsigned short sat) { return sat & 0xFF; }
+
+#endif /* GNSSSYSTEM_H_ */
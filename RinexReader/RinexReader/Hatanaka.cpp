@@ -0,0 +1,324 @@
+/*
+* Hatanaka.cpp
+* On the fly expansion of Compact Rinex (Hatanaka, CRINEX 1.0 and 3.0) observation files
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Hatanaka.h"
+#include "FieldParser.h"
+
+using namespace std;
+
+// CONSTRUCTOR
+HatanakaSource::HatanakaSource(ByteSource& in) : _in(in), _buf(1 << 16), _pos(0), _end(0), _eof(false),
+	_mode(DETECT), _version(0), _nTypesAll(0), _epochValid(false), _outPos(0) {}
+
+// Applies a line coded as changes to the previous one
+// A blank keeps the old character, '&' stands for a blank, anything else replaces it
+static void repair(string& old, string_view diff) {
+	if (old.size() < diff.size()) { old.resize(diff.size(), ' '); }
+	for (size_t i = 0; i < diff.size(); i++) {
+		if (diff[i] == ' ') { continue; }
+		old[i] = (diff[i] == '&') ? ' ' : diff[i];
+	}
+}
+
+// Strips trailing blanks of the line being built and terminates it
+static void endLine(string& out, size_t lineStart) {
+	size_t last = out.find_last_not_of(' ');
+	out.resize((last == string::npos || last < lineStart) ? lineStart : last + 1);
+	out += '\n';
+}
+
+// Signed integer field, false when there are no digits
+static bool parseInteger(string_view field, int64_t& value) {
+	size_t i = 0;
+	bool negative = false;
+	if (i < field.size() && (field[i] == '-' || field[i] == '+')) { negative = field[i] == '-'; i++; }
+	if (i == field.size()) { return false; }
+	int64_t v = 0;
+	for (; i < field.size(); i++) {
+		if (field[i] < '0' || field[i] > '9') { return false; }
+		v = v * 10 + (field[i] - '0');
+	}
+	value = negative ? -v : v;
+	return true;
+}
+
+// Next line of the compact file, without the line ending
+bool HatanakaSource::nextLine(string& line) {
+	line.clear();
+	while (true) {
+		if (_pos == _end) {
+			if (!_eof) {
+				_pos = 0;
+				_end = _in.read(_buf.data(), _buf.size());
+				_eof = _end == 0;
+			}
+			if (_eof) { return !line.empty(); }
+		}
+		const char* start = _buf.data() + _pos;
+		const char* nl = static_cast<const char*>(memchr(start, '\n', _end - _pos));
+		if (nl != nullptr) {
+			line.append(start, nl - start);
+			_pos += (nl - start) + 1;
+			if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+			return true;
+		}
+		line.append(start, _end - _pos);
+		_pos = _end;
+	}
+}
+
+// Looks at the first line, Compact Rinex files start with "CRINEX VERS   / TYPE"
+bool HatanakaSource::detect() {
+	_end = _in.read(_buf.data(), _buf.size());
+	_eof = _end == 0;
+	if (_eof) { return false; }
+	string_view head(_buf.data(), _end);
+	head = head.substr(0, head.find('\n'));
+	if (head.find("CRINEX VERS") == string_view::npos) {
+		_mode = PASS;
+		return true;
+	}
+	_version = (head[0] == '3') ? 3 : 1;
+	// Version and program lines belong to the compact format only
+	nextLine(_line);
+	nextLine(_line);
+	_mode = HEADER;
+	return true;
+}
+
+// Header lines are copied, noting the number of observation types of each system
+bool HatanakaSource::header() {
+	if (!nextLine(_line)) { return false; }
+	_out += _line;
+	_out += '\n';
+	string_view label = (_line.size() > 60) ? string_view(_line).substr(60) : string_view();
+	if (label.find("# / TYPES OF OBSERV") != string_view::npos && !isBlankField(_line, 0, 6)) {
+		_nTypesAll = intField(_line, 0, 6);
+	}
+	else if (label.find("SYS / # / OBS TYPES") != string_view::npos && _line[0] != ' ') {
+		_nTypes[_line[0]] = intField(_line, 3, 3);
+	}
+	else if (label.find("END OF HEADER") != string_view::npos) {
+		_mode = BODY;
+	}
+	return true;
+}
+
+// Number of observables of a satellite
+int HatanakaSource::nTypes(const string& sat) const {
+	if (_version == 1) { return _nTypesAll; }
+	map<char, int>::const_iterator it = _nTypes.find(sat[0]);
+	return (it != _nTypes.end()) ? it->second : 0;
+}
+
+// One compact field, either "n&value" starting an arc of order n differences or the next difference
+bool HatanakaSource::recover(const string& field, Arc& arc) {
+	size_t amp = field.find('&');
+	if (amp != string::npos) {
+		int64_t order;
+		if (!parseInteger(string_view(field).substr(0, amp), order) || order < 0 || order > MAX_ORDER) { return false; }
+		if (!parseInteger(string_view(field).substr(amp + 1), arc.diff[0])) { return false; }
+		arc.arcOrder = static_cast<int>(order);
+		arc.order = 0;
+		arc.valid = true;
+		return true;
+	}
+	int64_t d;
+	if (!arc.valid || !parseInteger(field, d)) { return false; }
+	// The order grows by one each epoch until the arc order is reached
+	if (arc.order < arc.arcOrder) { arc.order++; }
+	arc.diff[arc.order] = d;
+	for (int i = arc.order - 1; i >= 0; i--) { arc.diff[i] += arc.diff[i + 1]; }
+	return true;
+}
+
+// Writes the value of an arc as a fixed point number, the compact file holds it as an integer
+void HatanakaSource::appendValue(const Arc& arc, int decimals, int width) {
+	if (!arc.valid) {
+		_out.append(width, ' ');
+		return;
+	}
+	int64_t scale = 1;
+	for (int i = 0; i < decimals; i++) { scale *= 10; }
+	int64_t v = arc.diff[0];
+	uint64_t a = (v < 0) ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+	// Like the Fortran format of the original file, no zero before the point (eg: -.158)
+	char text[48];
+	int len = (a < static_cast<uint64_t>(scale))
+		? snprintf(text, sizeof(text), "%s.%0*llu", (v < 0) ? "-" : "", decimals, static_cast<unsigned long long>(a))
+		: snprintf(text, sizeof(text), "%s%llu.%0*llu", (v < 0) ? "-" : "",
+			static_cast<unsigned long long>(a / scale), decimals, static_cast<unsigned long long>(a % scale));
+	if (len < width) { _out.append(width - len, ' '); }
+	_out.append(text, len);
+}
+
+// Data fields of one satellite, separated by single blanks, followed by the flags
+// An empty field is a missing observable, trailing ones may be left out altogether
+bool HatanakaSource::observables(const string& line, SatState& sat, int nTypes) {
+	sat.arcs.resize(nTypes);
+	size_t p = 0;
+	string field;
+	for (int k = 0; k < nTypes; k++) {
+		if (p >= line.size()) {
+			sat.arcs[k].valid = false;
+			p = line.size() + 1;
+			continue;
+		}
+		size_t q = line.find(' ', p);
+		if (q == string::npos) { q = line.size(); }
+		field.assign(line, p, q - p);
+		p = q + 1;
+		if (field.empty()) { sat.arcs[k].valid = false; }
+		else if (!recover(field, sat.arcs[k])) { return false; }
+	}
+	sat.flags.resize(2 * nTypes, ' ');
+	if (p < line.size()) { repair(sat.flags, string_view(line).substr(p, 2 * nTypes)); }
+	return true;
+}
+
+// Expands one epoch: the epoch line, the clock offset line and a line per satellite
+bool HatanakaSource::epoch() {
+	if (!nextLine(_line)) { return false; }
+	if (_line.empty()) { return true; }
+	// A line starting with the identifier is complete, any other one holds the changes
+	bool complete = _line[0] == ((_version == 1) ? '&' : '>');
+	string ep;
+	if (complete) {
+		ep = _line;
+		if (_version == 1) { ep[0] = ' '; }
+	}
+	else {
+		if (!_epochValid) { _failed = true; return false; }
+		ep = _epochLine;
+		repair(ep, _line);
+	}
+	size_t flagCol = (_version == 1) ? 28 : 31;
+	int flag = intField(ep, flagCol, 1);
+	int nSats = intField(ep, flagCol + 1, 3);
+	// Event records are not compressed, they are copied and leave the reference epoch alone
+	if (flag > 1) {
+		size_t start = _out.size();
+		_out += ep;
+		endLine(_out, start);
+		for (int i = 0; i < nSats && nextLine(_line); i++) {
+			_out += _line;
+			_out += '\n';
+		}
+		return true;
+	}
+	_epochLine = ep;
+	_epochValid = true;
+
+	// Receiver clock offset, a blank line when there is none
+	if (!nextLine(_line)) { _failed = true; return false; }
+	if (_line.empty() || _line.find_first_not_of(' ') == string::npos) { _clock.valid = false; }
+	else if (!recover(_line, _clock)) { _failed = true; return false; }
+
+	// Satellite list follows the epoch fields on the one line
+	size_t satCol = (_version == 1) ? 32 : 41;
+	string sats = (ep.size() > satCol) ? ep.substr(satCol, 3 * nSats) : string();
+	sats.resize(3 * nSats, ' ');
+	size_t start = _out.size();
+	if (_version == 1) {
+		// Rinex 2 lists 12 satellites per line, the clock offset ends the first one
+		_out.append(ep, 0, 32);
+		_out.resize(start + 32, ' ');
+		_out.append(sats, 0, 36);
+		if (_clock.valid) {
+			_out.resize(start + 68, ' ');
+			appendValue(_clock, 9, 12);
+		}
+		endLine(_out, start);
+		for (int i = 12; i < nSats; i += 12) {
+			start = _out.size();
+			_out.append(32, ' ');
+			_out.append(sats, 3 * i, 36);
+			endLine(_out, start);
+		}
+	}
+	else {
+		_out.append(ep, 0, 35);
+		_out.resize(start + 35, ' ');
+		if (_clock.valid) {
+			_out.resize(start + 41, ' ');
+			appendValue(_clock, 12, 15);
+		}
+		endLine(_out, start);
+	}
+
+	// Observations, satellites missing from the previous epoch start over
+	for (int i = 0; i < nSats; i++) {
+		string id = sats.substr(3 * i, 3);
+		if (!nextLine(_line)) { _failed = true; return false; }
+		SatState& sat = _nextSats[id];
+		map<string, SatState>::iterator prev = _sats.find(id);
+		if (prev != _sats.end()) { sat = std::move(prev->second); }
+		int n = nTypes(id);
+		if (!observables(_line, sat, n)) { _failed = true; return false; }
+		start = _out.size();
+		if (_version != 1) { _out += id; }
+		for (int k = 0; k < n; k++) {
+			// Rinex 2 records wrap after 5 observables
+			if (_version == 1 && k > 0 && k % 5 == 0) {
+				endLine(_out, start);
+				start = _out.size();
+			}
+			appendValue(sat.arcs[k], 3, 14);
+			_out += sat.flags[2 * k];
+			_out += sat.flags[2 * k + 1];
+		}
+		endLine(_out, start);
+	}
+	_sats.swap(_nextSats);
+	_nextSats.clear();
+	return true;
+}
+
+// Hands out the expanded text, decoding an epoch whenever the previous one has been read
+size_t HatanakaSource::read(char* out, size_t n) {
+	size_t produced = 0;
+	while (produced < n && _mode != DONE) {
+		if (_outPos < _out.size()) {
+			size_t k = min(n - produced, _out.size() - _outPos);
+			memcpy(out + produced, _out.data() + _outPos, k);
+			_outPos += k;
+			produced += k;
+			continue;
+		}
+		_out.clear();
+		_outPos = 0;
+		switch (_mode) {
+		case DETECT:
+			if (!detect()) { _mode = DONE; }
+			break;
+		case PASS:
+			// Bytes read while detecting go first, the rest comes straight from the source
+			if (_pos < _end) {
+				size_t k = min(n - produced, _end - _pos);
+				memcpy(out + produced, _buf.data() + _pos, k);
+				_pos += k;
+				produced += k;
+			}
+			else {
+				size_t k = _in.read(out + produced, n - produced);
+				if (k == 0) { _mode = DONE; }
+				produced += k;
+			}
+			break;
+		case HEADER:
+			if (!header()) { _mode = DONE; }
+			break;
+		case BODY:
+			if (!epoch()) { _mode = DONE; }
+			break;
+		default:
+			break;
+		}
+	}
+	return produced;
+}
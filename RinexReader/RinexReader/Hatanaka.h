@@ -0,0 +1,79 @@
+#pragma once
+/*
+* Hatanaka.h
+* On the fly expansion of Compact Rinex (Hatanaka, CRINEX 1.0 and 3.0) observation files
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Decompress.h"
+#include <cstdint>
+
+#ifndef HATANAKA_H_
+#define HATANAKA_H_
+
+// Turns Compact Rinex text back into Rinex observation text, one epoch at a time
+// Input that does not start with a CRINEX header is passed through unchanged,
+// so the source can sit on top of any observation or navigation file
+class HatanakaSource : public ByteSource
+{
+public:
+	// CONSTRUCTOR
+	explicit HatanakaSource(ByteSource& in);
+
+	size_t read(char* out, size_t n) override;
+	// Known once the first line has been read
+	bool isCompact() const { return _version != 0; }
+
+	// Highest order of the differences
+	static const int MAX_ORDER = 9;
+
+private:
+	// Differences of one observable down to the value itself, kept from the previous epoch
+	struct Arc {
+		int64_t diff[MAX_ORDER + 1];
+		int order;
+		int arcOrder;
+		bool valid;
+		Arc() : order(0), arcOrder(0), valid(false) {}
+	};
+	struct SatState {
+		std::vector<Arc> arcs;
+		// LLI and signal strength flags, two characters per observable
+		std::string flags;
+	};
+	enum Mode { DETECT, PASS, HEADER, BODY, DONE };
+
+	bool nextLine(std::string& line);
+	bool detect();
+	bool header();
+	bool epoch();
+	bool observables(const std::string& line, SatState& sat, int nTypes);
+	bool recover(const std::string& field, Arc& arc);
+	void appendValue(const Arc& arc, int decimals, int width);
+	int nTypes(const std::string& sat) const;
+
+	ByteSource& _in;
+	std::vector<char> _buf;
+	size_t _pos, _end;
+	bool _eof;
+	Mode _mode;
+	// 1 for CRINEX 1.0 (Rinex 2), 3 for CRINEX 3.0 (Rinex 3)
+	int _version;
+	// Observation types per system letter, Rinex 2 files use one count for all
+	std::map<char, int> _nTypes;
+	int _nTypesAll;
+	// Epoch line of the previous epoch, the next one is coded as changes to it
+	std::string _epochLine;
+	bool _epochValid;
+	Arc _clock;
+	std::map<std::string, SatState> _sats;
+	std::map<std::string, SatState> _nextSats;
+	// Decoded text waiting to be read
+	std::string _out;
+	size_t _outPos;
+	std::string _line;
+};
+
+#endif /* HATANAKA_H_ */
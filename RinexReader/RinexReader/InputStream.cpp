@@ -0,0 +1,94 @@
+/*
+* InputStream.cpp
+* Input file stream that undoes gzip, Unix compress and Hatanaka compression while reading
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "InputStream.h"
+
+using namespace std;
+
+// ********************************************************************************
+// Source Buffer
+
+// CONSTRUCTOR
+SourceBuf::SourceBuf(ByteSource& source) : _source(source), _buf(KEEP + BLOCK), _offset(0) {
+	setg(_buf.data(), _buf.data(), _buf.data());
+}
+
+// Refills the buffer with the next block, keeping the tail of the previous one for seeking back
+SourceBuf::int_type SourceBuf::underflow() {
+	if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+	size_t have = egptr() - eback();
+	size_t keep = min(have, KEEP);
+	if (keep > 0) { memmove(_buf.data(), egptr() - keep, keep); }
+	_offset += have - keep;
+	size_t n = _source.read(_buf.data() + keep, BLOCK);
+	setg(_buf.data(), _buf.data() + keep, _buf.data() + keep + n);
+	if (n == 0) { return traits_type::eof(); }
+	return traits_type::to_int_type(*gptr());
+}
+
+// Only positions still held in the buffer can be reached
+SourceBuf::pos_type SourceBuf::seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which) {
+	if (!(which & ios_base::in)) { return pos_type(off_type(-1)); }
+	if (dir == ios_base::cur) { return seekpos(pos_type(_offset + (gptr() - eback()) + off), which); }
+	if (dir == ios_base::beg) { return seekpos(pos_type(off), which); }
+	return pos_type(off_type(-1));
+}
+
+SourceBuf::pos_type SourceBuf::seekpos(pos_type pos, ios_base::openmode which) {
+	streamoff p = static_cast<streamoff>(pos);
+	if (!(which & ios_base::in) || p < _offset || p > _offset + (egptr() - eback())) { return pos_type(off_type(-1)); }
+	setg(eback(), eback() + (p - _offset), egptr());
+	return pos;
+}
+
+// ********************************************************************************
+// Input Stream
+
+// CONSTRUCTOR
+InputStream::InputStream() : std::istream(nullptr) {}
+InputStream::InputStream(const string& filename) : std::istream(nullptr) { open(filename); }
+
+// Opens the file and stacks up the decoders its content calls for
+bool InputStream::open(const string& filename) {
+	close();
+	// Magic bytes of the compression formats
+	unsigned char magic[2] = { 0, 0 };
+	{
+		ifstream probe(filename, ios::binary);
+		probe.read(reinterpret_cast<char*>(magic), 2);
+	}
+	_file.reset(new FileSource());
+	if (!_file->open(filename)) {
+		_file.reset();
+		setstate(ios_base::failbit);
+		return false;
+	}
+	ByteSource* source = _file.get();
+	if (magic[0] == 0x1f && magic[1] == 0x8b) { _decompress.reset(new GzipSource(*source)); }
+	else if (magic[0] == 0x1f && magic[1] == 0x9d) { _decompress.reset(new LzwSource(*source)); }
+	if (_decompress) { source = _decompress.get(); }
+	// Passes plain Rinex through untouched
+	_hatanaka.reset(new HatanakaSource(*source));
+	_buf.reset(new SourceBuf(*_hatanaka));
+	rdbuf(_buf.get());
+	clear();
+	return true;
+}
+
+// Releases the file and the decoders
+void InputStream::close() {
+	rdbuf(nullptr);
+	_buf.reset();
+	_hatanaka.reset();
+	_decompress.reset();
+	_file.reset();
+}
+
+bool InputStream::corrupt() const {
+	return (_decompress && _decompress->failed()) || (_hatanaka && _hatanaka->failed());
+}
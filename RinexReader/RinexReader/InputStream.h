@@ -0,0 +1,66 @@
+#pragma once
+/*
+* InputStream.h
+* Input file stream that undoes gzip, Unix compress and Hatanaka compression while reading
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Decompress.h"
+#include "Hatanaka.h"
+#include <memory>
+
+#ifndef INPUTSTREAM_H_
+#define INPUTSTREAM_H_
+
+// Stream buffer over a byte source
+// The last KEEP bytes stay in the buffer, so tellg/seekg back to the start of a recent line
+// work as on a file, which is how the readers step back over the next epoch line
+class SourceBuf : public std::streambuf
+{
+public:
+	static constexpr size_t KEEP = 1 << 16;
+	static constexpr size_t BLOCK = 1 << 16;
+
+	// CONSTRUCTOR
+	explicit SourceBuf(ByteSource& source);
+
+protected:
+	int_type underflow() override;
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+	ByteSource& _source;
+	std::vector<char> _buf;
+	// Stream position of the first byte in the buffer
+	std::streamoff _offset;
+};
+
+// Drop-in replacement for std::ifstream when reading Rinex files
+// The compression is recognized from the content, not the file name:
+// gzip (.gz) and compress (.Z) by their magic bytes, Compact Rinex (.crx/.yyd) by its first line
+// Data is decompressed in blocks as it is read, nothing is written to disk
+class InputStream : public std::istream
+{
+public:
+	// CONSTRUCTOR
+	InputStream();
+	explicit InputStream(const std::string& filename);
+
+	// Functions
+	bool open(const std::string& filename);
+	void close();
+	bool is_open() const { return _buf != nullptr; }
+	// Set when the decompressed data turned out to be corrupt or truncated
+	bool corrupt() const;
+
+private:
+	std::unique_ptr<FileSource> _file;
+	std::unique_ptr<ByteSource> _decompress;
+	std::unique_ptr<HatanakaSource> _hatanaka;
+	std::unique_ptr<SourceBuf> _buf;
+};
+
+#endif /* INPUTSTREAM_H_ */
@@ -0,0 +1,96 @@
+/*
+* Instrumentation.cpp
+* Optional counters and stage timers for the read paths, compiled out unless RINEX_INSTRUMENT is defined
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Instrumentation.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+static const char* const COUNTER_NAMES[COUNT_N] = {
+	"bytes", "lines", "epochs", "satellites", "navRecords", "parseFailures", "blankFields" };
+static const char* const TIMER_NAMES[TIME_N] = { "io", "tokenize", "convert", "organize" };
+
+#if RINEX_INSTRUMENT
+
+// Blocks of all threads that ever counted, kept after their thread ends so totals stay complete
+static mutex& registryMutex() {
+	static mutex m;
+	return m;
+}
+static vector<unique_ptr<InstrumentBlock>>& registry() {
+	static vector<unique_ptr<InstrumentBlock>> blocks;
+	return blocks;
+}
+
+static InstrumentBlock* registerBlock() {
+	unique_ptr<InstrumentBlock> block(new InstrumentBlock());
+	for (int i = 0; i < COUNT_N; i++) { block->counters[i].store(0); }
+	for (int i = 0; i < TIME_N; i++) { block->nanoseconds[i].store(0); }
+	block->current = -1;
+	block->since = 0;
+	lock_guard<mutex> lock(registryMutex());
+	registry().push_back(std::move(block));
+	return registry().back().get();
+}
+
+InstrumentBlock& instrumentBlock() {
+	thread_local InstrumentBlock* block = registerBlock();
+	return *block;
+}
+
+int64_t instrumentClock() {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Sums the blocks of all threads
+InstrumentSnapshot instrumentSnapshot() {
+	InstrumentSnapshot snapshot = {};
+	lock_guard<mutex> lock(registryMutex());
+	for (const unique_ptr<InstrumentBlock>& block : registry()) {
+		for (int i = 0; i < COUNT_N; i++) { snapshot.counters[i] += block->counters[i].load(memory_order_relaxed); }
+		for (int i = 0; i < TIME_N; i++) { snapshot.nanoseconds[i] += block->nanoseconds[i].load(memory_order_relaxed); }
+	}
+	return snapshot;
+}
+
+// Counts that other threads add while resetting may be lost
+void instrumentReset() {
+	lock_guard<mutex> lock(registryMutex());
+	for (const unique_ptr<InstrumentBlock>& block : registry()) {
+		for (int i = 0; i < COUNT_N; i++) { block->counters[i].store(0, memory_order_relaxed); }
+		for (int i = 0; i < TIME_N; i++) { block->nanoseconds[i].store(0, memory_order_relaxed); }
+	}
+}
+
+#else
+
+InstrumentSnapshot instrumentSnapshot() {
+	InstrumentSnapshot snapshot = {};
+	return snapshot;
+}
+
+void instrumentReset() {}
+
+#endif
+
+// Single line JSON document for log files and scrapers
+string InstrumentSnapshot::json() const {
+	ostringstream out;
+	out << "{\"enabled\":" << (instrumentEnabled() ? "true" : "false") << ",\"counters\":{";
+	for (int i = 0; i < COUNT_N; i++) {
+		out << (i > 0 ? "," : "") << "\"" << COUNTER_NAMES[i] << "\":" << counters[i];
+	}
+	out << "},\"seconds\":{" << fixed << setprecision(9);
+	for (int i = 0; i < TIME_N; i++) {
+		out << (i > 0 ? "," : "") << "\"" << TIMER_NAMES[i] << "\":" << nanoseconds[i] * 1e-9;
+	}
+	out << "}}";
+	return out.str();
+}
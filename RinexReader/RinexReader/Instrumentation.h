@@ -0,0 +1,125 @@
+#pragma once
+/*
+* Instrumentation.h
+* Optional counters and stage timers for the read paths, compiled out unless RINEX_INSTRUMENT is defined
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include <atomic>
+#include <cstdint>
+
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+// Build with RINEX_INSTRUMENT=1 (eg: /D RINEX_INSTRUMENT=1 or -DRINEX_INSTRUMENT=1) to switch it on
+// Switched off, the macros expand to nothing and snapshots are all zero
+#ifndef RINEX_INSTRUMENT
+#define RINEX_INSTRUMENT 0
+#endif
+
+enum InstrumentCounter {
+	COUNT_BYTES = 0,
+	COUNT_LINES,
+	COUNT_EPOCHS,
+	COUNT_SATELLITES,
+	COUNT_NAV_RECORDS,
+	COUNT_PARSE_FAILURES,
+	COUNT_BLANK_FIELDS,
+	COUNT_N
+};
+
+// Stages of a read, each moment of a read is charged to exactly one of them
+// * I/O: pulling lines from the stream
+// * Tokenize: splitting lines and records, finding identifiers (whatever is not in another stage)
+// * Convert: numeric fields, eg: the observations of a satellite
+// * Organize: storing the results, eg: navigation maps, epoch time and counts
+enum InstrumentTimer {
+	TIME_IO = 0,
+	TIME_TOKENIZE,
+	TIME_CONVERT,
+	TIME_ORGANIZE,
+	TIME_N
+};
+
+// Totals over all threads at the time of the snapshot
+struct InstrumentSnapshot {
+	uint64_t counters[COUNT_N];
+	uint64_t nanoseconds[TIME_N];
+
+	uint64_t counter(InstrumentCounter c) const { return counters[c]; }
+	double seconds(InstrumentTimer t) const { return nanoseconds[t] * 1e-9; }
+	// eg: {"enabled":true,"counters":{"bytes":2457996,...},"seconds":{"io":0.012,...}}
+	std::string json() const;
+};
+
+// Functions
+constexpr bool instrumentEnabled() { return RINEX_INSTRUMENT != 0; }
+InstrumentSnapshot instrumentSnapshot();
+void instrumentReset();
+
+#if RINEX_INSTRUMENT
+
+// Counters and timers of one thread, written by that thread only
+// Snapshots read them from other threads, hence the relaxed atomics (plain loads and stores on common hardware)
+struct InstrumentBlock {
+	std::atomic<uint64_t> counters[COUNT_N];
+	std::atomic<uint64_t> nanoseconds[TIME_N];
+	// Stage being timed and when it was entered, -1 when none
+	int current;
+	int64_t since;
+};
+
+// Block of the calling thread, registered on first use
+InstrumentBlock& instrumentBlock();
+int64_t instrumentClock();
+
+inline void instrumentAdd(std::atomic<uint64_t>& value, uint64_t n) {
+	value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void instrumentCount(InstrumentCounter c, uint64_t n) {
+	instrumentAdd(instrumentBlock().counters[c], n);
+}
+
+// Times a scope as one stage, nested scopes pause the enclosing one
+class InstrumentScope
+{
+public:
+	// CONSTRUCTOR
+	explicit InstrumentScope(InstrumentTimer stage) : _block(instrumentBlock()) {
+		int64_t now = instrumentClock();
+		if (_block.current >= 0) { instrumentAdd(_block.nanoseconds[_block.current], now - _block.since); }
+		_previous = _block.current;
+		_block.current = stage;
+		_block.since = now;
+	}
+	// DESTRUCTOR
+	~InstrumentScope() {
+		int64_t now = instrumentClock();
+		instrumentAdd(_block.nanoseconds[_block.current], now - _block.since);
+		_block.current = _previous;
+		_block.since = now;
+	}
+	InstrumentScope(const InstrumentScope&) = delete;
+	InstrumentScope& operator=(const InstrumentScope&) = delete;
+
+private:
+	InstrumentBlock& _block;
+	int _previous;
+};
+
+#define RINEX_INSTRUMENT_CONCAT2(a, b) a##b
+#define RINEX_INSTRUMENT_CONCAT(a, b) RINEX_INSTRUMENT_CONCAT2(a, b)
+#define RINEX_COUNT(counter, n) instrumentCount(counter, static_cast<uint64_t>(n))
+#define RINEX_TIME(stage) InstrumentScope RINEX_INSTRUMENT_CONCAT(instrumentScope, __LINE__)(stage)
+
+#else
+
+#define RINEX_COUNT(counter, n) ((void)0)
+#define RINEX_TIME(stage) ((void)0)
+
+#endif
+
+#endif /* INSTRUMENTATION_H_ */
@@ -0,0 +1,221 @@
+/*
+* Inventory.cpp
+* Catalog of Rinex files built from their headers only
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Inventory.h"
+#include "EpochIndex.h"
+#include "FieldParser.h"
+#include "InputStream.h"
+#include "Rinex2Obs.h"
+#include "Rinex3Obs.h"
+#include "ThreadPool.h"
+#include <filesystem>
+
+using namespace std;
+
+// Bytes read for a header, doubled while END OF HEADER is not in them, up to the limit
+static const size_t HEADER_BYTES = 1 << 14;
+static const size_t MAX_HEADER_BYTES = 1 << 20;
+// Bytes read from the end of a file to find its last epoch
+static const size_t TAIL_BYTES = 1 << 16;
+
+// Reads the start of the file up to the end of its END OF HEADER line, text is cut there
+static bool readHeaderText(istream& fin, string& text) {
+	const string sTokenEND = "END OF HEADER";
+	size_t chunk = HEADER_BYTES;
+	while (text.size() < MAX_HEADER_BYTES) {
+		size_t old = text.size();
+		text.resize(old + chunk);
+		fin.read(&text[old], static_cast<streamsize>(chunk));
+		size_t got = static_cast<size_t>(fin.gcount());
+		text.resize(old + got);
+		size_t found = text.find(sTokenEND, old < sTokenEND.size() ? 0 : old - sTokenEND.size());
+		if (found != string::npos) {
+			size_t eol = text.find('\n', found);
+			text.resize(eol == string::npos ? text.size() : eol + 1);
+			return true;
+		}
+		if (got < chunk) { return false; }
+		chunk = text.size();
+	}
+	return false;
+}
+
+// Time of the last epoch of a plain observation file, read backwards from its end
+// Compressed files cannot be read from their end, they are recognized by their first bytes
+// differing from the decompressed header
+static vector<double> lastEpochTime(const string& filename, const string& header, double version) {
+	ifstream in(filename, ios::binary);
+	if (!in.is_open()) { return vector<double>(); }
+	string start(min<size_t>(header.size(), 80), '\0');
+	in.read(&start[0], static_cast<streamsize>(start.size()));
+	if (start.compare(0, string::npos, header, 0, start.size()) != 0) { return vector<double>(); }
+	in.seekg(0, ios::end);
+	uint64_t size = static_cast<uint64_t>(in.tellg());
+	uint64_t from = max<uint64_t>(header.size(), size > TAIL_BYTES ? size - TAIL_BYTES : 0);
+	if (from >= size) { return vector<double>(); }
+	string tail(static_cast<size_t>(size - from), '\0');
+	in.clear();
+	in.seekg(static_cast<streamoff>(from));
+	in.read(&tail[0], static_cast<streamsize>(tail.size()));
+	tail.resize(static_cast<size_t>(in.gcount()));
+	// Lines from the last one back, the first line is cut unless the tail starts right after the header
+	size_t end = tail.size();
+	for (;;) {
+		size_t eol = (end == 0) ? string::npos : tail.rfind('\n', end - 1);
+		size_t begin = (eol == string::npos) ? 0 : eol + 1;
+		if (begin == 0 && from > header.size()) { break; }
+		string_view line(tail.data() + begin, end - begin);
+		if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+		double epoch[6];
+		if (epochLineTime(line, version, epoch)) { return vector<double>(epoch, epoch + 6); }
+		if (begin == 0) { break; }
+		end = begin - 1;
+	}
+	return vector<double>();
+}
+
+bool inventoryFile(const string& filename, InventoryEntry& entry, bool sampleLastEpoch) {
+	entry = InventoryEntry();
+	entry.path = filename;
+	error_code ec;
+	entry.size = filesystem::file_size(filename, ec);
+	InputStream fin(filename);
+	if (!fin.is_open()) {
+		entry.error = "Cannot open file";
+		return false;
+	}
+	string text;
+	bool complete = readHeaderText(fin, text);
+	string_view view(text);
+	string_view line = view.substr(0, view.find('\n'));
+	if (headerLabel(line) != HDR_VERSION) {
+		entry.error = fin.corrupt() ? "Corrupt file" : "RINEX VERSION / TYPE not found in first line";
+		return false;
+	}
+	if (line.size() > 20) { entry.fileType = line[20]; }
+	// Observation headers go through their readers for the observation types
+	double version = floatField(line, 0, 9);
+	if (entry.fileType == 'O' && version >= 3) {
+		Rinex3Obs OBS;
+		OBS.obsHeader(view);
+		entry.header = OBS._Header;
+		entry.obsTypes = OBS._Header.obsTypes;
+	}
+	else if (entry.fileType == 'O' && version >= 2) {
+		Rinex2Obs OBS;
+		OBS.obsHeader(view);
+		entry.header = OBS._header;
+		entry.obsTypes[OBS._header.rinexType] = OBS._header.obsTypes;
+	}
+	else {
+		readHeader(view, [&entry](HeaderLabel label, string_view line) { obsHeaderCommon(label, line, entry.header); });
+		// v2 navigation files give their system by the file type (GPS, GLONASS, SBAS, GALILEO)
+		if (version < 3) {
+			static const string types = "NGHL", systems = "GRSE";
+			size_t found = types.find(entry.fileType);
+			if (found != string::npos) { entry.header.rinexType.assign(1, systems[found]); }
+		}
+	}
+	if (!complete) {
+		entry.error = "END OF HEADER not found";
+		return false;
+	}
+	if (sampleLastEpoch && entry.fileType == 'O' && entry.header.lastObsTime.empty()) {
+		entry.header.lastObsTime = lastEpochTime(filename, text, version);
+		entry.lastFromData = !entry.header.lastObsTime.empty();
+	}
+	return true;
+}
+
+bool isRinexFileName(const string& filename) {
+	string name = filesystem::path(filename).filename().string();
+	transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+	// Compression suffixes
+	for (const char* suffix : { ".gz", ".z" }) {
+		size_t n = strlen(suffix);
+		if (name.size() > n && name.compare(name.size() - n, n, suffix) == 0) {
+			name.resize(name.size() - n);
+			break;
+		}
+	}
+	size_t dot = name.rfind('.');
+	if (dot == string::npos) { return false; }
+	string ext = name.substr(dot + 1);
+	if (ext == "rnx" || ext == "crx") { return true; }
+	// Short names, two digit year and file type (.19o, .19d, .19n,...)
+	return ext.size() == 3 && isdigit(static_cast<unsigned char>(ext[0])) && isdigit(static_cast<unsigned char>(ext[1]))
+		&& isalpha(static_cast<unsigned char>(ext[2]));
+}
+
+vector<InventoryEntry> scanInventory(const string& root, unsigned nThreads, bool sampleLastEpoch) {
+	vector<string> paths;
+	error_code ec;
+	for (filesystem::recursive_directory_iterator it(root, filesystem::directory_options::skip_permission_denied, ec), end;
+		!ec && it != end; it.increment(ec)) {
+		error_code fileEc;
+		if (it->is_regular_file(fileEc) && isRinexFileName(it->path().string())) { paths.push_back(it->path().string()); }
+	}
+	sort(paths.begin(), paths.end());
+	// Each file is read by one worker into its own entry
+	vector<InventoryEntry> entries(paths.size());
+	ThreadPool pool(nThreads);
+	for (size_t i = 0; i < paths.size(); i++) {
+		pool.submit([&paths, &entries, i, sampleLastEpoch] { inventoryFile(paths[i], entries[i], sampleLastEpoch); });
+	}
+	pool.wait();
+	return entries;
+}
+
+// Quoted when it holds a separator, a quote or a line break
+static void csvField(ostream& out, const string& field) {
+	if (field.find_first_of(",\"\r\n") == string::npos) {
+		out << field;
+		return;
+	}
+	out << '"';
+	for (char c : field) {
+		if (c == '"') { out << '"'; }
+		out << c;
+	}
+	out << '"';
+}
+
+static string csvTime(const vector<double>& time) {
+	if (time.size() < 6) { return string(); }
+	char text[40];
+	snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%010.7f", static_cast<int>(time[0]), static_cast<int>(time[1]),
+		static_cast<int>(time[2]), static_cast<int>(time[3]), static_cast<int>(time[4]), time[5]);
+	return text;
+}
+
+void writeInventoryCsv(ostream& out, const vector<InventoryEntry>& entries) {
+	out << "path,size,version,file_type,system,marker_name,marker_number,receiver_type,antenna_type,"
+		"interval,first_obs,last_obs,last_from_data,obs_types,error\n";
+	for (const InventoryEntry& entry : entries) {
+		const ObsHeaderCommon& header = entry.header;
+		string types;
+		for (const auto& sysTypes : entry.obsTypes) {
+			if (!types.empty()) { types += ';'; }
+			types += sysTypes.first + ':';
+			for (size_t i = 0; i < sysTypes.second.size(); i++) { types += (i ? " " : "") + sysTypes.second[i]; }
+		}
+		csvField(out, entry.path); out << ',' << entry.size << ',';
+		if (header.version > 0) { out << header.version; }
+		out << ',' << (entry.fileType == ' ' ? string() : string(1, entry.fileType)) << ',';
+		csvField(out, header.rinexType); out << ',';
+		csvField(out, header.markerName); out << ',';
+		csvField(out, header.markerNumber); out << ',';
+		csvField(out, header.receiverType); out << ',';
+		csvField(out, header.antennaType); out << ',';
+		if (header.interval > 0) { out << header.interval; }
+		out << ',' << csvTime(header.firstObsTime) << ',' << csvTime(header.lastObsTime) << ','
+			<< (entry.lastFromData ? 1 : 0) << ',';
+		csvField(out, types); out << ',';
+		csvField(out, entry.error); out << '\n';
+	}
+}
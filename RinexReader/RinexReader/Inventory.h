@@ -0,0 +1,45 @@
+#pragma once
+/*
+* Inventory.h
+* Catalog of Rinex files built from their headers only
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "RinexHeader.h"
+
+#ifndef INVENTORY_H_
+#define INVENTORY_H_
+
+// What the header of one file tells, for planning jobs without reading the data
+struct InventoryEntry {
+	std::string path;
+	// Size on disk, compressed files keep their compressed size
+	uint64_t size = 0;
+	// File type of RINEX VERSION / TYPE (O, N, G, L,...), blank if the first line is not a Rinex one
+	char fileType = ' ';
+	// Version, satellite system, marker, receiver, antenna, interval and time span
+	ObsHeaderCommon header;
+	// Observation types per satellite system, a v2 file lists them under its own system
+	std::map<std::string, std::vector<std::string>> obsTypes;
+	// Set when lastObsTime was taken from the last epoch of the file instead of TIME OF LAST OBS
+	bool lastFromData = false;
+	// Empty when the header was read
+	std::string error;
+};
+
+// Functions
+// Reads the header of one file, plain or compressed, and nothing after it
+// Without TIME OF LAST OBS the last epoch of a plain observation file is sampled from its end
+bool inventoryFile(const std::string& filename, InventoryEntry& entry, bool sampleLastEpoch = true);
+// File names of Rinex files, compressed or not (.rnx, .crx, .yyo, .yyd, .yyn,..., with .gz or .Z)
+bool isRinexFileName(const std::string& filename);
+// Every Rinex file under root, read in parallel and sorted by path
+// Zero threads picks one per hardware thread
+std::vector<InventoryEntry> scanInventory(const std::string& root, unsigned nThreads = 0, bool sampleLastEpoch = true);
+// One line per file with a header line of column names, times are written as yyyy-mm-dd hh:mm:ss.sssssss
+// so they sort and compare as text, observation types as "G:C1C L1C;R:C1C"
+void writeInventoryCsv(std::ostream& out, const std::vector<InventoryEntry>& entries);
+
+#endif /* INVENTORY_H_ */
@@ -0,0 +1,172 @@
+/*
+* KeplerBatch.cpp
+* Satellite position, velocity and clock from broadcast Keplerian ephemerides, many records at once
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "KeplerBatch.h"
+#include "KeplerKernel.h"
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// WGS84 earth rotation rate (rad/s) and gravitational constants (m^3/s^2) of GPS and GALILEO
+static const double OMEGA_EARTH = 7.2921151467e-5;
+static const double MU_GPS = 3.986005e14;
+static const double MU_GAL = 3.986004418e14;
+static const double SPEED_OF_LIGHT = 299792458.0;
+static const double SECONDS_PER_WEEK = 604800.0;
+
+// Scalar lanes of the kernel, one record at a time
+struct ScalarLanes {
+	typedef double V;
+	static const size_t WIDTH = 1;
+	static double load(const double* p) { return *p; }
+	static void store(double* p, double v) { *p = v; }
+	static void sincos(double x, double& s, double& c) { s = sin(x); c = cos(x); }
+	static double maxAbs(double v) { return fabs(v); }
+};
+
+// Whether the processor and the operating system support AVX2 and FMA
+static bool cpuHasAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) { return false; }
+	__cpuid(info, 1);
+	bool fma = (info[2] & (1 << 12)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	// The OS has to save the YMM registers
+	if (!fma || !osxsave || !avx || (_xgetbv(0) & 6) != 6) { return false; }
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+
+void OrbitStates::resize(size_t n) {
+	x.resize(n); y.resize(n); z.resize(n);
+	vx.resize(n); vy.resize(n); vz.resize(n);
+	clockBias.resize(n);
+	clockDrift.resize(n);
+}
+
+void OrbitStates::reserve(size_t n) {
+	x.reserve(n); y.reserve(n); z.reserve(n);
+	vx.reserve(n); vy.reserve(n); vz.reserve(n);
+	clockBias.reserve(n);
+	clockDrift.reserve(n);
+}
+
+// CONSTRUCTOR
+KeplerBatch::KeplerBatch() : _simd(simdAvailable()) {}
+
+bool KeplerBatch::simdAvailable() {
+	static const bool available = keplerAvx2Compiled() && cpuHasAvx2();
+	return available;
+}
+
+void KeplerBatch::clear() {
+	for (vector<double>* v : { &_A, &_n, &_e, &_sqrt1me2, &_M0, &_sinw, &_cosw, &_Omega0, &_OmegaDot, &_i0, &_idot,
+		&_cuc, &_cus, &_crc, &_crs, &_cic, &_cis, &_af0, &_af1, &_af2, &_relF }) {
+		v->clear();
+	}
+	_toe.clear();
+	_toc.clear();
+}
+
+void KeplerBatch::reserve(size_t n) {
+	for (vector<double>* v : { &_A, &_n, &_e, &_sqrt1me2, &_M0, &_sinw, &_cosw, &_Omega0, &_OmegaDot, &_i0, &_idot,
+		&_cuc, &_cus, &_crc, &_crs, &_cic, &_cis, &_af0, &_af1, &_af2, &_relF }) {
+		v->reserve(n);
+	}
+	_toe.reserve(n);
+	_toc.reserve(n);
+	_tk.reserve(n);
+	_tc.reserve(n);
+}
+
+// Derives the time independent terms of a record
+// TOE is a time of week, its week is taken as the one closest to the time of clock, which also covers week rollovers
+template <typename Eph>
+void KeplerBatch::addKepler(const Eph& eph, double mu) {
+	GpsTime toe = GpsTime::fromWeekSow(eph.gpsTime.week(), eph.TOE);
+	if (toe - eph.gpsTime > SECONDS_PER_WEEK / 2) { toe = toe - SECONDS_PER_WEEK; }
+	else if (eph.gpsTime - toe > SECONDS_PER_WEEK / 2) { toe = toe + SECONDS_PER_WEEK; }
+	double A = eph.Sqrt_a * eph.Sqrt_a;
+	_toe.push_back(toe);
+	_toc.push_back(eph.gpsTime);
+	_A.push_back(A);
+	_n.push_back(sqrt(mu / (A * A * A)) + eph.Delta_n);
+	_e.push_back(eph.Eccentricity);
+	_sqrt1me2.push_back(sqrt(1.0 - eph.Eccentricity * eph.Eccentricity));
+	_M0.push_back(eph.Mo);
+	_sinw.push_back(sin(eph.Omega));
+	_cosw.push_back(cos(eph.Omega));
+	_Omega0.push_back(eph.OMEGA - OMEGA_EARTH * eph.TOE);
+	_OmegaDot.push_back(eph.Omega_dot - OMEGA_EARTH);
+	_i0.push_back(eph.Io);
+	_idot.push_back(eph.IDOT);
+	_cuc.push_back(eph.Cuc);
+	_cus.push_back(eph.Cus);
+	_crc.push_back(eph.Crc);
+	_crs.push_back(eph.Crs);
+	_cic.push_back(eph.Cic);
+	_cis.push_back(eph.CIS);
+	_af0.push_back(eph.clockBias);
+	_af1.push_back(eph.clockDrift);
+	_af2.push_back(eph.clockDriftRate);
+	// F = -2 sqrt(mu) / c^2
+	_relF.push_back(-2.0 * sqrt(mu) / (SPEED_OF_LIGHT * SPEED_OF_LIGHT) * eph.Eccentricity * eph.Sqrt_a);
+}
+
+void KeplerBatch::add(const Rinex3Nav::DataGPS& eph) { addKepler(eph, MU_GPS); }
+void KeplerBatch::add(const Rinex3Nav::DataGAL& eph) { addKepler(eph, MU_GAL); }
+void KeplerBatch::add(const Rinex2Nav::DataGPS& eph) { addKepler(eph, MU_GPS); }
+
+void KeplerBatch::compute(const GpsTime* t, OrbitStates& out) const {
+	size_t count = size();
+	out.resize(count);
+	// Time offsets are taken in integer nanoseconds, the kernel works on seconds
+	_tk.resize(count);
+	_tc.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		_tk[i] = t[i] - _toe[i];
+		_tc[i] = t[i] - _toc[i];
+	}
+	evaluate(out);
+}
+
+void KeplerBatch::compute(GpsTime t, OrbitStates& out) const {
+	size_t count = size();
+	out.resize(count);
+	_tk.resize(count);
+	_tc.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		_tk[i] = t - _toe[i];
+		_tc[i] = t - _toc[i];
+	}
+	evaluate(out);
+}
+
+// Runs the kernel over the time offsets already in _tk and _tc
+void KeplerBatch::evaluate(OrbitStates& out) const {
+	size_t count = size();
+	KeplerLanes k = { _tk.data(), _tc.data(), _A.data(), _n.data(), _e.data(), _sqrt1me2.data(), _M0.data(),
+		_sinw.data(), _cosw.data(), _Omega0.data(), _OmegaDot.data(), _i0.data(), _idot.data(),
+		_cuc.data(), _cus.data(), _crc.data(), _crs.data(), _cic.data(), _cis.data(),
+		_af0.data(), _af1.data(), _af2.data(), _relF.data(),
+		out.x.data(), out.y.data(), out.z.data(), out.vx.data(), out.vy.data(), out.vz.data(),
+		out.clockBias.data(), out.clockDrift.data() };
+	size_t i = _simd ? keplerAvx2(k, 0, count) : 0;
+	// What is left over, or everything without AVX2
+	for (; i < count; i++) { keplerKernel<ScalarLanes>(k, i); }
+}
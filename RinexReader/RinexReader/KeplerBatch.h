@@ -0,0 +1,79 @@
+#pragma once
+/*
+* KeplerBatch.h
+* Satellite position, velocity and clock from broadcast Keplerian ephemerides, many records at once
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex2Nav.h"
+#include "Rinex3Nav.h"
+
+#ifndef KEPLERBATCH_H_
+#define KEPLERBATCH_H_
+
+// Results of a batch, one array per value and one element per record
+// * Position and velocity in ECEF (WGS84 / GTRF) at the evaluation time, in metres and metres per second
+// * Satellite clock offset in seconds including the relativistic correction, without group delays, and its rate
+struct OrbitStates {
+	std::vector<double> x, y, z;
+	std::vector<double> vx, vy, vz;
+	std::vector<double> clockBias;
+	std::vector<double> clockDrift;
+
+	void resize(size_t n);
+	void reserve(size_t n);
+};
+
+// GPS and GALILEO broadcast ephemerides laid out as a structure of arrays
+// What does not depend on time is derived once when a record is added,
+// compute() then evaluates all records together, 4 at a time with AVX2 when the processor has it
+class KeplerBatch
+{
+public:
+	// CONSTRUCTOR
+	KeplerBatch();
+
+	// Functions
+	void clear();
+	void reserve(size_t n);
+	size_t size() const { return _toe.size(); }
+	void add(const Rinex3Nav::DataGPS& eph);
+	void add(const Rinex3Nav::DataGAL& eph);
+	void add(const Rinex2Nav::DataGPS& eph);
+	// Evaluates record i at time t[i], eg: the satellites of an epoch at their transmission times,
+	// or one satellite over many epochs
+	void compute(const GpsTime* t, OrbitStates& out) const;
+	// Evaluates every record at the same time
+	void compute(GpsTime t, OrbitStates& out) const;
+	// Forces the scalar code when off, for eg: comparisons
+	void setSimd(bool on) { _simd = on && simdAvailable(); }
+	bool simd() const { return _simd; }
+	// Whether the AVX2 code was compiled in and the processor runs it
+	static bool simdAvailable();
+
+private:
+	template <typename Eph>
+	void addKepler(const Eph& eph, double mu);
+	void evaluate(OrbitStates& out) const;
+
+	// Attributes
+	bool _simd;
+	// * Reference times of ephemeris and clock
+	std::vector<GpsTime> _toe;
+	std::vector<GpsTime> _toc;
+	// * Orbit, with semi-major axis, corrected mean motion, sqrt(1 - e^2) and perigee precomputed
+	std::vector<double> _A, _n, _e, _sqrt1me2, _M0, _sinw, _cosw;
+	// * Node longitude at the start of the week and its rate, both with the earth rotation removed
+	std::vector<double> _Omega0, _OmegaDot;
+	std::vector<double> _i0, _idot;
+	// * Harmonic corrections
+	std::vector<double> _cuc, _cus, _crc, _crs, _cic, _cis;
+	// * Clock polynomial and relativistic coefficient F * e * sqrt(A)
+	std::vector<double> _af0, _af1, _af2, _relF;
+	// * Time offsets of the last compute, reused so repeated calls do not allocate (one thread per batch)
+	mutable std::vector<double> _tk, _tc;
+};
+
+#endif /* KEPLERBATCH_H_ */
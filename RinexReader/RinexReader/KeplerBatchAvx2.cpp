@@ -0,0 +1,97 @@
+/*
+* KeplerBatchAvx2.cpp
+* AVX2 lanes of the Keplerian orbit kernel, 4 records per step
+* Only this file is built with AVX2 code generation (/arch:AVX2, -mavx2 -mfma), it is called after a processor check
+* Built without it, or with RINEX_NO_SIMD defined, it does nothing and the scalar code does all records
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "KeplerKernel.h"
+
+#if defined(__AVX2__) && !defined(RINEX_NO_SIMD)
+
+#include <immintrin.h>
+
+// 4 doubles in a YMM register
+struct Vec4d {
+	__m256d v;
+	Vec4d() {}
+	Vec4d(__m256d a) : v(a) {}
+	Vec4d(double a) : v(_mm256_set1_pd(a)) {}
+};
+static inline Vec4d operator+(Vec4d a, Vec4d b) { return _mm256_add_pd(a.v, b.v); }
+static inline Vec4d operator-(Vec4d a, Vec4d b) { return _mm256_sub_pd(a.v, b.v); }
+static inline Vec4d operator*(Vec4d a, Vec4d b) { return _mm256_mul_pd(a.v, b.v); }
+static inline Vec4d operator/(Vec4d a, Vec4d b) { return _mm256_div_pd(a.v, b.v); }
+
+// Sine and cosine with the Cephes reduction and polynomials, about 1 ulp for |x| well below 1e9
+static inline void sincos4(Vec4d x, Vec4d& s, Vec4d& c) {
+	const __m256d signMask = _mm256_set1_pd(-0.0);
+	__m256d ax = _mm256_andnot_pd(signMask, x.v);
+	__m256d xSign = _mm256_and_pd(signMask, x.v);
+	// Octant, made even so the reduced argument falls in [-pi/4, pi/4]
+	__m256d y = _mm256_floor_pd(_mm256_mul_pd(ax, _mm256_set1_pd(1.27323954473516268615)));
+	y = _mm256_add_pd(y, _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.5))))));
+	__m256d j = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(8.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.125)))));
+	// Extended precision reduction by pi/4 in three parts
+	__m256d z = _mm256_fnmadd_pd(y, _mm256_set1_pd(7.85398125648498535156E-1), ax);
+	z = _mm256_fnmadd_pd(y, _mm256_set1_pd(3.77489470793079817668E-8), z);
+	z = _mm256_fnmadd_pd(y, _mm256_set1_pd(2.69515142907905952645E-15), z);
+	__m256d zz = _mm256_mul_pd(z, z);
+	// sin(z)
+	__m256d ps = _mm256_set1_pd(1.58962301576546568060E-10);
+	ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-2.50507477628578072866E-8));
+	ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(2.75573136213857245213E-6));
+	ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.98412698295895385996E-4));
+	ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(8.33333333332211858878E-3));
+	ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.66666666666666307295E-1));
+	ps = _mm256_fmadd_pd(_mm256_mul_pd(ps, zz), z, z);
+	// cos(z)
+	__m256d pc = _mm256_set1_pd(-1.13585365213876817300E-11);
+	pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.08757008419747316778E-9));
+	pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-2.75573141792967388112E-7));
+	pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.48015872888517045348E-5));
+	pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-1.38888888888730564116E-3));
+	pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(4.16666666666665929218E-2));
+	pc = _mm256_fmadd_pd(_mm256_mul_pd(pc, zz), zz, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, _mm256_set1_pd(1.0)));
+	// Octants 2 and 6 swap sine and cosine, the sine is negative in 4 and 6, the cosine in 2 and 4
+	__m256d j2 = _mm256_cmp_pd(j, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+	__m256d j4 = _mm256_cmp_pd(j, _mm256_set1_pd(4.0), _CMP_EQ_OQ);
+	__m256d j6 = _mm256_cmp_pd(j, _mm256_set1_pd(6.0), _CMP_EQ_OQ);
+	__m256d swap = _mm256_or_pd(j2, j6);
+	__m256d sinNeg = _mm256_and_pd(_mm256_or_pd(j4, j6), signMask);
+	__m256d cosNeg = _mm256_and_pd(_mm256_or_pd(j2, j4), signMask);
+	s.v = _mm256_xor_pd(_mm256_xor_pd(_mm256_blendv_pd(ps, pc, swap), sinNeg), xSign);
+	c.v = _mm256_xor_pd(_mm256_blendv_pd(pc, ps, swap), cosNeg);
+}
+
+// AVX2 lanes of the kernel, 4 records at a time
+struct Avx2Lanes {
+	typedef Vec4d V;
+	static const size_t WIDTH = 4;
+	static Vec4d load(const double* p) { return _mm256_loadu_pd(p); }
+	static void store(double* p, Vec4d v) { _mm256_storeu_pd(p, v.v); }
+	static void sincos(Vec4d x, Vec4d& s, Vec4d& c) { sincos4(x, s, c); }
+	static double maxAbs(Vec4d v) {
+		__m256d a = _mm256_andnot_pd(_mm256_set1_pd(-0.0), v.v);
+		__m128d m = _mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+		return _mm_cvtsd_f64(_mm_max_sd(m, _mm_unpackhi_pd(m, m)));
+	}
+};
+
+size_t keplerAvx2(const KeplerLanes& k, size_t first, size_t last) {
+	size_t i = first;
+	for (; i + Avx2Lanes::WIDTH <= last; i += Avx2Lanes::WIDTH) { keplerKernel<Avx2Lanes>(k, i); }
+	return i;
+}
+
+bool keplerAvx2Compiled() { return true; }
+
+#else
+
+size_t keplerAvx2(const KeplerLanes&, size_t first, size_t) { return first; }
+
+bool keplerAvx2Compiled() { return false; }
+
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+/*
+* KeplerKernel.h
+* Keplerian orbit evaluation shared by the scalar and the AVX2 code of KeplerBatch
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include <cstddef>
+
+#ifndef KEPLERKERNEL_H_
+#define KEPLERKERNEL_H_
+
+// Input and output arrays of a batch, all indexed by record
+struct KeplerLanes {
+	// Seconds from the ephemeris and the clock reference times
+	const double* tk;
+	const double* tc;
+	const double* A;
+	const double* n;
+	const double* e;
+	const double* sqrt1me2;
+	const double* M0;
+	const double* sinw;
+	const double* cosw;
+	const double* Omega0;
+	const double* OmegaDot;
+	const double* i0;
+	const double* idot;
+	const double* cuc;
+	const double* cus;
+	const double* crc;
+	const double* crs;
+	const double* cic;
+	const double* cis;
+	const double* af0;
+	const double* af1;
+	const double* af2;
+	const double* relF;
+	double* x;
+	double* y;
+	double* z;
+	double* vx;
+	double* vy;
+	double* vz;
+	double* clockBias;
+	double* clockDrift;
+};
+
+// Evaluates Lanes::WIDTH records starting at i (IS-GPS-200 Table 20-IV, velocities by differentiation)
+// Lanes provides the value type V (double or a SIMD register) with load, store, sqrt, sincos and maxAbs
+// Functions here are static on purpose: the AVX2 file includes this header too, and must not share code with the others
+template <typename Lanes>
+static inline void keplerKernel(const KeplerLanes& k, size_t i) {
+	typedef typename Lanes::V V;
+	V tk = Lanes::load(k.tk + i);
+	V tc = Lanes::load(k.tc + i);
+	V A = Lanes::load(k.A + i);
+	V n = Lanes::load(k.n + i);
+	V e = Lanes::load(k.e + i);
+
+	// Kepler's equation by Newton iteration, until every lane has converged
+	V M = Lanes::load(k.M0 + i) + n * tk;
+	V E = M;
+	V sE, cE;
+	for (int iter = 0; iter < 10; iter++) {
+		Lanes::sincos(E, sE, cE);
+		V dE = (E - e * sE - M) / (V(1.0) - e * cE);
+		E = E - dE;
+		if (Lanes::maxAbs(dE) < 1e-14) { break; }
+	}
+	Lanes::sincos(E, sE, cE);
+	V den = V(1.0) - e * cE;
+
+	// Argument of latitude from the true anomaly, by its sine and cosine
+	V sqrt1me2 = Lanes::load(k.sqrt1me2 + i);
+	V sv = sqrt1me2 * sE / den;
+	V cv = (cE - e) / den;
+	V sinw = Lanes::load(k.sinw + i);
+	V cosw = Lanes::load(k.cosw + i);
+	V sphi = sv * cosw + cv * sinw;
+	V cphi = cv * cosw - sv * sinw;
+	V s2 = V(2.0) * sphi * cphi;
+	V c2 = cphi * cphi - sphi * sphi;
+
+	// Second harmonic corrections
+	V cuc = Lanes::load(k.cuc + i), cus = Lanes::load(k.cus + i);
+	V crc = Lanes::load(k.crc + i), crs = Lanes::load(k.crs + i);
+	V cic = Lanes::load(k.cic + i), cis = Lanes::load(k.cis + i);
+	V du = cus * s2 + cuc * c2;
+	V dr = crs * s2 + crc * c2;
+	V di = cis * s2 + cic * c2;
+	V sdu, cdu;
+	Lanes::sincos(du, sdu, cdu);
+	V su = sphi * cdu + cphi * sdu;
+	V cu = cphi * cdu - sphi * sdu;
+	V r = A * den + dr;
+	V idot = Lanes::load(k.idot + i);
+	V inc = Lanes::load(k.i0 + i) + di + idot * tk;
+	V si, ci;
+	Lanes::sincos(inc, si, ci);
+	V OmegaDot = Lanes::load(k.OmegaDot + i);
+	V Om = Lanes::load(k.Omega0 + i) + OmegaDot * tk;
+	V sO, cO;
+	Lanes::sincos(Om, sO, cO);
+
+	// Position
+	V xp = r * cu;
+	V yp = r * su;
+	V X = xp * cO - yp * ci * sO;
+	V Y = xp * sO + yp * ci * cO;
+	Lanes::store(k.x + i, X);
+	Lanes::store(k.y + i, Y);
+	Lanes::store(k.z + i, yp * si);
+
+	// Velocity
+	V Edot = n / den;
+	V phidot = sqrt1me2 * Edot / den;
+	V udot = phidot * (V(1.0) + V(2.0) * (cus * c2 - cuc * s2));
+	V rdot = A * e * sE * Edot + V(2.0) * phidot * (crs * c2 - crc * s2);
+	V idotk = idot + V(2.0) * phidot * (cis * c2 - cic * s2);
+	V xpd = rdot * cu - r * udot * su;
+	V ypd = rdot * su + r * udot * cu;
+	V q = ypd * ci - yp * si * idotk;
+	Lanes::store(k.vx + i, xpd * cO - q * sO - OmegaDot * Y);
+	Lanes::store(k.vy + i, xpd * sO + q * cO + OmegaDot * X);
+	Lanes::store(k.vz + i, yp * ci * idotk + ypd * si);
+
+	// Clock
+	V af1 = Lanes::load(k.af1 + i);
+	V af2 = Lanes::load(k.af2 + i);
+	V relF = Lanes::load(k.relF + i);
+	Lanes::store(k.clockBias + i, Lanes::load(k.af0 + i) + (af1 + af2 * tc) * tc + relF * sE);
+	Lanes::store(k.clockDrift + i, af1 + V(2.0) * af2 * tc + relF * cE * Edot);
+}
+
+// Evaluates the records [first, last) with the AVX2 code, returns the end of what it did
+// Whole groups of 4 only, and nothing when the file was built without AVX2
+size_t keplerAvx2(const KeplerLanes& k, size_t first, size_t last);
+bool keplerAvx2Compiled();
+
+#endif /* KEPLERKERNEL_H_ */
@@ -0,0 +1,124 @@
+/*
+* MappedFile.cpp
+* Read-only memory mapping of an input file for zero-copy parsing
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+#ifdef _WIN32
+MappedFile::MappedFile() : _data(nullptr), _size(0), _isOpen(false), _hFile(INVALID_HANDLE_VALUE), _hMapping(nullptr) {}
+#else
+MappedFile::MappedFile() : _data(nullptr), _size(0), _isOpen(false) {}
+#endif
+MappedFile::~MappedFile() { close(); }
+
+// Maps the whole file into memory, read only
+bool MappedFile::open(const string& filename) {
+	close();
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		perror("Error while opening file");
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize)) {
+		CloseHandle(hFile);
+		perror("Error while reading file");
+		return false;
+	}
+	_hFile = hFile;
+	_size = static_cast<size_t>(fileSize.QuadPart);
+	// Empty files cannot be mapped, but are still valid input
+	if (_size == 0) {
+		_data = "";
+		_isOpen = true;
+		return true;
+	}
+	_hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (_hMapping == nullptr) {
+		close();
+		perror("Error while mapping file");
+		return false;
+	}
+	_data = static_cast<const char*>(MapViewOfFile(_hMapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr) {
+		close();
+		perror("Error while mapping file");
+		return false;
+	}
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		perror("Error while opening file");
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		::close(fd);
+		perror("Error while reading file");
+		return false;
+	}
+	_size = static_cast<size_t>(st.st_size);
+	// Empty files cannot be mapped, but are still valid input
+	if (_size == 0) {
+		::close(fd);
+		_data = "";
+		_isOpen = true;
+		return true;
+	}
+	void* addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	::close(fd);
+	if (addr == MAP_FAILED) {
+		_size = 0;
+		perror("Error while mapping file");
+		return false;
+	}
+	// Epochs are walked front to back
+	madvise(addr, _size, MADV_SEQUENTIAL);
+	_data = static_cast<const char*>(addr);
+#endif
+	_isOpen = true;
+	return true;
+}
+
+// Releases the mapping, any views into the file become invalid
+void MappedFile::close() {
+#ifdef _WIN32
+	if (_hMapping != nullptr) {
+		if (_data != nullptr && _size > 0) { UnmapViewOfFile(_data); }
+		CloseHandle(_hMapping);
+		_hMapping = nullptr;
+	}
+	if (_hFile != INVALID_HANDLE_VALUE) {
+		CloseHandle(_hFile);
+		_hFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (_data != nullptr && _size > 0) {
+		munmap(const_cast<char*>(_data), _size);
+	}
+#endif
+	_data = nullptr;
+	_size = 0;
+	_isOpen = false;
+}
@@ -0,0 +1,44 @@
+#pragma once
+/*
+* MappedFile.h
+* Read-only memory mapping of an input file for zero-copy parsing
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+class MappedFile
+{
+public:
+	// CONSTRUCTOR
+	MappedFile();
+	// DESTRUCTOR
+	~MappedFile();
+	// The mapping is owned, so the object cannot be copied
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Functions
+	bool open(const std::string& filename);
+	void close();
+	bool isOpen() const { return _isOpen; }
+	const char* data() const { return _data; }
+	size_t size() const { return _size; }
+	// Whole file as text, valid for as long as the file stays mapped
+	std::string_view view() const { return std::string_view(_data, _size); }
+
+private:
+	const char* _data;
+	size_t _size;
+	bool _isOpen;
+#ifdef _WIN32
+	void* _hFile;
+	void* _hMapping;
+#endif
+};
+
+#endif /* MAPPEDFILE_H_ */
@@ -0,0 +1,41 @@
+/*
+* ObsCode.cpp
+* Observation codes (C1C, L1C, C1,...) as small integers and their column lookup per satellite system
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ObsCode.h"
+
+using namespace std;
+
+// ((type 1-26) * 10 + band 0-9) * 27 + attribute (0 for none, 1-26), at most 7289
+ObsCode obsCode(string_view code) {
+	if (code.size() < 2 || code.size() > 3) { return 0; }
+	char type = code[0], band = code[1];
+	char attribute = (code.size() == 3) ? code[2] : ' ';
+	if (type < 'A' || type > 'Z' || band < '0' || band > '9') { return 0; }
+	int att = 0;
+	if (attribute >= 'A' && attribute <= 'Z') { att = attribute - 'A' + 1; }
+	else if (attribute != ' ') { return 0; }
+	return static_cast<ObsCode>(((type - 'A' + 1) * 10 + (band - '0')) * 27 + att);
+}
+
+string obsCodeName(ObsCode code) {
+	if (code == 0) { return string(); }
+	int att = code % 27;
+	int band = (code / 27) % 10;
+	int type = code / 270;
+	string name;
+	name += static_cast<char>('A' + type - 1);
+	name += static_cast<char>('0' + band);
+	if (att > 0) { name += static_cast<char>('A' + att - 1); }
+	return name;
+}
+
+// Types the packing does not know keep their column with code 0, so they are never matched
+void ObsCodeTable::setTypes(const vector<string>& types) {
+	_codes.resize(types.size());
+	for (size_t i = 0; i < types.size(); i++) { _codes[i] = obsCode(types[i]); }
+}
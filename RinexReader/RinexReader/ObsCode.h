@@ -0,0 +1,48 @@
+#pragma once
+/*
+* ObsCode.h
+* Observation codes (C1C, L1C, C1,...) as small integers and their column lookup per satellite system
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+
+#ifndef OBSCODE_H_
+#define OBSCODE_H_
+
+// An observation code packed from its type letter, band digit and attribute letter
+// The packing is fixed, so the same code gets the same number in every file and thread, 0 is not a code
+typedef unsigned short ObsCode;
+
+// Functions
+// Rinex 3 (3 characters) or Rinex 2 (2 characters) code to its number, 0 if it is not a code
+ObsCode obsCode(std::string_view code);
+std::string obsCodeName(ObsCode code);
+
+// Columns of the observation types of one satellite system, as listed in the header
+// Built once with the header, then a lookup is a scan over a few small integers
+class ObsCodeTable
+{
+public:
+	// Functions
+	void setTypes(const std::vector<std::string>& types);
+	void clear() { _codes.clear(); }
+	int size() const { return static_cast<int>(_codes.size()); }
+	// Column of a code, -1 if the system does not have it
+	int column(ObsCode code) const {
+		if (code == 0) { return -1; }
+		for (size_t i = 0; i < _codes.size(); i++) {
+			if (_codes[i] == code) { return static_cast<int>(i); }
+		}
+		return -1;
+	}
+	int column(std::string_view code) const { return column(obsCode(code)); }
+	ObsCode code(int column) const { return _codes[column]; }
+
+private:
+	// Attributes
+	std::vector<ObsCode> _codes;
+};
+
+#endif /* OBSCODE_H_ */
@@ -0,0 +1,52 @@
+/*
+* ObsMatrix.cpp
+* Dense [satellite x observation type] storage for one epoch of one satellite system
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ObsMatrix.h"
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+ObsMatrix::ObsMatrix() : _nSats(0), _nTypes(0) {}
+ObsMatrix::~ObsMatrix() {}
+
+// Changing the number of columns invalidates the rows held so far
+void ObsMatrix::setTypes(int nTypes) {
+	_nTypes = nTypes;
+	_nSats = 0;
+}
+
+// Appends a satellite, storage only grows so a steady state epoch never allocates
+int ObsMatrix::addSat(int prn) {
+	int row = _nSats++;
+	if (static_cast<size_t>(_nSats) > _prn.size()) {
+		size_t nRows = max<size_t>(16, _prn.size() * 2);
+		_prn.resize(nRows);
+		_values.resize(nRows * _nTypes);
+		_lli.resize(nRows * _nTypes);
+		_ss.resize(nRows * _nTypes);
+	}
+	else if (_values.size() < static_cast<size_t>(_nSats) * _nTypes) {
+		// More types than the rows were sized for
+		_values.resize(_prn.size() * _nTypes);
+		_lli.resize(_prn.size() * _nTypes);
+		_ss.resize(_prn.size() * _nTypes);
+	}
+	_prn[row] = prn;
+	fill_n(values(row), _nTypes, 0.0);
+	fill_n(lli(row), _nTypes, static_cast<unsigned char>(0));
+	fill_n(ss(row), _nTypes, static_cast<unsigned char>(0));
+	return row;
+}
+
+// Linear search, an epoch holds a few dozen satellites per system at most
+int ObsMatrix::findSat(int prn) const {
+	for (int row = 0; row < _nSats; row++) {
+		if (_prn[row] == prn) { return row; }
+	}
+	return -1;
+}
@@ -0,0 +1,61 @@
+#pragma once
+/*
+* ObsMatrix.h
+* Dense [satellite x observation type] storage for one epoch of one satellite system
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Span.h"
+
+#ifndef OBSMATRIX_H_
+#define OBSMATRIX_H_
+
+class ObsMatrix
+{
+public:
+	// CONSTRUCTOR
+	ObsMatrix();
+	// DESTRUCTOR
+	~ObsMatrix();
+
+	// Functions
+	// Number of observation types (columns), normally set once from the header
+	void setTypes(int nTypes);
+	// Drops all satellites, allocated capacity is kept for the next epoch
+	void clear() { _nSats = 0; }
+	// Appends a satellite row with all observations zeroed, returns its row
+	int addSat(int prn);
+	// Row of a satellite, -1 if not observed in this epoch
+	int findSat(int prn) const;
+
+	int nSats() const { return _nSats; }
+	int nTypes() const { return _nTypes; }
+	int prn(int row) const { return _prn[row]; }
+	// Row access, nTypes() contiguous entries per row
+	double* values(int row) { return _values.data() + static_cast<size_t>(row) * _nTypes; }
+	const double* values(int row) const { return _values.data() + static_cast<size_t>(row) * _nTypes; }
+	unsigned char* lli(int row) { return _lli.data() + static_cast<size_t>(row) * _nTypes; }
+	const unsigned char* lli(int row) const { return _lli.data() + static_cast<size_t>(row) * _nTypes; }
+	unsigned char* ss(int row) { return _ss.data() + static_cast<size_t>(row) * _nTypes; }
+	const unsigned char* ss(int row) const { return _ss.data() + static_cast<size_t>(row) * _nTypes; }
+	double value(int row, int type) const { return _values[static_cast<size_t>(row) * _nTypes + type]; }
+	// Views over the epoch, valid until the next addSat(): the PRNs and one observation type of all satellites
+	// Row i of column() belongs to prns()[i], a type out of range gives an empty view
+	Span<int> prns() const { return Span<int>(_prn.data(), _nSats); }
+	StridedSpan<double> column(int type) const {
+		if (type < 0 || type >= _nTypes) { return StridedSpan<double>(); }
+		return StridedSpan<double>(_values.data() + type, _nSats, _nTypes);
+	}
+
+private:
+	int _nSats;
+	int _nTypes;
+	std::vector<int> _prn;
+	std::vector<double> _values;
+	std::vector<unsigned char> _lli; // Loss of lock indicator
+	std::vector<unsigned char> _ss; // Signal strength
+};
+
+#endif /* OBSMATRIX_H_ */
@@ -0,0 +1,226 @@
+/*
+* ObsStore.cpp
+* Whole-file columnar observation storage with time and satellite slicing
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ObsStore.h"
+#include <limits>
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+ObsStore::ObsStore() : _interval(0), _satIndex(SYS_COUNT * (MAX_PRN + 1), -1) {}
+ObsStore::~ObsStore() {}
+
+// To clear contents of the store
+void ObsStore::clear() {
+	_times.clear();
+	_clockOffsets.clear();
+	_interval = 0;
+	for (int sys = 0; sys < SYS_COUNT; sys++) {
+		_types[sys].clear();
+		_typeIndex[sys].clear();
+	}
+	fill(_satIndex.begin(), _satIndex.end(), -1);
+	_sats.clear();
+}
+
+// Observation types of a system as stated in the header
+void ObsStore::setTypes(int sys, const vector<string>& types) {
+	_types[sys] = types;
+	_typeIndex[sys].setTypes(types);
+}
+
+// Starts a new epoch, observations added next belong to it
+void ObsStore::addEpoch(GpsTime gpsTime, double recClockOffset) {
+	_times.push_back(gpsTime);
+	_clockOffsets.push_back(recClockOffset);
+}
+
+// Appends the observations of one system for the current epoch
+// Columns are padded lazily, so satellites only pay for the epochs up to their last observation
+void ObsStore::addObservations(int sys, const ObsMatrix& matrix) {
+	if (_times.empty()) { return; }
+	size_t epoch = _times.size() - 1;
+	size_t nTypes = _types[sys].size();
+	for (int row = 0; row < matrix.nSats(); row++) {
+		int prn = matrix.prn(row);
+		if (prn < 0 || prn > MAX_PRN) { continue; }
+		int& idx = _satIndex[sys * (MAX_PRN + 1) + prn];
+		if (idx < 0) {
+			idx = static_cast<int>(_sats.size());
+			SatColumns columns;
+			columns.sat = packSat(sys, prn);
+			columns.values.resize(nTypes);
+			columns.lli.resize(nTypes);
+			_sats.push_back(std::move(columns));
+		}
+		SatColumns& columns = _sats[idx];
+		const double* values = matrix.values(row);
+		const unsigned char* lli = matrix.lli(row);
+		for (size_t k = 0; k < nTypes; k++) {
+			vector<double>& column = columns.values[k];
+			vector<unsigned char>& flags = columns.lli[k];
+			if (column.size() > epoch) { continue; } // satellite listed twice in the epoch
+			column.resize(epoch, numeric_limits<double>::quiet_NaN());
+			flags.resize(epoch, 0);
+			bool available = static_cast<int>(k) < matrix.nTypes();
+			column.push_back(available ? values[k] : numeric_limits<double>::quiet_NaN());
+			flags.push_back(available ? lli[k] : 0);
+		}
+	}
+}
+
+// Pads all columns to the full length and works out the sampling interval
+void ObsStore::finish() {
+	for (SatColumns& columns : _sats) {
+		for (vector<double>& column : columns.values) { column.resize(_times.size(), numeric_limits<double>::quiet_NaN()); }
+		for (vector<unsigned char>& flags : columns.lli) { flags.resize(_times.size(), 0); }
+	}
+	_interval = (_times.size() > 1) ? _times[1] - _times[0] : 0;
+}
+
+// Column of an observation code for a system
+int ObsStore::typeIndex(int sys, const string& code) const {
+	if (sys < 0 || sys >= SYS_COUNT) { return -1; }
+	return _typeIndex[sys].column(code);
+}
+
+// Store index of a satellite, direct table lookup
+int ObsStore::satIndex(int sys, int prn) const {
+	if (sys < 0 || sys >= SYS_COUNT || prn < 0 || prn > MAX_PRN) { return -1; }
+	return _satIndex[sys * (MAX_PRN + 1) + prn];
+}
+
+// First epoch at or after time t
+// Regular sampling lets the index be computed directly, otherwise fall back to a binary search
+size_t ObsStore::epochIndex(GpsTime t) const {
+	size_t n = _times.size();
+	if (n == 0 || t <= _times.front()) { return 0; }
+	if (t > _times.back()) { return n; }
+	if (_interval > 0) {
+		double guess = ceil((t - _times.front()) / _interval - 1e-9);
+		size_t i = static_cast<size_t>(guess);
+		if (i < n && _times[i] >= t && _times[i - 1] < t) { return i; }
+	}
+	return lower_bound(_times.begin(), _times.end(), t) - _times.begin();
+}
+
+// Whole column of one satellite and observation type
+Span<double> ObsStore::values(int satIdx, int type) const {
+	if (satIdx < 0 || satIdx >= static_cast<int>(_sats.size())) { return Span<double>(); }
+	const SatColumns& columns = _sats[satIdx];
+	if (type < 0 || type >= static_cast<int>(columns.values.size())) { return Span<double>(); }
+	return Span<double>(columns.values[type].data(), columns.values[type].size());
+}
+
+// Loss of lock flags of one satellite and observation type
+Span<unsigned char> ObsStore::lli(int satIdx, int type) const {
+	if (satIdx < 0 || satIdx >= static_cast<int>(_sats.size())) { return Span<unsigned char>(); }
+	const SatColumns& columns = _sats[satIdx];
+	if (type < 0 || type >= static_cast<int>(columns.lli.size())) { return Span<unsigned char>(); }
+	return Span<unsigned char>(columns.lli[type].data(), columns.lli[type].size());
+}
+
+// Observations of one satellite between t0 and t1
+Span<double> ObsStore::values(int sys, int prn, const string& code, GpsTime t0, GpsTime t1) const {
+	Span<double> column = values(satIndex(sys, prn), typeIndex(sys, code));
+	if (column.empty() || t1 < t0) { return Span<double>(); }
+	size_t first = epochIndex(t0);
+	size_t last = epochIndex(t1);
+	// Include an epoch falling exactly on t1
+	if (last < _times.size() && _times[last] == t1) { last++; }
+	return Span<double>(column.data + first, last - first);
+}
+
+// Records of the observation cache sections
+// Observation code of a system, eg: C1C of GPS
+struct ObsCacheType {
+	int32_t sys;
+	char code[4];
+};
+// A satellite and where its columns start in the values and flags sections
+struct ObsCacheSat {
+	uint16_t sat;
+	uint16_t nTypes;
+	uint32_t reserved;
+	uint64_t first;
+};
+
+// Adds the store to a cache, one column after another per satellite and type
+void ObsStore::saveCache(CacheWriter& cache) const {
+	vector<int64_t> times;
+	times.reserve(_times.size());
+	for (GpsTime t : _times) { times.push_back(t.nanoseconds()); }
+	vector<ObsCacheType> types;
+	for (int sys = 0; sys < SYS_COUNT; sys++) {
+		for (const string& code : _types[sys]) {
+			ObsCacheType type = { sys, { 0, 0, 0, 0 } };
+			memcpy(type.code, code.data(), min(code.size(), sizeof(type.code)));
+			types.push_back(type);
+		}
+	}
+	vector<ObsCacheSat> sats;
+	vector<double> values;
+	vector<unsigned char> lli;
+	values.reserve(_sats.size() * _times.size() * 4);
+	for (const SatColumns& columns : _sats) {
+		ObsCacheSat sat = { columns.sat, static_cast<uint16_t>(columns.values.size()), 0, values.size() };
+		sats.push_back(sat);
+		for (size_t k = 0; k < columns.values.size(); k++) {
+			values.insert(values.end(), columns.values[k].begin(), columns.values[k].end());
+			lli.insert(lli.end(), columns.lli[k].begin(), columns.lli[k].end());
+		}
+	}
+	cache.add(SEC_OBS_TIMES, times);
+	cache.add(SEC_OBS_CLOCKS, _clockOffsets);
+	cache.add(SEC_OBS_TYPES, types);
+	cache.add(SEC_OBS_SATS, sats);
+	cache.add(SEC_OBS_VALUES, values);
+	cache.add(SEC_OBS_LLI, lli);
+}
+
+// Fills the store from a cache, false if the cache does not hold a consistent store
+bool ObsStore::loadCache(const CacheReader& cache) {
+	Span<int64_t> times = cache.records<int64_t>(SEC_OBS_TIMES);
+	Span<double> clocks = cache.records<double>(SEC_OBS_CLOCKS);
+	Span<ObsCacheType> types = cache.records<ObsCacheType>(SEC_OBS_TYPES);
+	Span<ObsCacheSat> sats = cache.records<ObsCacheSat>(SEC_OBS_SATS);
+	Span<double> values = cache.records<double>(SEC_OBS_VALUES);
+	Span<unsigned char> lli = cache.records<unsigned char>(SEC_OBS_LLI);
+	if (!cache.has(SEC_OBS_TIMES) || clocks.size != times.size || values.size != lli.size) { return false; }
+	clear();
+	vector<string> codes[SYS_COUNT];
+	for (const ObsCacheType& type : types) {
+		if (type.sys < 0 || type.sys >= SYS_COUNT) { clear(); return false; }
+		codes[type.sys].push_back(string(type.code, strnlen(type.code, sizeof(type.code))));
+	}
+	for (int sys = 0; sys < SYS_COUNT; sys++) { setTypes(sys, codes[sys]); }
+	_times.reserve(times.size);
+	for (int64_t ns : times) { _times.push_back(GpsTime::fromNanoseconds(ns)); }
+	_clockOffsets.assign(clocks.begin(), clocks.end());
+	size_t n = _times.size();
+	for (const ObsCacheSat& sat : sats) {
+		int sys = satSystem(sat.sat);
+		if (sys >= SYS_COUNT || sat.nTypes != _types[sys].size() || sat.first + sat.nTypes * n > values.size) {
+			clear();
+			return false;
+		}
+		_satIndex[sys * (MAX_PRN + 1) + satPRN(sat.sat)] = static_cast<int>(_sats.size());
+		SatColumns columns;
+		columns.sat = sat.sat;
+		columns.values.resize(sat.nTypes);
+		columns.lli.resize(sat.nTypes);
+		for (size_t k = 0; k < sat.nTypes; k++) {
+			size_t first = sat.first + k * n;
+			columns.values[k].assign(values.data + first, values.data + first + n);
+			columns.lli[k].assign(lli.data + first, lli.data + first + n);
+		}
+		_sats.push_back(std::move(columns));
+	}
+	_interval = (_times.size() > 1) ? _times[1] - _times[0] : 0;
+	return true;
+}
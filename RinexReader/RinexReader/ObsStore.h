@@ -0,0 +1,79 @@
+#pragma once
+/*
+* ObsStore.h
+* Whole-file columnar observation storage with time and satellite slicing
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "GnssSystem.h"
+#include "ObsMatrix.h"
+#include "ObsCode.h"
+#include "Span.h"
+#include "BinaryCache.h"
+#include "TimeUtils.h"
+
+#ifndef OBSSTORE_H_
+#define OBSSTORE_H_
+
+class ObsStore
+{
+public:
+	// CONSTRUCTOR
+	ObsStore();
+	// DESTRUCTOR
+	~ObsStore();
+
+	// Highest PRN that can be indexed per system
+	static const int MAX_PRN = 255;
+
+	// Functions
+	void clear();
+	// * Building the store, epoch by epoch
+	void setTypes(int sys, const std::vector<std::string>& types);
+	void addEpoch(GpsTime gpsTime, double recClockOffset);
+	void addObservations(int sys, const ObsMatrix& matrix);
+	void finish();
+	// * Binary cache, the columns are written as they are and the indexes rebuilt on loading
+	void saveCache(CacheWriter& cache) const;
+	bool loadCache(const CacheReader& cache);
+
+	// * Lookups
+	size_t nEpochs() const { return _times.size(); }
+	size_t nSats() const { return _sats.size(); }
+	const std::vector<GpsTime>& times() const { return _times; }
+	const std::vector<double>& clockOffsets() const { return _clockOffsets; }
+	const std::vector<std::string>& types(int sys) const { return _types[sys]; }
+	// Column of an observation code for a system, -1 if not in the file
+	int typeIndex(int sys, const std::string& code) const;
+	// Store index of a satellite, -1 if never observed
+	int satIndex(int sys, int prn) const;
+	unsigned short sat(int satIdx) const { return _sats[satIdx].sat; }
+	// First epoch at or after time t, nEpochs() if there is none
+	size_t epochIndex(GpsTime t) const;
+	// Whole column of one satellite and observation type over all epochs
+	// Epochs where the satellite was not observed hold NaN
+	Span<double> values(int satIdx, int type) const;
+	Span<unsigned char> lli(int satIdx, int type) const;
+	// Observations of one satellite between t0 and t1 (inclusive), for eg: C1C of G05
+	Span<double> values(int sys, int prn, const std::string& code, GpsTime t0, GpsTime t1) const;
+
+private:
+	// All epochs of one satellite, one contiguous column per observation type
+	struct SatColumns {
+		unsigned short sat;
+		std::vector<std::vector<double>> values;
+		std::vector<std::vector<unsigned char>> lli;
+	};
+
+	std::vector<GpsTime> _times;
+	std::vector<double> _clockOffsets;
+	double _interval;
+	std::vector<std::string> _types[SYS_COUNT];
+	ObsCodeTable _typeIndex[SYS_COUNT];
+	std::vector<int> _satIndex;
+	std::vector<SatColumns> _sats;
+};
+
+#endif /* OBSSTORE_H_ */
@@ -0,0 +1,123 @@
+/*
+* ParallelObsReader.cpp
+* Multi-threaded reading of whole observation files, split into chunks at epoch boundaries
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ParallelObsReader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Chunks handed out per worker, smaller chunks even out epochs of uneven size
+static const size_t CHUNKS_PER_THREAD = 4;
+
+// Rinex v3 epochs start with the '>' record identifier
+static bool isRinex3EpochLine(string_view line) {
+	return !line.empty() && line[0] == '>';
+}
+
+// Offsets into text where the chunks start, each one at the beginning of an epoch line
+vector<size_t> epochChunkOffsets(string_view text, size_t nChunks, bool (*isEpochLine)(string_view)) {
+	vector<size_t> offsets;
+	if (text.empty() || nChunks == 0) { return offsets; }
+	size_t target = 0;
+	size_t chunkSize = max<size_t>(1, text.size() / nChunks);
+	while (target < text.size()) {
+		// Move to the start of the line containing the target
+		size_t pos = (target == 0) ? 0 : text.rfind('\n', target - 1);
+		pos = (pos == string_view::npos || target == 0) ? 0 : pos + 1;
+		// and forward to the first epoch line from there
+		while (pos < text.size()) {
+			size_t end = text.find('\n', pos);
+			if (end == string_view::npos) { end = text.size(); }
+			string_view line = text.substr(pos, end - pos);
+			if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+			if (isEpochLine(line)) { break; }
+			pos = end + 1;
+		}
+		if (pos >= text.size()) { break; }
+		if (offsets.empty() || pos > offsets.back()) { offsets.push_back(pos); }
+		target = max(pos + 1, target + chunkSize);
+	}
+	return offsets;
+}
+
+// Parses every chunk on its own reader and joins the results in chunk order
+// Each reader gets the header once so its epoch storage is sized exactly as the sequential one
+template <typename Reader, typename Epoch, typename ParseEpoch>
+static void parseChunks(string_view header, string_view body, const vector<size_t>& offsets,
+	unsigned nThreads, vector<Epoch>& epochs, ParseEpoch parseEpoch) {
+	vector<vector<Epoch>> chunks(offsets.size());
+	{
+		ThreadPool pool(nThreads);
+		for (size_t i = 0; i < offsets.size(); i++) {
+			size_t end = (i + 1 < offsets.size()) ? offsets[i + 1] : body.size();
+			string_view chunk = body.substr(offsets[i], end - offsets[i]);
+			pool.submit([header, chunk, &chunks, i, &parseEpoch] {
+				Reader reader;
+				string_view headerText = header;
+				reader.obsHeader(headerText);
+				string_view text = chunk;
+				while (parseEpoch(reader, text)) { chunks[i].push_back(parseEpoch.current(reader)); }
+			});
+		}
+		pool.wait();
+	}
+	size_t total = 0;
+	for (const vector<Epoch>& chunk : chunks) { total += chunk.size(); }
+	epochs.clear();
+	epochs.reserve(total);
+	for (vector<Epoch>& chunk : chunks) {
+		for (Epoch& epoch : chunk) { epochs.push_back(std::move(epoch)); }
+	}
+}
+
+// Epoch readers of both versions, behind a common call
+struct Rinex3EpochParser {
+	bool operator()(Rinex3Obs& reader, string_view& text) const { return reader.obsEpoch(text); }
+	const Rinex3Obs::ObsEpochInfo& current(const Rinex3Obs& reader) const { return reader._EpochObs; }
+};
+struct Rinex2EpochParser {
+	int nObsTypes;
+	bool operator()(Rinex2Obs& reader, string_view& text) const { return reader.obsEpoch(text, nObsTypes); }
+	const Rinex2Obs::ObsEpochInfo& current(const Rinex2Obs& reader) const { return reader._obsDataGPS; }
+};
+
+// Reads a whole Rinex v3 observation file on a thread pool
+bool readRinex3ObsParallel(const string& filename, Rinex3Obs::ObsHeaderInfo& header,
+	vector<Rinex3Obs::ObsEpochInfo>& epochs, unsigned nThreads) {
+	MappedFile file;
+	if (!file.open(filename)) { return false; }
+	// Header is read once here, the workers re-read it from its own view
+	string_view text = file.view();
+	Rinex3Obs OBS;
+	OBS.obsHeader(text);
+	header = OBS._Header;
+	string_view headerText = file.view().substr(0, file.size() - text.size());
+	if (nThreads == 0) { nThreads = max(1u, thread::hardware_concurrency()); }
+	vector<size_t> offsets = epochChunkOffsets(text, nThreads * CHUNKS_PER_THREAD, isRinex3EpochLine);
+	parseChunks<Rinex3Obs>(headerText, text, offsets, nThreads, epochs, Rinex3EpochParser());
+	return true;
+}
+
+// Reads a whole Rinex v2 observation file on a thread pool
+bool readRinex2ObsParallel(const string& filename, Rinex2Obs::ObsHeaderInfo& header,
+	vector<Rinex2Obs::ObsEpochInfo>& epochs, unsigned nThreads) {
+	MappedFile file;
+	if (!file.open(filename)) { return false; }
+	string_view text = file.view();
+	Rinex2Obs OBS;
+	OBS.obsHeader(text);
+	header = OBS._header;
+	string_view headerText = file.view().substr(0, file.size() - text.size());
+	if (nThreads == 0) { nThreads = max(1u, thread::hardware_concurrency()); }
+	vector<size_t> offsets = epochChunkOffsets(text, nThreads * CHUNKS_PER_THREAD, Rinex2Obs::isEpochLine);
+	Rinex2EpochParser parser;
+	parser.nObsTypes = header.nObsTypes;
+	parseChunks<Rinex2Obs>(headerText, text, offsets, nThreads, epochs, parser);
+	return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+/*
+* ParallelObsReader.h
+* Multi-threaded reading of whole observation files, split into chunks at epoch boundaries
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex2Obs.h"
+#include "Rinex3Obs.h"
+
+#ifndef PARALLELOBSREADER_H_
+#define PARALLELOBSREADER_H_
+
+// Functions
+// The file is memory mapped, the epoch section is cut into chunks starting on epoch lines
+// and the chunks are parsed on a thread pool. Epochs come back in file order, identical
+// to reading the file with the sequential memory mapped obsEpoch loop.
+// Zero threads picks one per hardware thread
+bool readRinex3ObsParallel(const std::string& filename, Rinex3Obs::ObsHeaderInfo& header,
+	std::vector<Rinex3Obs::ObsEpochInfo>& epochs, unsigned nThreads = 0);
+bool readRinex2ObsParallel(const std::string& filename, Rinex2Obs::ObsHeaderInfo& header,
+	std::vector<Rinex2Obs::ObsEpochInfo>& epochs, unsigned nThreads = 0);
+// Offsets into text where the chunks start, each one at the beginning of an epoch line
+std::vector<size_t> epochChunkOffsets(std::string_view text, size_t nChunks, bool (*isEpochLine)(std::string_view));
+
+#endif /* PARALLELOBSREADER_H_ */
@@ -7,6 +7,8 @@
 
 #include "pch.h"
 #include "Rinex2Nav.h"
+#include "FieldParser.h"
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -15,50 +17,40 @@ Rinex2Nav::Rinex2Nav() {}
 Rinex2Nav::~Rinex2Nav() {}
 
 // A function to help with organizing GPS header
-// Works for the alpha/beta ionospheric constants and time correction
-vector<double> headerHelper(string line) {
-	line = line.substr(2, 58);
-	string word;
+// Works for the alpha/beta ionospheric constants (2X,4D12.4)
+vector<double> headerHelper(string_view line) {
 	vector<double> data;
-	istringstream iss(line);
-	vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-	for (string s : words) {
-		data.push_back(stod(s));
+	for (size_t col = 2; col < 50; col += 12) {
+		if (isBlankField(line, col, 12)) { continue; }
+		data.push_back(floatField(line, col, 12));
 	}
 	return data;
 }
 
-
-// Organizes Epoch Time Information into Vector
-vector<double> rinex2EpochTimeOrganizer(string line) {
-	vector<double> epochRecord;
-	line = line.substr(2, 20);
-	// Splitting words in the line
-	istringstream iss(line);
-	vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-	for (string s : words) {
-		epochRecord.push_back(stod(s));
+// Organizes Epoch Time Information into an array of 6 values
+// PRN yy mm dd hh mm ss.s (I2,5(1X,I2),F5.1)
+void rinex2EpochTimeOrganizer(string_view line, double* epochRecord) {
+	static const size_t cols[][2] = { {3, 2}, {6, 2}, {9, 2}, {12, 2}, {15, 2}, {17, 5} };
+	for (size_t i = 0; i < 6; i++) {
+		epochRecord[i] = floatField(line, cols[i][0], cols[i][1]);
 	}
-	// Return: Vector containing the Epoch Info
-	return epochRecord;
 }
 
 // Function to split and organize navigation parameters
-vector<double> rinex2NavDataSplitter(string line) {
-	// Split line every 19 spaces as allocated for parameters
-	vector<double> data;
-	string word;
-	for (unsigned i = 0; i < line.length(); i += 19) {
-		word = line.substr(i, 19);
-		if (word.find_first_not_of(' ') == std::string::npos) { continue; }
-		data.push_back(stod(replaceChars(word, 'D', 'e')));
-		word.clear();
+// First line holds 3 parameters after the epoch, the others 4 (3X,4D19.12)
+// Blank parameters are kept in place as zero so the positions never shift
+void rinex2NavDataSplitter(const vector<string>& block, double* parameters, size_t nParameters) {
+	size_t n = 0;
+	for (size_t i = 0; i < block.size(); i++) {
+		for (size_t col = (i == 0) ? 22 : 3; col < 79 && n < nParameters; col += 19) {
+			parameters[n++] = floatField(block[i], col, 19);
+		}
 	}
-	return data;
+	while (n < nParameters) { parameters[n++] = 0.0; }
 }
 
 // Epoch Time Matcher, returns index of most appropriate Navigation vector
-int Rinex2Nav::EpochMatcher(double obsTime, std::vector<Rinex2Nav::DataGPS> NAV) {
+int Rinex2Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex2Nav::DataGPS>& NAV) {
 	// Initialize time difference variable using arbitrary large number
 	double diff = 1000000; int index = 0;
 	for (unsigned i = 0; i < NAV.size(); i++) {
@@ -73,132 +65,102 @@ int Rinex2Nav::EpochMatcher(double obsTime, std::vector<Rinex2Nav::DataGPS> NAV)
 }
 
 // Navigation Body Organizer for GPS Navigation File
-Rinex2Nav::DataGPS epochNavOrganizer(vector<string> block) {
-	int prn = stoi(block[0].substr(0, 2));
-	vector<double> epochInfo = rinex2EpochTimeOrganizer(block[0]);
-	string line = block[0].substr(22, block[0].length());
-	for (int i = 1; i < (int)block.size(); i++) {
-		line = line + block[i];
-	}
-	vector<double> parameters = rinex2NavDataSplitter(line);
+Rinex2Nav::DataGPS epochNavOrganizer(const vector<string>& block) {
+	RINEX_TIME(TIME_CONVERT);
+	int prn = intField(block[0], 0, 2);
+	double epochInfo[6];
+	rinex2EpochTimeOrganizer(block[0], epochInfo);
+	double parameters[29];
+	rinex2NavDataSplitter(block, parameters, 29);
 	// Storing Values into GPS Data Structure
 	Rinex2Nav::DataGPS GPS;
 	GPS.isAvailable = true;
 	GPS.PRN = prn;
-	GPS.epochInfo = epochInfo;
 	GPS.gpsTime = gpsTime(epochInfo);
-	GPS.clockBias = parameters.at(0);
-	GPS.clockDrift = parameters.at(1);
-	GPS.clockDriftRate = parameters.at(2);
-	GPS.IODE = parameters.at(3);
-	GPS.Crs = parameters.at(4);
-	GPS.Delta_n = parameters.at(5);
-	GPS.Mo = parameters.at(6);
-	GPS.Cuc = parameters.at(7);
-	GPS.Eccentricity = parameters.at(8);
-	GPS.Cus = parameters.at(9);
-	GPS.Sqrt_a = parameters.at(10);
-	GPS.TOE = parameters.at(11);
-	GPS.Cic = parameters.at(12);
-	GPS.OMEGA = parameters.at(13);
-	GPS.CIS = parameters.at(14);
-	GPS.Io = parameters.at(15);
-	GPS.Crc = parameters.at(16);
-	GPS.Omega = parameters.at(17);
-	GPS.Omega_dot = parameters.at(18);
-	GPS.IDOT = parameters.at(19);
-	GPS.L2_codes_channel = parameters.at(20);
-	GPS.GPS_week = parameters.at(21);
-	GPS.L2_P_data_flag = parameters.at(22);
-	GPS.svAccuracy = parameters.at(23);
-	GPS.svHealth = parameters.at(24);
-	GPS.TGD = parameters.at(25);
-	GPS.IODC = parameters.at(26);
-	if (parameters.size() > 27) { GPS.transmission_time = parameters.at(27); }
-	if (parameters.size() > 28) { GPS.fit_interval = parameters.at(28); }
+	GPS.clockBias = parameters[0];
+	GPS.clockDrift = parameters[1];
+	GPS.clockDriftRate = parameters[2];
+	GPS.IODE = parameters[3];
+	GPS.Crs = parameters[4];
+	GPS.Delta_n = parameters[5];
+	GPS.Mo = parameters[6];
+	GPS.Cuc = parameters[7];
+	GPS.Eccentricity = parameters[8];
+	GPS.Cus = parameters[9];
+	GPS.Sqrt_a = parameters[10];
+	GPS.TOE = parameters[11];
+	GPS.Cic = parameters[12];
+	GPS.OMEGA = parameters[13];
+	GPS.CIS = parameters[14];
+	GPS.Io = parameters[15];
+	GPS.Crc = parameters[16];
+	GPS.Omega = parameters[17];
+	GPS.Omega_dot = parameters[18];
+	GPS.IDOT = parameters[19];
+	GPS.L2_codes_channel = parameters[20];
+	GPS.GPS_week = static_cast<int>(lround(parameters[21]));
+	GPS.L2_P_data_flag = parameters[22];
+	GPS.svAccuracy = parameters[23];
+	GPS.svHealth = parameters[24];
+	GPS.TGD = parameters[25];
+	GPS.IODC = parameters[26];
+	GPS.transmission_time = parameters[27];
+	GPS.fit_interval = parameters[28];
 	return GPS;
 }
 
+// Handles a single header line
+void Rinex2Nav::navHeaderRecord(HeaderLabel label, string_view line) {
+	switch (label) {
+	// Ionospheric constants
+	case HDR_ION_ALPHA:
+		_header.ialpha = headerHelper(line);
+		break;
+	case HDR_ION_BETA:
+		_header.ibeta = headerHelper(line);
+		break;
+	// GPS to UTC Time Correction
+	// A0, A1 (3X,2D19.12) then reference time and week (2I9)
+	case HDR_DELTA_UTC:
+		_header.dUTC = { floatField(line, 3, 19), floatField(line, 22, 19), floatField(line, 41, 9), floatField(line, 50, 9) };
+		break;
+	case HDR_LEAP_SECONDS:
+		_header.leap = intField(line, 0, 6);
+		break;
+	default:
+		break;
+	}
+}
+
 // Reader for GPS navigation file
-void Rinex2Nav::readNav(std::ifstream& infile) {
-	// String tokens to look for
-	const string sTokenIALPHA = "ION ALPHA";
-	const string sTokenIBETA = "ION BETA";
-	const string sTokenUTC = "DELTA-UTC: A0,A1,T,W";
-	const string sTokenLEAP = "LEAP SECONDS";
-	const string sTokenEND = "END OF HEADER";
-	const string sTokenCOM = "COMMENT";
+void Rinex2Nav::readNav(std::istream& infile) {
 	// A vector to hold block of sentences
 	vector<string> block;
 	// To hold contents of a line from input file
 	string line;
 	int nlines = 0;
 
-	// Reading Header 
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_ALPHA = line.find(sTokenIALPHA);
-		size_t found_BETA = line.find(sTokenIBETA);
-		size_t found_END = line.find(sTokenEND);
-		size_t found_UTC = line.find(sTokenUTC);
-		size_t found_LEAP = line.find(sTokenLEAP);
-		size_t found_COM = line.find(sTokenCOM);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// Finding Ionophseric Constants as per new format
-		else if (found_ALPHA != string::npos) {
-			vector<double> ialpha = headerHelper(line);
-			_header.ialpha = ialpha;
-		}
-		else if (found_BETA != string::npos) {
-			vector<double> ibeta = headerHelper(line);
-			_header.ibeta = ibeta;
-		}
-		// Finding GPS to UTC Time Correction
-		else if (found_UTC != string::npos) {
-			line = line.substr(1, 59);
-			vector<double> dUTC;
-			double A0 = stod(line.substr(0, 21)); dUTC.push_back(A0);
-			double A1 = stod(line.substr(21, 21)); dUTC.push_back(A1);
-			double tUTC = stod(line.substr(42, 9)); dUTC.push_back(tUTC);
-			double week = stod(line.substr(51, line.length())); dUTC.push_back(week);
-			_header.dUTC = dUTC;
-		}
-		// Finding Leap Seconds
-		else if (found_LEAP != string::npos) {
-			_header.leap = stoi(line.substr(0, 6));
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
-	}
+	// Reading Header
+	readHeader(infile, [this](HeaderLabel label, string_view line) { navHeaderRecord(label, line); });
 
 	// Create GPS Navigation data holder
 	map<int, vector<Rinex2Nav::DataGPS>> mapGPS;
 
 	// Reading Navigation Data Body
+	RINEX_TIME(TIME_TOKENIZE);
 	while (!infile.eof()) {
 		line.clear();
 		// Temporarily store line from input file
-		getline(infile, line, '\n'); nlines++;
+		readLine(infile, line); nlines++;
 		if (line.find_first_not_of(' ') == std::string::npos) { continue; }
-		// Adjust line spaces before adding to block
-		if (nlines != 1) {
-			line = line.substr(3, line.length());
-		}
 		block.push_back(line);
 		// New block of navigation message
 		if (nlines == 8) {
 			// Now we must process the block of lines
 			Rinex2Nav::DataGPS GPS = epochNavOrganizer(block);
 			block.clear(); nlines = 0;
+			RINEX_TIME(TIME_ORGANIZE);
+			RINEX_COUNT(COUNT_NAV_RECORDS, 1);
 			// Add organized data to data holder
 			// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
 			// Else add new PRN as key and GPS data structure as Value
@@ -11,6 +11,8 @@
 #include "pch.h"
 #include "StringUtils.h"
 #include "TimeUtils.h"
+#include "RinexHeader.h"
+#include <type_traits>
 
 #ifndef RINEX2NAV_H_
 #define RINEX2NAV_H_
@@ -37,11 +39,12 @@ public:
 	// NOTE : Naming convention based on RINEX Manual
 	// i.e. Switching between upper/lowercase is deliberate
 
+	// Plain fixed size structure (trivially copyable), stored contiguously per satellite
 	struct DataGPS {
 		bool isAvailable;
 		int PRN;
-		std::vector<double> epochInfo;
-		double gpsTime;
+		// Epoch of the record (time of clock) in the GPS time scale
+		GpsTime gpsTime;
 		double clockBias;
 		double clockDrift;
 		double clockDriftRate;
@@ -63,7 +66,7 @@ public:
 		double Omega_dot;
 		double IDOT;
 		double L2_codes_channel;
-		double GPS_week;
+		int GPS_week;
 		double L2_P_data_flag;
 		double svAccuracy;
 		double svHealth;
@@ -78,11 +81,14 @@ public:
 	std::map<int, std::vector<Rinex2Nav::DataGPS>> _navDataGPS;
 
 	// Functions
-	void readNav(std::ifstream& inputNavfileGPS);
-	int EpochMatcher(double obsTime, std::vector<Rinex2Nav::DataGPS> NAV);
+	void readNav(std::istream& inputNavfileGPS);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex2Nav::DataGPS>& NAV);
 
 private:
+	void navHeaderRecord(HeaderLabel label, std::string_view line);
 
 };
 
+static_assert(std::is_trivially_copyable<Rinex2Nav::DataGPS>::value, "GPS ephemeris must stay trivially copyable");
+
 #endif /* RINEX2NAV_H_ */
@@ -7,238 +7,134 @@
 
 #include "pch.h"
 #include "Rinex2Obs.h"
+#include "FieldParser.h"
+#include "Instrumentation.h"
 
 using namespace std;
 
 // CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
-Rinex2Obs::Rinex2Obs() {}
+Rinex2Obs::Rinex2Obs() { clearObs(); }
 Rinex2Obs::~Rinex2Obs() {}
 
 // A function to organize specific observation type (for ex: prn - > pseudorange map) 
 // PRN - > Pseudorange Map is used for satellite position
-map<int, double> Rinex2Obs::specificObsMapper(map<int, vector<double>> _obsGPS, vector<string> obsTypes, string specificObs) {
+map<int, double> Rinex2Obs::specificObsMapper(const ObsMatrix& obsGPS, const vector<string>& obsTypes, const string& specificObs) {
 	map<int, double> rangeMap;
-	map<int, vector<double>>::iterator it = _obsGPS.begin();
 	size_t ind = std::find(obsTypes.begin(), obsTypes.end(), specificObs) - obsTypes.begin();
-	if (ind >= obsTypes.size()) {
+	if (ind >= obsTypes.size() || static_cast<int>(ind) >= obsGPS.nTypes()) {
 		cout << "Requested C1 Observation is Unavailable" << endl;
 	}
-	else if (ind < obsTypes.size()) {
-		for (it = _obsGPS.begin(); it != _obsGPS.end(); ++it) {
-			rangeMap.insert(std::pair<int, double>(it->first, it->second.at(ind)));
+	else {
+		for (int row = 0; row < obsGPS.nSats(); row++) {
+			rangeMap.insert(std::pair<int, double>(obsGPS.prn(row), obsGPS.value(row, static_cast<int>(ind))));
 		}
 	}
 	return rangeMap;
 }
 
-// This function extracts and stores the header information from Rinex v3 File
-void Rinex2Obs::obsHeader(ifstream& infile) {
-	// String tokens to look for
-	const string sTokenVER = "RINEX VERSION / TYPE";
-	const string sTokenPOS = "APPROX POSITION XYZ";
-	const string sTokenDEL = "ANTENNA: DELTA";
-	const string sTokenOBS = "# / TYPES OF OBSERV";
-	const string sTokenCOM = "COMMENT";
-	const string sTokenFIR = "TIME OF FIRST OBS";
-	const string sTokenLAS = "TIME OF LAST OBS";
-	const string sTokenEND = "END OF HEADER";
-	// A vector to hold block of sentences pertaining to observation types
-	vector<string> types;
-	// To hold contents of a line from input file
-	string line;
+// Handles a single header line
+void Rinex2Obs::obsHeaderRecord(HeaderLabel label, string_view line) {
+	if (obsHeaderCommon(label, line, _header)) { return; }
+	// Types of Observations, I6,9(4X,A2)
+	// More than 9 types continue on lines with a blank count
+	if (label == HDR_TYPES_OF_OBSERV) {
+		if (!isBlankField(line, 0, 6)) {
+			_header.nObsTypes = intField(line, 0, 6);
+			_header.obsTypes.clear();
+		}
+		for (size_t col = 10; col + 2 <= 60 && col < line.size(); col += 6) {
+			string_view code = textField(line, col, 2);
+			if (!code.empty()) { _header.obsTypes.emplace_back(code); }
+		}
+		_obsTypesGPS = _header.obsTypes;
+		_header.columns.setTypes(_header.obsTypes);
+		_obsDataGPS.observations.setTypes(static_cast<int>(_header.obsTypes.size()));
+	}
+}
 
-	// Reading line by line...
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_VER = line.find(sTokenVER);
-		size_t found_POS = line.find(sTokenPOS);
-		size_t found_DEL = line.find(sTokenDEL);
-		size_t found_OBS = line.find(sTokenOBS);
-		size_t found_COM = line.find(sTokenCOM);
-		size_t found_FIR = line.find(sTokenFIR);
-		size_t found_LAS = line.find(sTokenLAS);
-		size_t found_END = line.find(sTokenEND);
+// This function extracts and stores the header information from Rinex v2 File
+void Rinex2Obs::obsHeader(istream& infile) {
+	readHeader(infile, [this](HeaderLabel label, string_view line) { obsHeaderRecord(label, line); });
+}
 
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// RINEX Version
-		else if (found_VER != string::npos) {
-			istringstream iss(line);
-			// Rinex type should be stored in 4th word of line
-			vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-			_header.rinexType = words[3];
-			words.clear();
-		}
-		// Approximate Position
-		else if (found_POS != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_header.approxPosXYZ));
-			// Adding a term for Clock Offset
-			_header.approxPosXYZ.push_back(0);
-		}
-		// Antenna Delta
-		else if (found_DEL != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_header.antDeltaHEN));
-		}
-		// Types of Observations
-		else if (found_OBS != string::npos) {
-			// Removing identifier from block of lines
-			eraseSubStr(line, sTokenOBS);
-			// Sepearate words from line and add to vector
-			istringstream iss(line);
-			vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-			_header.nObsTypes = stoi(words[0]);
-			for (int i = 1; i < (int)words.size(); i++) {
-				_header.obsTypes.push_back(words[i]);
-			}
-			_obsTypesGPS = _header.obsTypes;
-		}
-		// Time of First Obs
-		else if (found_FIR != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_header.firstObsTime));
-		}
-		// Time of Last Obs
-		else if (found_LAS != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_header.lastObsTime));
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
-	}
+// Extracts and stores the header information from a memory mapped Rinex v2 File
+// The text view is advanced to the first line after the header
+void Rinex2Obs::obsHeader(string_view& text) {
+	readHeader(text, [this](HeaderLabel label, string_view line) { obsHeaderRecord(label, line); });
 }
 
-// Splits Epoch Information
-vector<double> rinex2EpochRecordOrganizer(string line) {
-	line = line.substr(0, 26);
-	vector<double> epochRecord;
-	// Splitting words in the line
-	istringstream iss(line);
-	vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-	for (string s : words) {
-		epochRecord.push_back(stod(s));
-	}
-	// Return: Vector containing the Epoch Info
-	return epochRecord;
+// Recognizes an epoch line from its fixed layout
+//  yy mm dd hh mm ss.sssssss  f nnn
+// Observation lines (F14.3) can never have the seconds decimal point at column 19
+bool Rinex2Obs::isEpochLine(string_view line) {
+	if (line.size() < 32) { return false; }
+	return line[3] == ' ' && line[6] == ' ' && line[9] == ' ' && line[12] == ' ' &&
+		line[18] == '.' && line[28] >= '0' && line[28] <= '9';
 }
 
-// Splits PRN Information
-vector<int> rinex2SatOrganizer(string line) {
-	vector<int> sats;
-	string word;
-	for (unsigned i = 0; i < line.length(); i += 3) {
-		word = line.substr(i, 3);
-		if (word.find_first_not_of(' ') == string::npos) {
-			word = "0"; continue;
-		}
-		word = replaceChars(word, 'G', ' ');
-		sats.push_back(stoi(word));
-		word.clear();
+// Splits Epoch Information from its fixed columns
+//  yy mm dd hh mm ss.sssssss  f nnn
+void rinex2EpochRecordOrganizer(string_view line, vector<double>& epochRecord) {
+	RINEX_TIME(TIME_CONVERT);
+	static const size_t cols[][2] = { {1, 2}, {4, 2}, {7, 2}, {10, 2}, {13, 2}, {15, 11} };
+	epochRecord.clear();
+	for (const auto& col : cols) {
+		if (isBlankField(line, col[0], col[1])) { continue; }
+		epochRecord.push_back(floatField(line, col[0], col[1]));
+	}
+}
 
+// Splits PRN Information, satellites are listed as 12 fields of A1,I2
+void rinex2SatOrganizer(string_view line, vector<int>& sats) {
+	RINEX_TIME(TIME_CONVERT);
+	for (size_t i = 0; i < line.size(); i += 3) {
+		if (isBlankField(line, i, 3)) { continue; }
+		sats.push_back(intField(line, i + 1, 2));
 	}
-	return sats;
+}
+
+// Number of lines a satellite takes up in an epoch, 5 observations per line
+int rinex2LinesPerSat(int nObsTypes) {
+	return (nObsTypes > 5) ? (nObsTypes + 4) / 5 : 1;
 }
 
 // Epoch Satellite Observation Data Organizer
-void rinex2ObsOrganizer(vector<string> block, vector<int> satellites, int nObsTypes, map<int, vector<double>>& mapSatObs, map<int, vector<int>>& mapObsLLI, map<int, vector<int>>& mapObsSS) {
-	// If nObsTypes is more than 5, observations take up two lines per satellite
-	vector<string> nBlock;
-	if (nObsTypes > 5) {
-		for (int i = 0; i < (int)block.size(); i++) {
-			string line = block[i]; i++;
-			line = line + block[i];
-			nBlock.push_back(line);
-		}
-	}
-	else {
-		nBlock = block;
-	}
-	// Create Observation Data Holder
-	// prn -> vector of observations
-	mapSatObs.clear(); mapObsLLI.clear(); mapObsSS.clear();
-	for (int j = 0; j < (int)nBlock.size(); j++) {
-		vector<double> OBS;
-		vector<int> LLI;
-		vector<int> SS;
-		string obsTok; string lliTok; string ssTok;
-		string line = nBlock[j];
-		for (unsigned i = 0; i < line.length(); i += 16) {
-			if (line.length() <= (i + 14)) {
-				obsTok = line.substr(i, line.length() - i);
-				lliTok = "0";
-				ssTok = "0";
-			}
-			else {
-				obsTok = line.substr(i, 14);
-				lliTok = line.substr(i + 14, 1);
-				ssTok = line.substr(i + 15, 1);
-			}
-			if (obsTok.find_first_not_of(' ') == string::npos) { obsTok = "0"; }
-			OBS.push_back(stod(obsTok));
-			obsTok.clear();
-			if (lliTok.find_first_not_of(' ') == string::npos) { lliTok = "0"; }
-			LLI.push_back(stoi(lliTok));
-			lliTok.clear();
-			if (ssTok.find_first_not_of(' ') == string::npos) { ssTok = "0"; }
-			SS.push_back(stoi(ssTok));
-			ssTok.clear();
-		}
-		mapSatObs.insert(make_pair(satellites[j], OBS));
-		mapObsLLI.insert(make_pair(satellites[j], LLI));
-		mapObsSS.insert(make_pair(satellites[j], SS));
+// Organizes one line of a satellite record, line part p holds observation types 5p to 5p+4
+void rinex2ObsOrganizer(string_view line, int part, int row, ObsMatrix& matrix) {
+	RINEX_TIME(TIME_CONVERT);
+	double* values = matrix.values(row);
+	unsigned char* lli = matrix.lli(row);
+	unsigned char* ss = matrix.ss(row);
+	int kEnd = min(matrix.nTypes(), 5 * part + 5);
+	for (int k = 5 * part; k < kEnd; k++) {
+		// Each observation is F14.3 followed by the LLI and signal strength digits
+		size_t col = (k % 5) * 16;
+		values[k] = floatField(line, col, 14);
+		lli[k] = static_cast<unsigned char>(intField(line, col + 14, 1));
+		ss[k] = static_cast<unsigned char>(intField(line, col + 15, 1));
 	}
 }
 
 // This function extracts and stores epochwise observations from file
-void Rinex2Obs::obsEpoch(ifstream& infile, ofstream& logfile, int nObsTypes) {
+void Rinex2Obs::obsEpoch(istream& infile, ofstream& logfile, int nObsTypes) {
 	// Rinex v2 special identifier for new epoch of observations
 	const string sTokenEpoch = "G";
 	const string sTokenCOM = "COMMENT";
-	// Collect the block of observation lines into a vector
-	streampos pos;
-	string line;
-	vector<string> block;
+	RINEX_TIME(TIME_TOKENIZE);
+	// Lines are organized as they are read, straight into the epoch storage
+	string& line = _line;
 	int nLines = 0, bLines = 0;
+	int nLinesSat = rinex2LinesPerSat(nObsTypes);
+	ObsMatrix& matrix = _obsDataGPS.observations;
+	if (matrix.nTypes() != nObsTypes) { matrix.setTypes(nObsTypes); }
+	matrix.clear();
 	// Reading line by line...
-
-	while (!(infile >> std::ws).eof()) {
-		// *** Deal with end of file error
-		if (infile.fail()) { break; }
-		// *** 
-		line.clear();
-		pos = infile.tellg();
-		// Temporarily store line from input file
-		getline(infile, line);
-
-		// Taking care of line length
-		size_t lsize = line.size();
-		size_t bsize = 0;
-		if (lsize < 80) {
-			bsize = 80 - lsize;
-			string blanks(bsize, ' ');
-			line = line + blanks;
-		}
-
-		// Taking care of empty lines within obs epoch
+	// Leading blanks are significant in observation lines, so they are not skipped
+	while (readLine(infile, line)) {
+		if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+		// Taking care of empty lines, within an epoch they stand for missing observations
 		if (line.find_first_not_of(' ') == string::npos) {
-			string blanks(80, ' ');
-			block.push_back(blanks);
+			if (bLines == 0) { continue; }
 			nLines++;
 			if (nLines == bLines) { break; }
 			continue;
@@ -248,72 +144,109 @@ void Rinex2Obs::obsEpoch(ifstream& infile, ofstream& logfile, int nObsTypes) {
 		size_t found_ID = line.find(sTokenEpoch);
 		size_t found_COM = line.find(sTokenCOM);
 		if ((found_COM != string::npos)) { continue; }
-		if ((found_ID != string::npos)) {
-			if (block.size() == 0) {
-				// Extract Epoch Information 
-				_obsDataGPS.epochRecord = rinex2EpochRecordOrganizer(line);
-				// Determine if PRN info carries to next line based on nObsTypes
-				string tokSats = line.substr(29, 3);
-				_obsDataGPS.nSats = stoi(tokSats);
-				// Store Receiver Clock Offset if available
-				string rco = "0";
-				if (line.length() == 80) {
-					rco = line.substr(68, 12);
-					if (rco.find_first_not_of(' ') == string::npos) {
-						rco = "0";
-					}
-				}
-				_obsDataGPS.recClockOffset = stod(rco);
-				// Read next line if necessary (PRN info carries to next line)
-				line = line.substr(32, 36);
-				if (_obsDataGPS.nSats > 12) {
-					string line2;
-					getline(infile, line2, '\n');
-					line2 = line2.substr(32, 36);
-					line = line + line2;
-				}
-				// Create vector of PRN's in current epoch
-				_obsDataGPS.sats = rinex2SatOrganizer(line);
-				// Number of possible lines in epoch block
-				bLines = _obsDataGPS.nSats;
-				if (nObsTypes > 5) { bLines = bLines * 2; }
+		if (bLines == 0) {
+			if (found_ID == string::npos) { continue; }
+			// The caller may have skipped leading blanks of the epoch line,
+			// the satellite list always starts at column 33 so realign on it
+			size_t found_SAT = line.find_first_of("GRESJCI");
+			if (found_SAT < 32) { line.insert(0, 32 - found_SAT, ' '); }
+			// Event flags above 1 are followed by special records instead of observations
+			if (intField(line, 28, 1) > 1) {
+				for (int n = intField(line, 29, 3); n > 0 && readLine(infile, line); n--) {}
+				continue;
 			}
+			// Extract Epoch Information
+			rinex2EpochRecordOrganizer(line, _obsDataGPS.epochRecord);
+			_obsDataGPS.nSats = intField(line, 29, 3);
+			// Store Receiver Clock Offset if available
+			_obsDataGPS.recClockOffset = floatField(line, 68, 12);
+			// Create vector of PRN's in current epoch
+			// PRN info carries to continuation lines when there are more than 12 satellites
+			_obsDataGPS.sats.clear();
+			rinex2SatOrganizer(string_view(line).substr(32, 36), _obsDataGPS.sats);
+			for (int n = 12; n < _obsDataGPS.nSats && readLine(infile, line); n += 12) {
+				if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+				if (line.size() > 32) { rinex2SatOrganizer(string_view(line).substr(32, 36), _obsDataGPS.sats); }
+			}
+			// One row per satellite, filled as the lines come in
+			{
+				RINEX_TIME(TIME_ORGANIZE);
+				for (int prn : _obsDataGPS.sats) { matrix.addSat(prn); }
+				RINEX_COUNT(COUNT_SATELLITES, matrix.nSats());
+			}
+			// Number of possible lines in epoch block
+			bLines = matrix.nSats() * nLinesSat;
+			if (bLines == 0) { break; }
 		}
 		else {
-			if (bLines == 0) { continue; }
-			block.push_back(line);
+			rinex2ObsOrganizer(line, nLines % nLinesSat, nLines / nLinesSat, matrix);
 			nLines++;
 			if (nLines == bLines) { break; }
 		}
 	}
-	// Now we must process the block of lines
-	map<int, vector<double>> mapSatObs;
-	map<int, vector<int>> mapObsLLI;
-	map<int, vector<int>> mapObsSS;
-	rinex2ObsOrganizer(block, _obsDataGPS.sats, nObsTypes, mapSatObs, mapObsLLI, mapObsSS);
-	_obsDataGPS.observations = mapSatObs;
-	_obsDataGPS.LLI = mapObsLLI;
-	_obsDataGPS.SS = mapObsSS;
 	_obsDataGPS.gpsTime = gpsTime(_obsDataGPS.epochRecord);
-	_obsGPS = _obsDataGPS.observations;
+	if (!_obsDataGPS.epochRecord.empty()) { RINEX_COUNT(COUNT_EPOCHS, 1); }
+}
+
+// This function extracts and stores epochwise observations from a memory mapped file
+// Fields are parsed directly from the mapped bytes, the text view is advanced past the epoch
+// Returns false once no more epochs are available
+bool Rinex2Obs::obsEpoch(string_view& text, int nObsTypes) {
+	const string_view sTokenCOM = "COMMENT";
+	RINEX_TIME(TIME_TOKENIZE);
+	int nLinesSat = rinex2LinesPerSat(nObsTypes);
+	ObsMatrix& matrix = _obsDataGPS.observations;
+	if (matrix.nTypes() != nObsTypes) { matrix.setTypes(nObsTypes); }
+	string_view line;
+	while (nextLine(text, line)) {
+		// Look for the next epoch line
+		if (!isEpochLine(line)) { continue; }
+		clearObs();
+		int nSats = intField(line, 29, 3);
+		// Event flags above 1 are followed by special records instead of observations
+		if (intField(line, 28, 1) > 1) {
+			for (int i = 0; i < nSats && nextLine(text, line); i++) {}
+			continue;
+		}
+		// Extract Epoch Information
+		rinex2EpochRecordOrganizer(line, _obsDataGPS.epochRecord);
+		_obsDataGPS.nSats = nSats;
+		_obsDataGPS.recClockOffset = floatField(line, 68, 12);
+		// Create vector of PRN's in current epoch, continued on the next lines past 12 satellites
+		rinex2SatOrganizer(line.substr(32, 36), _obsDataGPS.sats);
+		for (int n = 12; n < nSats && nextLine(text, line); n += 12) {
+			if (line.size() > 32) { rinex2SatOrganizer(line.substr(32, 36), _obsDataGPS.sats); }
+		}
+		{
+			RINEX_TIME(TIME_ORGANIZE);
+			for (int prn : _obsDataGPS.sats) { matrix.addSat(prn); }
+			RINEX_COUNT(COUNT_SATELLITES, matrix.nSats());
+		}
+		// Organize satellite observations, comment lines do not count towards the epoch block
+		int bLines = matrix.nSats() * nLinesSat;
+		for (int n = 0; n < bLines && nextLine(text, line); ) {
+			if (line.find(sTokenCOM) != string_view::npos) { continue; }
+			rinex2ObsOrganizer(line, n % nLinesSat, n / nLinesSat, matrix);
+			n++;
+		}
+		_obsDataGPS.gpsTime = gpsTime(_obsDataGPS.epochRecord);
+		RINEX_COUNT(COUNT_EPOCHS, 1);
+		return true;
+	}
+	return false;
 }
 
 // To clear contents in observation data structure
 void Rinex2Obs::clearObs() {
 	_obsDataGPS.epochRecord.clear();
-	_obsDataGPS.gpsTime = NULL;
-	_obsDataGPS.nSats = NULL;
+	_obsDataGPS.gpsTime = GpsTime();
+	_obsDataGPS.nSats = 0;
 	_obsDataGPS.observations.clear();
-	_obsDataGPS.recClockOffset = NULL;
+	_obsDataGPS.recClockOffset = 0;
 	_obsDataGPS.sats.clear();
 }
 
 // To clear contents in _header data structure
 void Rinex2Obs::clearHeader() {
-	_header.antDeltaHEN.clear();
-	_header.approxPosXYZ.clear();
-	_header.firstObsTime.clear();
-	_header.lastObsTime.clear();
-	_header.obsTypes.clear();
-	_header.rinexType.clear();
+	_header = ObsHeaderInfo();
 }
@@ -10,6 +10,9 @@
 #include "pch.h"
 #include "TimeUtils.h"
 #include "StringUtils.h"
+#include "ObsMatrix.h"
+#include "ObsCode.h"
+#include "RinexHeader.h"
 
 #ifndef RINEX2OBS_H_
 #define RINEX2OBS_H_
@@ -24,25 +27,22 @@ public:
 
 	// Data Structures
 	// To store important header information
-	struct ObsHeaderInfo {
-		std::string rinexType;
-		std::vector<double> approxPosXYZ;
-		std::vector<double> antDeltaHEN;
-		std::vector<double> firstObsTime;
-		std::vector<double> lastObsTime;
+	struct ObsHeaderInfo : ObsHeaderCommon {
 		std::vector<std::string> obsTypes;
-		int nObsTypes;
+		// Column of each observation code, built with obsTypes
+		ObsCodeTable columns;
+		int nObsTypes = 0;
 	}; 
 	// To store observations in an epoch
+	// Storage is flat and reused from epoch to epoch
 	struct ObsEpochInfo {
 		std::vector<double> epochRecord;
 		double recClockOffset;
-		double gpsTime;
+		GpsTime gpsTime;
 		int nSats;
 		std::vector<int> sats;
-		std::map<int, std::vector<double>> observations;
-		std::map<int, std::vector<int>> LLI; // LLI Flag
-		std::map<int, std::vector<int>> SS; // Signal Strength
+		// Dense [satellite x observation type] matrix, also holding LLI flags and signal strengths
+		ObsMatrix observations;
 	}; 
 
 	// Attributes
@@ -50,16 +50,24 @@ public:
 	ObsEpochInfo _obsDataGPS;
 
 	std::vector<std::string> _obsTypesGPS;
-	std::map<int, std::vector<double>> _obsGPS;
 
 	// Functions
 	void clearObs();
 	void clearHeader();
-	void obsHeader(std::ifstream& infile);
-	void obsEpoch(std::ifstream& infile, std::ofstream& logfile, int nObsTypes);
-	std::map<int, double> Rinex2Obs::specificObsMapper(std::map<int, std::vector<double>> obsGPS, std::vector<std::string> obsTypes, std::string specificObs);
+	void obsHeader(std::istream& infile);
+	void obsEpoch(std::istream& infile, std::ofstream& logfile, int nObsTypes);
+	// * Memory mapped mode, text is a view over a MappedFile and is advanced while reading
+	void obsHeader(std::string_view& text);
+	bool obsEpoch(std::string_view& text, int nObsTypes);
+	static bool isEpochLine(std::string_view line);
+	// Copies one observation type into a map, per epoch work should look the column up once in
+	// _header.columns and read ObsMatrix::column() instead
+	std::map<int, double> specificObsMapper(const ObsMatrix& obsGPS, const std::vector<std::string>& obsTypes, const std::string& specificObs);
 
 private:
+	void obsHeaderRecord(HeaderLabel label, std::string_view line);
+	// Line buffer reused between epochs
+	std::string _line;
 
 };
 
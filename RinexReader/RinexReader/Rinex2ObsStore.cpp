@@ -0,0 +1,71 @@
+/*
+* Rinex2ObsStore.cpp
+* Loads a whole Rinex v2 observation file into a columnar ObsStore
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex2ObsStore.h"
+#include "InputStream.h"
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+Rinex2ObsStore::Rinex2ObsStore() {}
+Rinex2ObsStore::~Rinex2ObsStore() {}
+
+// Reads the file epoch by epoch and transposes the observations into columns
+// Rinex v2 files handled here are GPS only, they may be compressed (.gz, .Z, Compact Rinex)
+bool Rinex2ObsStore::load(const string& filename) {
+	InputStream fin(filename);
+	if (!fin.is_open()) { return false; }
+	clear();
+	Rinex2Obs OBS;
+	ofstream nolog;
+	// Header lines are kept for the cache, then parsed
+	_headerText.clear();
+	readHeader(fin, [this](HeaderLabel, string_view line) { _headerText.append(line).append("\n"); });
+	string_view text(_headerText);
+	OBS.obsHeader(text);
+	_header = OBS._header;
+	setTypes(SYS_GPS, _header.obsTypes);
+	while (!(fin >> std::ws).eof()) {
+		if (fin.fail()) { break; }
+		OBS.clearObs();
+		OBS.obsEpoch(fin, nolog, _header.nObsTypes);
+		if (OBS._obsDataGPS.epochRecord.empty()) { break; }
+		addEpoch(OBS._obsDataGPS.gpsTime, OBS._obsDataGPS.recClockOffset);
+		addObservations(SYS_GPS, OBS._obsDataGPS.observations);
+	}
+	finish();
+	return true;
+}
+
+// Reads the cache if it still matches the file
+bool Rinex2ObsStore::loadCached(const string& filename, const string& cacheFile) {
+	string cachePath = cacheFile.empty() ? defaultCacheFile(filename) : cacheFile;
+	CacheReader reader;
+	if (reader.open(cachePath, filename, CACHE_OBS2) && loadCache(reader) && loadHeader(reader)) { return true; }
+	if (!load(filename)) { return false; }
+	// A cache that cannot be written only costs the next run a parse
+	CacheWriter writer(CACHE_OBS2);
+	saveCache(writer);
+	saveHeader(writer);
+	writer.write(cachePath, filename);
+	return true;
+}
+
+// The header is kept as text and parsed again on loading
+void Rinex2ObsStore::saveHeader(CacheWriter& cache) const {
+	cache.add(SEC_OBS_HEADER, _headerText);
+}
+
+bool Rinex2ObsStore::loadHeader(const CacheReader& cache) {
+	if (!cache.get(SEC_OBS_HEADER, _headerText)) { return false; }
+	Rinex2Obs OBS;
+	string_view text(_headerText);
+	OBS.obsHeader(text);
+	_header = OBS._header;
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+/*
+* Rinex2ObsStore.h
+* Loads a whole Rinex v2 observation file into a columnar ObsStore
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ObsStore.h"
+#include "Rinex2Obs.h"
+
+#ifndef RINEX2OBSSTORE_H_
+#define RINEX2OBSSTORE_H_
+
+class Rinex2ObsStore : public ObsStore
+{
+public:
+	// CONSTRUCTOR
+	Rinex2ObsStore();
+	// DESTRUCTOR
+	~Rinex2ObsStore();
+
+	// Attributes
+	Rinex2Obs::ObsHeaderInfo _header;
+
+	// Functions
+	bool load(const std::string& filename);
+	// Loads the binary cache of the file when it is up to date, otherwise loads the file and writes the cache
+	bool loadCached(const std::string& filename, const std::string& cacheFile = "");
+
+private:
+	void saveHeader(CacheWriter& cache) const;
+	bool loadHeader(const CacheReader& cache);
+
+	// Header lines of the file, cached and parsed again so a cached store gets the same header
+	std::string _headerText;
+};
+
+#endif /* RINEX2OBSSTORE_H_ */
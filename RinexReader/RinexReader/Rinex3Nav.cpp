@@ -1,6 +1,6 @@
 /*
 * Rinex3Nav.h
-* Read and organize Rinex v3 ephemeris file in epochwise manner
+* Read and organize Rinex v3 and v4 ephemeris file in epochwise manner
 *  Created on: Jun 12, 2018
 *  Updated on: January 26, 2019
 *      Author: Aaron Boda
@@ -8,6 +8,10 @@
 
 #include "pch.h"
 #include "Rinex3Nav.h"
+#include "FieldParser.h"
+#include "Instrumentation.h"
+#include "BinaryCache.h"
+#include "InputStream.h"
 using namespace std;
 
 // CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
@@ -15,83 +19,106 @@ Rinex3Nav::Rinex3Nav() {}
 Rinex3Nav::~Rinex3Nav() {}
 
 // A function to help with organizing GPS header
-// Works for the alpha/beta ionospheric constants and time correction
-std::vector<double> headerHelperGPS(string line) {
-	line = line.substr(5, 55);
-	string word;
+// Works for the alpha/beta ionospheric constants (A4,1X,4D12.4)
+std::vector<double> headerHelperGPS(string_view line) {
 	vector<double> data;
-	for (unsigned i = 0; i < line.length(); i += 12) {
-		word = line.substr(i, 12);
-		if (word.find_first_not_of(' ') == std::string::npos) { continue; }
-		data.push_back(stod(replaceChars(word, 'D', 'e')));
-		word.clear();
+	for (size_t col = 5; col < 53; col += 12) {
+		if (isBlankField(line, col, 12)) { continue; }
+		data.push_back(floatField(line, col, 12));
 	}
 	return data;
 }
 
-// Organizes Epoch Time Information into Vector
-vector<double> rinex3EpochTimeOrganizer(string line) {
-	vector<double> epochRecord;
-	line = line.substr(3, 20);
-	// Splitting words in the line
-	istringstream iss(line);
-	vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-	for (string s : words) {
-		epochRecord.push_back(stod(s));
-	}
-	// Return: Vector containing the Epoch Info
-	return epochRecord;
+// A function to help with organizing the time system correction
+// a0, a1, reference time and week (A4,1X,D17.10,D16.9,I7,I5)
+std::vector<double> timeCorrHelper(string_view line) {
+	vector<double> data;
+	data.push_back(floatField(line, 5, 17));
+	data.push_back(floatField(line, 22, 16));
+	data.push_back(floatField(line, 38, 7));
+	data.push_back(floatField(line, 45, 5));
+	return data;
 }
 
-// Function to split and organize navigation parameters
-vector<double> rinex3NavDataSplitter(string line) {
-	// Split line every 19 spaces as allocated for parameters
-	vector<double> data;
-	string word;
-	for (unsigned i = 0; i < line.length(); i += 19) {
-		word = line.substr(i, 19);
-		if (word.find_first_not_of(' ') == std::string::npos) { continue; }
-		if (word.find('D') != std::string::npos) { data.push_back(stod(replaceChars(word, 'D', 'e'))); }
-		if (word.find('E') != std::string::npos) { data.push_back(stod(replaceChars(word, 'E', 'e'))); }
-		if (word.find('e') != std::string::npos) { data.push_back(stod(word)); }
-		else { continue; }
-		word.clear();
+// Organizes Epoch Time Information into an array of 6 values
+// SNN yyyy mm dd hh mm ss (A1,I2.2,1X,I4,5(1X,I2.2))
+void rinex3EpochTimeOrganizer(string_view line, double* epochRecord) {
+	static const size_t cols[][2] = { {4, 4}, {9, 2}, {12, 2}, {15, 2}, {18, 2}, {21, 2} };
+	for (size_t i = 0; i < 6; i++) {
+		epochRecord[i] = floatField(line, cols[i][0], cols[i][1]);
 	}
-	return data;
 }
 
-// Epoch Time Matcher, returns index of most appropriate Navigation vector
-int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGPS> NAV) {
-	// Initialize time difference variable using arbitrary large number
-	double diff = 1000000; int index = 0;
-	for (unsigned i = 0; i < NAV.size(); i++) {
-		double new_diff = fabs(obsTime - NAV.at(i).gpsTime);
-		if (new_diff < diff) {
-			diff = new_diff; // update difference
-			index = i; // save index
+// Week number of GPS and GALILEO records, 3rd parameter of the 6th line
+int rinex3NavWeek(const string* block) {
+	return static_cast<int>(lround(floatField(block[5], 42, 19)));
+}
+
+// Function to split and organize navigation parameters straight into their data structure
+// First line holds 3 parameters after the epoch, the others 4 (4X,4D19.12)
+// fields lists the member of each parameter in file order, null for those that are not kept or not floating point
+template <typename Data, size_t N>
+void rinex3NavDataSplitter(const string* block, size_t nLines, Data& data, double Data::* const (&fields)[N]) {
+	size_t n = 0;
+	for (size_t i = 0; i < nLines; i++) {
+		for (size_t col = (i == 0) ? 23 : 4; col < 80 && n < N; col += 19, n++) {
+			if (fields[n] != nullptr) { data.*fields[n] = floatField(block[i], col, 19); }
 		}
 	}
-	// Index of most appropriate Nav vector
-	return index;
 }
 
-// Epoch Time Matcher, returns index of most appropriate Navigation vector
-int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGLO> NAV) {
-	// Initialize time difference variable using arbitrary large number
-	double diff = 1000000; int index = 0;
-	for (unsigned i = 0; i < NAV.size(); i++) {
-		double new_diff = fabs(obsTime - NAV.at(i).gpsTime);
-		if (new_diff < diff) {
-			diff = new_diff; // update difference
-			index = i; // save index
+// Number of lines of a navigation record from its constellation identifier
+// State vector records (GLONASS, SBAS) take 4 lines, the others (GPS, GALILEO, BDS, QZSS, NavIC) take 8
+// Rinex 3.05 adds a 5th line to GLONASS records (status flags, L1/L2 group delay, URAI, health flags)
+size_t navRecordLines(char ID, double version) {
+	if (ID == 'R') { return (version >= 3.05) ? 5 : 4; }
+	return (ID == 'S') ? 4 : 8;
+}
+
+// First line of a record, identified by its constellation in column 0, continuation lines start with blanks
+static bool isNavRecordStart(const string& line) {
+	static const string systems = "GRECJSI";
+	return !line.empty() && systems.find(line[0]) != string::npos;
+}
+
+// Reads the next navigation record into block, which must hold 8 lines
+// Blank lines between records are skipped, leading blanks are part of the fixed columns
+// Lines that do not start a record (an unknown constellation and its lines) are skipped up to the next one,
+// and a record cut short by the start of the next one is dropped, so one bad record cannot shift the others
+// The strings are reused from one record to the next, so their buffers are allocated only once
+bool readNavRecord(std::istream& infile, string* block, double version) {
+	do {
+		if (!readLine(infile, block[0])) { return false; }
+	} while (!isNavRecordStart(block[0]));
+	size_t nLines = navRecordLines(block[0][0], version);
+	for (size_t i = 1; i < nLines; i++) {
+		if (!readLine(infile, block[i])) {
+			RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+			return false;
+		}
+		if (isNavRecordStart(block[i])) {
+			RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+			swap(block[0], block[i]);
+			nLines = navRecordLines(block[0][0], version);
+			i = 0;
 		}
 	}
-	// Index of most appropriate Nav vector
-	return index;
+	return true;
+}
+
+// Appends an empty record for a PRN and returns it to be filled in place
+template <typename Data>
+Data& newNavRecord(map<int, vector<Data>>& nav, int prn) {
+	RINEX_TIME(TIME_ORGANIZE);
+	RINEX_COUNT(COUNT_NAV_RECORDS, 1);
+	vector<Data>& records = nav[prn];
+	records.emplace_back();
+	return records.back();
 }
 
 // Epoch Time Matcher, returns index of most appropriate Navigation vector
-int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGAL> NAV) {
+template <typename Data>
+static int epochMatcher(GpsTime obsTime, const vector<Data>& NAV) {
 	// Initialize time difference variable using arbitrary large number
 	double diff = 1000000; int index = 0;
 	for (unsigned i = 0; i < NAV.size(); i++) {
@@ -104,573 +131,833 @@ int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGAL> NAV)
 	// Index of most appropriate Nav vector
 	return index;
 }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGPS>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGLO>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGAL>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataBDS>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataSBS>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataCNAV>& NAV) { return epochMatcher(obsTime, NAV); }
+int Rinex3Nav::EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataBDSCNAV>& NAV) { return epochMatcher(obsTime, NAV); }
+
+// Handles a single header line, the same for every file type so mixed files get all of it
+void Rinex3Nav::navHeaderRecord(HeaderLabel label, string_view line) {
+	switch (label) {
+	case HDR_VERSION:
+		_version = floatField(line, 0, 9);
+		break;
+	// Ionospheric constants as per new format
+	case HDR_IONOSPHERIC_CORR: {
+		string_view type = textField(line, 0, 4);
+		if (type == "GPSA") { _headerGPS.ialpha = headerHelperGPS(line); }
+		else if (type == "GPSB") { _headerGPS.ibeta = headerHelperGPS(line); }
+		break;
+	}
+	// GPS to UTC Time Correction
+	case HDR_TIME_SYSTEM_CORR:
+		if (textField(line, 0, 4) == "GPUT") { _headerGPS.GPUT = timeCorrHelper(line); }
+		break;
+	// Reference year, month, day and correction (3I6,3X,D19.12)
+	case HDR_CORR_TO_SYSTEM_TIME:
+		_headerGLO.TimeCorr.push_back(floatField(line, 0, 6));
+		_headerGLO.TimeCorr.push_back(floatField(line, 6, 6));
+		_headerGLO.TimeCorr.push_back(floatField(line, 12, 6));
+		_headerGLO.TimeCorr.push_back(floatField(line, 21, 19));
+		break;
+	case HDR_LEAP_SECONDS:
+		_headerGLO.leapSec = intField(line, 0, 6);
+		_headerGAL.leapSec = _headerGLO.leapSec;
+		break;
+	default:
+		break;
+	}
+}
+
+// Navigation parameters of the GPS record in file order, the week is an integer and is read separately
+static double Rinex3Nav::DataGPS::* const NAV_FIELDS_GPS[29] = {
+	&Rinex3Nav::DataGPS::clockBias, &Rinex3Nav::DataGPS::clockDrift, &Rinex3Nav::DataGPS::clockDriftRate,
+	&Rinex3Nav::DataGPS::IODE, &Rinex3Nav::DataGPS::Crs, &Rinex3Nav::DataGPS::Delta_n, &Rinex3Nav::DataGPS::Mo,
+	&Rinex3Nav::DataGPS::Cuc, &Rinex3Nav::DataGPS::Eccentricity, &Rinex3Nav::DataGPS::Cus, &Rinex3Nav::DataGPS::Sqrt_a,
+	&Rinex3Nav::DataGPS::TOE, &Rinex3Nav::DataGPS::Cic, &Rinex3Nav::DataGPS::OMEGA, &Rinex3Nav::DataGPS::CIS,
+	&Rinex3Nav::DataGPS::Io, &Rinex3Nav::DataGPS::Crc, &Rinex3Nav::DataGPS::Omega, &Rinex3Nav::DataGPS::Omega_dot,
+	&Rinex3Nav::DataGPS::IDOT, &Rinex3Nav::DataGPS::L2_codes_channel, nullptr,
+	&Rinex3Nav::DataGPS::L2_P_data_flag, &Rinex3Nav::DataGPS::svAccuracy, &Rinex3Nav::DataGPS::svHealth,
+	&Rinex3Nav::DataGPS::TGD, &Rinex3Nav::DataGPS::IODC, &Rinex3Nav::DataGPS::transmission_time,
+	&Rinex3Nav::DataGPS::fit_interval
+};
 
 // Navigation Body Organizer for GPS Navigation File
-Rinex3Nav::DataGPS epochNavOrganizerGPS(vector<string> block) {
-	string sys = block[0].substr(0, 1);
-	int prn = stoi(block[0].substr(1, 2));
-	vector<double> epochInfo = rinex3EpochTimeOrganizer(block[0]);
-	string line = block[0].substr(23, block[0].length());
-	for (unsigned int i = 1; i < block.size(); i++) {
-		line = line + block[i]; 
-	}
-	vector<double> parameters = rinex3NavDataSplitter(line);
-	// Storing Values into GPS Data Structure
-	Rinex3Nav::DataGPS GPS;
+void epochNavOrganizerGPS(const string* block, Rinex3Nav::DataGPS& GPS) {
+	RINEX_TIME(TIME_CONVERT);
 	GPS.isAvailable = true;
-	GPS.PRN = prn;
-	GPS.epochInfo = epochInfo;
+	GPS.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
 	GPS.gpsTime = gpsTime(epochInfo);
-	GPS.clockBias = parameters.at(0);
-	GPS.clockDrift = parameters.at(1);
-	GPS.clockDriftRate = parameters.at(2);
-	GPS.IODE = parameters.at(3); 
-	GPS.Crs = parameters.at(4); 
-	GPS.Delta_n = parameters.at(5); 
-	GPS.Mo = parameters.at(6); 
-	GPS.Cuc = parameters.at(7);
-	GPS.Eccentricity = parameters.at(8); 
-	GPS.Cus = parameters.at(9); 
-	GPS.Sqrt_a = parameters.at(10); 
-	GPS.TOE = parameters.at(11);
-	GPS.Cic = parameters.at(12);
-	GPS.OMEGA = parameters.at(13); 
-	GPS.CIS = parameters.at(14); 
-	GPS.Io = parameters.at(15);
-	GPS.Crc = parameters.at(16);
-	GPS.Omega = parameters.at(17);
-	GPS.Omega_dot = parameters.at(18); 
-	GPS.IDOT = parameters.at(19);
-	GPS.L2_codes_channel = parameters.at(20);
-	GPS.GPS_week = parameters.at(21);
-	GPS.L2_P_data_flag = parameters.at(22); 
-	GPS.svAccuracy = parameters.at(23);
-	GPS.svHealth = parameters.at(24);
-	GPS.TGD = parameters.at(25);
-	GPS.IODC = parameters.at(26);
-	GPS.transmission_time = parameters.at(27);
-	GPS.fit_interval = parameters.at(28);
-	return GPS;
+	rinex3NavDataSplitter(block, 8, GPS, NAV_FIELDS_GPS);
+	GPS.GPS_week = rinex3NavWeek(block);
 }
 
 // Reader for GPS navigation file
-void Rinex3Nav::readGPS(std::ifstream& infile) {
-	// String tokens to look for
-	const string sTokenIALPHA = "ION ALPHA";
-	const string sTokenIBETA = "ION BETA";
-	const string sTokenIONO = "IONOSPHERIC CORR";
-	const string sTokenGPSA = "GPSA";
-	const string sTokenGPSB = "GPSB";
-	const string sTokenCORR = "TIME SYSTEM CORR";
-	const string sTokenEND = "END OF HEADER"; 
-	const string sTokenCOM = "COMMENT"; 
-	// A vector to hold block of sentences
-	vector<string> block;
-	// To hold contents of a line from input file
-	string line;
-	int nlines = 0;
-
-	// Reading Header 
-	while (!infile.eof()) {
-		line.clear(); 
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_ALPHA = line.find(sTokenIALPHA);
-		size_t found_BETA = line.find(sTokenIBETA);
-		size_t found_IONO = line.find(sTokenIONO);
-		size_t found_END = line.find(sTokenEND);
-		size_t found_CORR = line.find(sTokenCORR);
-		size_t found_COM = line.find(sTokenCOM);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// Finding Ionophseric Constants as per new format
-		else if (found_IONO != string::npos) {
-			size_t found_GPSA = line.find(sTokenGPSA);
-			size_t found_GPSB = line.find(sTokenGPSB);
-			if (found_GPSA != string::npos) {
-				_headerGPS.ialpha = headerHelperGPS(line);
-			}
-			if (found_GPSB != string::npos) {
-				_headerGPS.ibeta = headerHelperGPS(line);
-			}
-		}
-		// Finding GPS to UTC Time Correction
-		else if (found_CORR != string::npos) {
-			size_t found_GPUT = line.find("GPUT");
-			_headerGPS.GPUT = headerHelperGPS(line);
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
-	}
+void Rinex3Nav::readGPS(std::istream& infile) {
+	// Lines of one navigation record, reused for every record
+	string block[8];
 
-	// Create GPS Navigation data holder
-	map<int, vector<Rinex3Nav::DataGPS>> mapGPS;
+	// Reading Header
+	_version = 0;
+	readHeader(infile, [this](HeaderLabel label, string_view line) { navHeaderRecord(label, line); });
 
 	// Reading Navigation Data Body
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n'); nlines++;
-		if (line.find_first_not_of(' ') == std::string::npos) { continue; }
-		// Adjust line spaces before adding to block
-		if (nlines != 1) {
-			line = line.substr(4, line.length());
-		}
-		block.push_back(line);
-		// New block of navigation message
-		if (nlines == 8) {
-			// Now we must process the block of lines
-			Rinex3Nav::DataGPS GPS = epochNavOrganizerGPS(block);
-			block.clear(); nlines = 0;
-			// Add organized data to data holder
-			// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-			// Else add new PRN as key and GPS data structure as Value
-			if (mapGPS.find(GPS.PRN) == mapGPS.end()) {
-				// not found, therefore insert PRN and corresponding value
-				vector<DataGPS> mapNavVector; mapNavVector.push_back(GPS);
-				mapGPS.insert(pair<int, vector<DataGPS>>(GPS.PRN, mapNavVector));
-			}
-			else {
-				// found, therefore add to existing PRN
-				mapGPS[GPS.PRN].push_back(GPS);
-			}
-		}	
+	RINEX_TIME(TIME_TOKENIZE);
+	_navGPS.clear();
+	while (readNavRecord(infile, block, _version)) {
+		epochNavOrganizerGPS(block, newNavRecord(_navGPS, intField(block[0], 1, 2)));
 	}
-	// Update the attribute of Navigation Object
-	_navGPS = mapGPS;
 }
 
+// Navigation parameters of the GLONASS record in file order
+static double Rinex3Nav::DataGLO::* const NAV_FIELDS_GLO[15] = {
+	&Rinex3Nav::DataGLO::clockBias, &Rinex3Nav::DataGLO::relFreqBias, &Rinex3Nav::DataGLO::messageFrameTime,
+	&Rinex3Nav::DataGLO::satPosX, &Rinex3Nav::DataGLO::satVelX, &Rinex3Nav::DataGLO::satAccX,
+	&Rinex3Nav::DataGLO::satHealth, &Rinex3Nav::DataGLO::satPosY, &Rinex3Nav::DataGLO::satVelY,
+	&Rinex3Nav::DataGLO::satAccY, &Rinex3Nav::DataGLO::freqNum, &Rinex3Nav::DataGLO::satPosZ,
+	&Rinex3Nav::DataGLO::satVelZ, &Rinex3Nav::DataGLO::satAccZ, &Rinex3Nav::DataGLO::infoAge
+};
+
 // Navigation Body Organizer for GLONASS Navigation File
-Rinex3Nav::DataGLO epochNavOrganizerGLO(vector<string> block) {
-	string sys = block[0].substr(0, 1);
-	int prn = stoi(block[0].substr(1, 2));
-	vector<double> epochInfo = rinex3EpochTimeOrganizer(block[0]);
-	string line = block[0].substr(23, block[0].length());
-	for (unsigned int i = 1; i < block.size(); i++) {
-		line = line + block[i];
-	}
-	vector<double> parameters = rinex3NavDataSplitter(line);
-	// Storing Values into GPS Data Structure
-	Rinex3Nav::DataGLO GLO;
-	GLO.PRN = prn;
-	GLO.epochInfo = epochInfo;
-	GLO.gpsTime = gpsTime(epochInfo);
-	GLO.clockBias = parameters.at(0);
-	GLO.relFreqBias = parameters.at(1);
-	GLO.messageFrameTime = parameters.at(2);
-	GLO.satPosX = parameters.at(3);
-	GLO.satVelX = parameters.at(4);
-	GLO.satAccX = parameters.at(5);
-	GLO.satHealth = parameters.at(6);
-	GLO.satPosY = parameters.at(7);
-	GLO.satVelY = parameters.at(8);
-	GLO.satAccY = parameters.at(9);
-	GLO.freqNum = parameters.at(10);
-	GLO.satPosZ = parameters.at(11);
-	GLO.satVelZ = parameters.at(12);
-	GLO.satAccZ = parameters.at(13);
-	GLO.infoAge = parameters.at(14);
-	return GLO;
+void epochNavOrganizerGLO(const string* block, Rinex3Nav::DataGLO& GLO) {
+	RINEX_TIME(TIME_CONVERT);
+	GLO.isAvailable = true;
+	GLO.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	GLO.gpsTime = gpsTimeFromUtc(epochInfo);
+	rinex3NavDataSplitter(block, 4, GLO, NAV_FIELDS_GLO);
 }
 
 // Reader for Glonass navigation file
 // Parameters are in ECEF Greenwich coordinate system PZ - 90
-void Rinex3Nav::readGLO(std::ifstream& infile) {
-	// String tokens to look 
-	const string sTokenCORR = "CORR TO SYSTEM TIME";
-	const string sTokenLEAP = "LEAP SECONDS";
-	const string sTokenEND = "END OF HEADER";
-	const string sTokenCOM = "COMMENT";
-	// A vector to hold block of sentences
-	vector<string> block;
-	// To hold contents of a line from input file
-	string line;
-	int nlines = 0;
-
-	// Reading Header 
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_LEAP = line.find(sTokenLEAP);
-		size_t found_END = line.find(sTokenEND);
-		size_t found_CORR = line.find(sTokenCORR);
-		size_t found_COM = line.find(sTokenCOM);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// Finding Time Correction
-		else if (found_CORR != string::npos) {
-			line = line.substr(0, 60);
-			// Splitting words in the line
-			istringstream iss(line);
-			vector<string> dataS{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-			for (string s : dataS) { _headerGLO.TimeCorr.push_back(stod(s)); }
-			dataS.clear();
-		}
-		// Finding Leap Second
-		else if (found_LEAP != string::npos) {
-			line = line.substr(0, 7);
-			_headerGLO.leapSec = stod(line);
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
-	}
+void Rinex3Nav::readGLO(std::istream& infile) {
+	// Lines of one navigation record, reused for every record
+	string block[8];
 
-	// Create GLO Navigation data holder
-	map<int, vector<Rinex3Nav::DataGLO>> mapGLO;
+	// Reading Header
+	_version = 0;
+	readHeader(infile, [this](HeaderLabel label, string_view line) { navHeaderRecord(label, line); });
 
 	// Reading Navigation Data Body
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n'); nlines++;
-		if (line.find_first_not_of(' ') == std::string::npos) { continue; }
-		// Adjust line spaces before adding to block
-		if (nlines != 1) {
-			line = line.substr(4, line.length());
-		}
-		block.push_back(line);
-		// New block of navigation message
-		if (nlines == 4) {
-			// Now we must process the block of lines
-			Rinex3Nav::DataGLO GLO = epochNavOrganizerGLO(block);
-			block.clear(); nlines = 0;
-			// Add organized data to data holder
-			// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-			// Else add new PRN as key and GLO data structure as Value
-			if (mapGLO.find(GLO.PRN) == mapGLO.end()) {
-				// not found, therefore insert PRN and corresponding value
-				vector<DataGLO> mapNavVector; mapNavVector.push_back(GLO);
-				mapGLO.insert(pair<int, vector<DataGLO>>(GLO.PRN, mapNavVector));
-			}
-			else {
-				// found, therefore add to existing PRN
-				mapGLO[GLO.PRN].push_back(GLO);
-			}
-		}
+	RINEX_TIME(TIME_TOKENIZE);
+	_navGLO.clear();
+	while (readNavRecord(infile, block, _version)) {
+		epochNavOrganizerGLO(block, newNavRecord(_navGLO, intField(block[0], 1, 2)));
 	}
-	// Update the attribute of Navigation Object
-	_navGLO = mapGLO;
 }
 
+// Navigation parameters of the GALILEO record in file order, data sources and spare fields are not kept
+// The week is an integer and is read separately
+static double Rinex3Nav::DataGAL::* const NAV_FIELDS_GAL[28] = {
+	&Rinex3Nav::DataGAL::clockBias, &Rinex3Nav::DataGAL::clockDrift, &Rinex3Nav::DataGAL::clockDriftRate,
+	&Rinex3Nav::DataGAL::IOD, &Rinex3Nav::DataGAL::Crs, &Rinex3Nav::DataGAL::Delta_n, &Rinex3Nav::DataGAL::Mo,
+	&Rinex3Nav::DataGAL::Cuc, &Rinex3Nav::DataGAL::Eccentricity, &Rinex3Nav::DataGAL::Cus, &Rinex3Nav::DataGAL::Sqrt_a,
+	&Rinex3Nav::DataGAL::TOE, &Rinex3Nav::DataGAL::Cic, &Rinex3Nav::DataGAL::OMEGA, &Rinex3Nav::DataGAL::CIS,
+	&Rinex3Nav::DataGAL::Io, &Rinex3Nav::DataGAL::Crc, &Rinex3Nav::DataGAL::Omega, &Rinex3Nav::DataGAL::Omega_dot,
+	&Rinex3Nav::DataGAL::IDOT, nullptr, nullptr, nullptr,
+	&Rinex3Nav::DataGAL::SISA, &Rinex3Nav::DataGAL::svHealth, &Rinex3Nav::DataGAL::BGD_E5a,
+	&Rinex3Nav::DataGAL::BGD_E5b, &Rinex3Nav::DataGAL::transmission_time
+};
+
 // Navigation Body Organizer for GAL Navigation File
-Rinex3Nav::DataGAL epochNavOrganizerGAL(vector<string> block) {
-	string sys = block[0].substr(0, 1);
-	int prn = stoi(block[0].substr(1, 2));
-	vector<double> epochInfo = rinex3EpochTimeOrganizer(block[0]);
-	string line = block[0].substr(23, block[0].length());
-	for (unsigned int i = 1; i < block.size(); i++) {
-		line = line + block[i];
-	}
-	vector<double> parameters = rinex3NavDataSplitter(line);
-	// Storing Values into GAL Data Structure
-	Rinex3Nav::DataGAL GAL;
-	GAL.PRN = prn;
-	GAL.epochInfo = epochInfo;
+void epochNavOrganizerGAL(const string* block, Rinex3Nav::DataGAL& GAL) {
+	RINEX_TIME(TIME_CONVERT);
+	GAL.isAvailable = true;
+	GAL.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
 	GAL.gpsTime = gpsTime(epochInfo);
-	GAL.clockBias = parameters.at(0);
-	GAL.clockDrift = parameters.at(1);
-	GAL.clockDriftRate = parameters.at(2);
-	GAL.IOD = parameters.at(3);
-	GAL.Crs = parameters.at(4);
-	GAL.Delta_n = parameters.at(5);
-	GAL.Mo = parameters.at(6);
-	GAL.Cuc = parameters.at(7);
-	GAL.Eccentricity = parameters.at(8);
-	GAL.Cus = parameters.at(9);
-	GAL.Sqrt_a = parameters.at(10);
-	GAL.TOE = parameters.at(11);
-	GAL.Cic = parameters.at(12);
-	GAL.OMEGA = parameters.at(13);
-	GAL.CIS = parameters.at(14);
-	GAL.Io = parameters.at(15);
-	GAL.Crc = parameters.at(16);
-	GAL.Omega = parameters.at(17);
-	GAL.Omega_dot = parameters.at(18);
-	GAL.IDOT = parameters.at(19);
-	GAL.GAL_week = parameters.at(21);
-	GAL.SISA = parameters.at(22);
-	GAL.svHealth = parameters.at(23);
-	GAL.BGD_E5a = parameters.at(24);
-	GAL.BGD_E5b = parameters.at(25);
-	GAL.transmission_time = parameters.at(26);
-	return GAL;
+	rinex3NavDataSplitter(block, 8, GAL, NAV_FIELDS_GAL);
+	GAL.GAL_week = rinex3NavWeek(block);
 }
 
 // Reader for Galileo navigation file
-void Rinex3Nav::readGAL(std::ifstream& infile) {
-	// String tokens to look 
-	const string sTokenLEAP = "LEAP SECONDS";
-	const string sTokenEND = "END OF HEADER";
-	const string sTokenCOM = "COMMENT";
-	// A vector to hold block of sentences
-	vector<string> block;
-	// To hold contents of a line from input file
-	string line;
-	int nlines = 0;
-
-	// Reading Header 
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_LEAP = line.find(sTokenLEAP);
-		size_t found_END = line.find(sTokenEND);
-		size_t found_COM = line.find(sTokenCOM);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// Finding Leap Second
-		else if (found_LEAP != string::npos) {
-			line = line.substr(0, 7);
-			_headerGLO.leapSec = stod(line);
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
+void Rinex3Nav::readGAL(std::istream& infile) {
+	// Lines of one navigation record, reused for every record
+	string block[8];
+
+	// Reading Header
+	_version = 0;
+	readHeader(infile, [this](HeaderLabel label, string_view line) { navHeaderRecord(label, line); });
+
+	// Reading Navigation Data Body
+	RINEX_TIME(TIME_TOKENIZE);
+	_navGAL.clear();
+	while (readNavRecord(infile, block, _version)) {
+		epochNavOrganizerGAL(block, newNavRecord(_navGAL, intField(block[0], 1, 2)));
 	}
+}
+
+// Navigation parameters of the BEIDOU record in file order, spares and the week are not read as floating point
+static double Rinex3Nav::DataBDS::* const NAV_FIELDS_BDS[29] = {
+	&Rinex3Nav::DataBDS::clockBias, &Rinex3Nav::DataBDS::clockDrift, &Rinex3Nav::DataBDS::clockDriftRate,
+	&Rinex3Nav::DataBDS::AODE, &Rinex3Nav::DataBDS::Crs, &Rinex3Nav::DataBDS::Delta_n, &Rinex3Nav::DataBDS::Mo,
+	&Rinex3Nav::DataBDS::Cuc, &Rinex3Nav::DataBDS::Eccentricity, &Rinex3Nav::DataBDS::Cus, &Rinex3Nav::DataBDS::Sqrt_a,
+	&Rinex3Nav::DataBDS::TOE, &Rinex3Nav::DataBDS::Cic, &Rinex3Nav::DataBDS::OMEGA, &Rinex3Nav::DataBDS::CIS,
+	&Rinex3Nav::DataBDS::Io, &Rinex3Nav::DataBDS::Crc, &Rinex3Nav::DataBDS::Omega, &Rinex3Nav::DataBDS::Omega_dot,
+	&Rinex3Nav::DataBDS::IDOT, nullptr, nullptr, nullptr,
+	&Rinex3Nav::DataBDS::svAccuracy, &Rinex3Nav::DataBDS::SatH1, &Rinex3Nav::DataBDS::TGD1,
+	&Rinex3Nav::DataBDS::TGD2, &Rinex3Nav::DataBDS::transmission_time, &Rinex3Nav::DataBDS::AODC
+};
+
+// Navigation Body Organizer for BDS Navigation File
+void epochNavOrganizerBDS(const string* block, Rinex3Nav::DataBDS& BDS) {
+	RINEX_TIME(TIME_CONVERT);
+	BDS.isAvailable = true;
+	BDS.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	BDS.gpsTime = gpsTimeFromBdt(epochInfo);
+	rinex3NavDataSplitter(block, 8, BDS, NAV_FIELDS_BDS);
+	BDS.BDT_week = rinex3NavWeek(block);
+}
+
+// Navigation Body Organizer for QZSS Navigation File, the record is laid out as a GPS one
+void epochNavOrganizerQZS(const string* block, Rinex3Nav::DataGPS& QZS) {
+	epochNavOrganizerGPS(block, QZS);
+}
+
+// Navigation parameters of the NavIC/IRNSS record in file order, kept in the GPS structure
+static double Rinex3Nav::DataGPS::* const NAV_FIELDS_IRN[28] = {
+	&Rinex3Nav::DataGPS::clockBias, &Rinex3Nav::DataGPS::clockDrift, &Rinex3Nav::DataGPS::clockDriftRate,
+	&Rinex3Nav::DataGPS::IODE, &Rinex3Nav::DataGPS::Crs, &Rinex3Nav::DataGPS::Delta_n, &Rinex3Nav::DataGPS::Mo,
+	&Rinex3Nav::DataGPS::Cuc, &Rinex3Nav::DataGPS::Eccentricity, &Rinex3Nav::DataGPS::Cus, &Rinex3Nav::DataGPS::Sqrt_a,
+	&Rinex3Nav::DataGPS::TOE, &Rinex3Nav::DataGPS::Cic, &Rinex3Nav::DataGPS::OMEGA, &Rinex3Nav::DataGPS::CIS,
+	&Rinex3Nav::DataGPS::Io, &Rinex3Nav::DataGPS::Crc, &Rinex3Nav::DataGPS::Omega, &Rinex3Nav::DataGPS::Omega_dot,
+	&Rinex3Nav::DataGPS::IDOT, nullptr, nullptr, nullptr,
+	&Rinex3Nav::DataGPS::svAccuracy, &Rinex3Nav::DataGPS::svHealth, &Rinex3Nav::DataGPS::TGD, nullptr,
+	&Rinex3Nav::DataGPS::transmission_time
+};
+
+// Navigation Body Organizer for IRNSS Navigation File, IRNSS time and weeks are aligned with GPS
+void epochNavOrganizerIRN(const string* block, Rinex3Nav::DataGPS& IRN) {
+	RINEX_TIME(TIME_CONVERT);
+	IRN.isAvailable = true;
+	IRN.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	IRN.gpsTime = gpsTime(epochInfo);
+	rinex3NavDataSplitter(block, 8, IRN, NAV_FIELDS_IRN);
+	IRN.GPS_week = rinex3NavWeek(block);
+}
+
+// Navigation parameters of the SBAS record in file order
+static double Rinex3Nav::DataSBS::* const NAV_FIELDS_SBS[15] = {
+	&Rinex3Nav::DataSBS::clockBias, &Rinex3Nav::DataSBS::relFreqBias, &Rinex3Nav::DataSBS::transmission_time,
+	&Rinex3Nav::DataSBS::satPosX, &Rinex3Nav::DataSBS::satVelX, &Rinex3Nav::DataSBS::satAccX,
+	&Rinex3Nav::DataSBS::satHealth, &Rinex3Nav::DataSBS::satPosY, &Rinex3Nav::DataSBS::satVelY,
+	&Rinex3Nav::DataSBS::satAccY, &Rinex3Nav::DataSBS::URA, &Rinex3Nav::DataSBS::satPosZ,
+	&Rinex3Nav::DataSBS::satVelZ, &Rinex3Nav::DataSBS::satAccZ, &Rinex3Nav::DataSBS::IODN
+};
+
+// Navigation Body Organizer for SBAS Navigation File
+void epochNavOrganizerSBS(const string* block, Rinex3Nav::DataSBS& SBS) {
+	RINEX_TIME(TIME_CONVERT);
+	SBS.isAvailable = true;
+	SBS.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	SBS.gpsTime = gpsTime(epochInfo);
+	rinex3NavDataSplitter(block, 4, SBS, NAV_FIELDS_SBS);
+}
+
+// Reader for mixed navigation file
+void Rinex3Nav::readMixed(std::istream& infile) {
+	// Lines of one navigation record, reused for every record
+	string block[8];
 
-	// Create GAL Navigation data holder
-	map<int, vector<Rinex3Nav::DataGAL>> mapGAL;
+	// Reading Header
+	_version = 0;
+	readHeader(infile, [this](HeaderLabel label, string_view line) { navHeaderRecord(label, line); });
 
 	// Reading Navigation Data Body
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n'); nlines++;
-		if (line.find_first_not_of(' ') == std::string::npos) { continue; }
-		// Adjust line spaces before adding to block
-		if (nlines != 1) {
-			line = line.substr(4, line.length());
+	// One pass over the records, each is dispatched on its constellation identifier and parsed in place
+	RINEX_TIME(TIME_TOKENIZE);
+	_navGPS.clear();
+	_navGLO.clear();
+	_navGAL.clear();
+	_navBDS.clear();
+	_navQZS.clear();
+	_navSBS.clear();
+	_navIRN.clear();
+	_cnavGPS.clear();
+	_cnavQZS.clear();
+	_cnavBDS.clear();
+	_navSTO.clear();
+	_navEOP.clear();
+	_navION.clear();
+	if (_version >= 4) {
+		readRecords4(infile);
+		return;
+	}
+	while (readNavRecord(infile, block, _version)) {
+		int prn = intField(block[0], 1, 2);
+		switch (block[0][0]) {
+		case 'G': epochNavOrganizerGPS(block, newNavRecord(_navGPS, prn)); break;
+		case 'R': epochNavOrganizerGLO(block, newNavRecord(_navGLO, prn)); break;
+		case 'E': epochNavOrganizerGAL(block, newNavRecord(_navGAL, prn)); break;
+		case 'C': epochNavOrganizerBDS(block, newNavRecord(_navBDS, prn)); break;
+		case 'J': epochNavOrganizerQZS(block, newNavRecord(_navQZS, prn)); break;
+		case 'S': epochNavOrganizerSBS(block, newNavRecord(_navSBS, prn)); break;
+		case 'I': epochNavOrganizerIRN(block, newNavRecord(_navIRN, prn)); break;
+		// Unknown identifiers never start a record, readNavRecord skips their lines
+		default: break;
 		}
-		block.push_back(line);
-		// New block of navigation message
-		if (nlines == 8) {
-			// Now we must process the block of lines
-			Rinex3Nav::DataGAL GAL = epochNavOrganizerGAL(block);
-			block.clear(); nlines = 0;
-			// Add organized data to data holder
-			// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-			// Else add new PRN as key and GAL data structure as Value
-			if (mapGAL.find(GAL.PRN) == mapGAL.end()) {
-				// not found, therefore insert PRN and corresponding value
-				vector<DataGAL> mapNavVector; mapNavVector.push_back(GAL);
-				mapGAL.insert(pair<int, vector<DataGAL>>(GAL.PRN, mapNavVector));
-			}
-			else {
-				// found, therefore add to existing PRN
-				mapGAL[GAL.PRN].push_back(GAL);
-			}
+	}
+}
+
+// * Rinex 4 records
+
+// Time of a record epoch given in the system time of its satellite
+static GpsTime recordTime(char system, const double* epochInfo) {
+	switch (system) {
+	case 'C': return gpsTimeFromBdt(epochInfo);
+	case 'R': return gpsTimeFromUtc(epochInfo);
+	default: return gpsTime(epochInfo);
+	}
+}
+
+// Navigation parameters of the GPS and QZSS CNAV record in file order, the week is read separately
+static double Rinex3Nav::DataCNAV::* const NAV_FIELDS_CNAV[32] = {
+	&Rinex3Nav::DataCNAV::clockBias, &Rinex3Nav::DataCNAV::clockDrift, &Rinex3Nav::DataCNAV::clockDriftRate,
+	&Rinex3Nav::DataCNAV::ADOT, &Rinex3Nav::DataCNAV::Crs, &Rinex3Nav::DataCNAV::Delta_n, &Rinex3Nav::DataCNAV::Mo,
+	&Rinex3Nav::DataCNAV::Cuc, &Rinex3Nav::DataCNAV::Eccentricity, &Rinex3Nav::DataCNAV::Cus, &Rinex3Nav::DataCNAV::Sqrt_a,
+	&Rinex3Nav::DataCNAV::TOP, &Rinex3Nav::DataCNAV::Cic, &Rinex3Nav::DataCNAV::OMEGA, &Rinex3Nav::DataCNAV::CIS,
+	&Rinex3Nav::DataCNAV::Io, &Rinex3Nav::DataCNAV::Crc, &Rinex3Nav::DataCNAV::Omega, &Rinex3Nav::DataCNAV::Omega_dot,
+	&Rinex3Nav::DataCNAV::IDOT, &Rinex3Nav::DataCNAV::Delta_n_dot, &Rinex3Nav::DataCNAV::URAI_NED0, &Rinex3Nav::DataCNAV::URAI_NED1,
+	&Rinex3Nav::DataCNAV::URAI_ED, &Rinex3Nav::DataCNAV::svHealth, &Rinex3Nav::DataCNAV::TGD, &Rinex3Nav::DataCNAV::URAI_NED2,
+	&Rinex3Nav::DataCNAV::ISC_L1CA, &Rinex3Nav::DataCNAV::ISC_L2C, &Rinex3Nav::DataCNAV::ISC_L5I5, &Rinex3Nav::DataCNAV::ISC_L5Q5,
+	&Rinex3Nav::DataCNAV::transmission_time
+};
+// CNV2 has a line of L1C group delays before the transmission time
+static double Rinex3Nav::DataCNAV::* const NAV_FIELDS_CNV2[36] = {
+	&Rinex3Nav::DataCNAV::clockBias, &Rinex3Nav::DataCNAV::clockDrift, &Rinex3Nav::DataCNAV::clockDriftRate,
+	&Rinex3Nav::DataCNAV::ADOT, &Rinex3Nav::DataCNAV::Crs, &Rinex3Nav::DataCNAV::Delta_n, &Rinex3Nav::DataCNAV::Mo,
+	&Rinex3Nav::DataCNAV::Cuc, &Rinex3Nav::DataCNAV::Eccentricity, &Rinex3Nav::DataCNAV::Cus, &Rinex3Nav::DataCNAV::Sqrt_a,
+	&Rinex3Nav::DataCNAV::TOP, &Rinex3Nav::DataCNAV::Cic, &Rinex3Nav::DataCNAV::OMEGA, &Rinex3Nav::DataCNAV::CIS,
+	&Rinex3Nav::DataCNAV::Io, &Rinex3Nav::DataCNAV::Crc, &Rinex3Nav::DataCNAV::Omega, &Rinex3Nav::DataCNAV::Omega_dot,
+	&Rinex3Nav::DataCNAV::IDOT, &Rinex3Nav::DataCNAV::Delta_n_dot, &Rinex3Nav::DataCNAV::URAI_NED0, &Rinex3Nav::DataCNAV::URAI_NED1,
+	&Rinex3Nav::DataCNAV::URAI_ED, &Rinex3Nav::DataCNAV::svHealth, &Rinex3Nav::DataCNAV::TGD, &Rinex3Nav::DataCNAV::URAI_NED2,
+	&Rinex3Nav::DataCNAV::ISC_L1CA, &Rinex3Nav::DataCNAV::ISC_L2C, &Rinex3Nav::DataCNAV::ISC_L5I5, &Rinex3Nav::DataCNAV::ISC_L5Q5,
+	&Rinex3Nav::DataCNAV::ISC_L1Cd, &Rinex3Nav::DataCNAV::ISC_L1Cp, nullptr, nullptr,
+	&Rinex3Nav::DataCNAV::transmission_time
+};
+
+// Navigation Body Organizer for GPS and QZSS CNAV and CNV2 records, nLines lines long
+template <size_t N>
+void epochNavOrganizerCNAV(const string* block, size_t nLines, Rinex3Nav::DataCNAV& CNAV, double Rinex3Nav::DataCNAV::* const (&fields)[N]) {
+	RINEX_TIME(TIME_CONVERT);
+	CNAV.isAvailable = true;
+	CNAV.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	CNAV.gpsTime = gpsTime(epochInfo);
+	rinex3NavDataSplitter(block, nLines, CNAV, fields);
+	// 2nd parameter of the last line
+	CNAV.WN_op = static_cast<int>(lround(floatField(block[nLines - 1], 23, 19)));
+}
+
+// Navigation parameters of the BEIDOU CNV1 record in file order, CNV2 differs by its group delay line only
+static double Rinex3Nav::DataBDSCNAV::* const NAV_FIELDS_BDS_CNV1[39] = {
+	&Rinex3Nav::DataBDSCNAV::clockBias, &Rinex3Nav::DataBDSCNAV::clockDrift, &Rinex3Nav::DataBDSCNAV::clockDriftRate,
+	&Rinex3Nav::DataBDSCNAV::ADOT, &Rinex3Nav::DataBDSCNAV::Crs, &Rinex3Nav::DataBDSCNAV::Delta_n, &Rinex3Nav::DataBDSCNAV::Mo,
+	&Rinex3Nav::DataBDSCNAV::Cuc, &Rinex3Nav::DataBDSCNAV::Eccentricity, &Rinex3Nav::DataBDSCNAV::Cus, &Rinex3Nav::DataBDSCNAV::Sqrt_a,
+	&Rinex3Nav::DataBDSCNAV::TOE, &Rinex3Nav::DataBDSCNAV::Cic, &Rinex3Nav::DataBDSCNAV::OMEGA, &Rinex3Nav::DataBDSCNAV::CIS,
+	&Rinex3Nav::DataBDSCNAV::Io, &Rinex3Nav::DataBDSCNAV::Crc, &Rinex3Nav::DataBDSCNAV::Omega, &Rinex3Nav::DataBDSCNAV::Omega_dot,
+	&Rinex3Nav::DataBDSCNAV::IDOT, &Rinex3Nav::DataBDSCNAV::Delta_n_dot, &Rinex3Nav::DataBDSCNAV::satType, &Rinex3Nav::DataBDSCNAV::TOP,
+	&Rinex3Nav::DataBDSCNAV::SISAI_oe, &Rinex3Nav::DataBDSCNAV::SISAI_ocb, &Rinex3Nav::DataBDSCNAV::SISAI_oc1, &Rinex3Nav::DataBDSCNAV::SISAI_oc2,
+	&Rinex3Nav::DataBDSCNAV::ISC_B1Cd, nullptr, &Rinex3Nav::DataBDSCNAV::TGD_B1Cp, &Rinex3Nav::DataBDSCNAV::TGD_B2ap,
+	&Rinex3Nav::DataBDSCNAV::SISMAI, &Rinex3Nav::DataBDSCNAV::svHealth, &Rinex3Nav::DataBDSCNAV::integrityFlags, &Rinex3Nav::DataBDSCNAV::IODC,
+	&Rinex3Nav::DataBDSCNAV::transmission_time, nullptr, nullptr, &Rinex3Nav::DataBDSCNAV::IODE
+};
+static double Rinex3Nav::DataBDSCNAV::* const NAV_FIELDS_BDS_CNV2[39] = {
+	&Rinex3Nav::DataBDSCNAV::clockBias, &Rinex3Nav::DataBDSCNAV::clockDrift, &Rinex3Nav::DataBDSCNAV::clockDriftRate,
+	&Rinex3Nav::DataBDSCNAV::ADOT, &Rinex3Nav::DataBDSCNAV::Crs, &Rinex3Nav::DataBDSCNAV::Delta_n, &Rinex3Nav::DataBDSCNAV::Mo,
+	&Rinex3Nav::DataBDSCNAV::Cuc, &Rinex3Nav::DataBDSCNAV::Eccentricity, &Rinex3Nav::DataBDSCNAV::Cus, &Rinex3Nav::DataBDSCNAV::Sqrt_a,
+	&Rinex3Nav::DataBDSCNAV::TOE, &Rinex3Nav::DataBDSCNAV::Cic, &Rinex3Nav::DataBDSCNAV::OMEGA, &Rinex3Nav::DataBDSCNAV::CIS,
+	&Rinex3Nav::DataBDSCNAV::Io, &Rinex3Nav::DataBDSCNAV::Crc, &Rinex3Nav::DataBDSCNAV::Omega, &Rinex3Nav::DataBDSCNAV::Omega_dot,
+	&Rinex3Nav::DataBDSCNAV::IDOT, &Rinex3Nav::DataBDSCNAV::Delta_n_dot, &Rinex3Nav::DataBDSCNAV::satType, &Rinex3Nav::DataBDSCNAV::TOP,
+	&Rinex3Nav::DataBDSCNAV::SISAI_oe, &Rinex3Nav::DataBDSCNAV::SISAI_ocb, &Rinex3Nav::DataBDSCNAV::SISAI_oc1, &Rinex3Nav::DataBDSCNAV::SISAI_oc2,
+	nullptr, &Rinex3Nav::DataBDSCNAV::ISC_B2ad, &Rinex3Nav::DataBDSCNAV::TGD_B1Cp, &Rinex3Nav::DataBDSCNAV::TGD_B2ap,
+	&Rinex3Nav::DataBDSCNAV::SISMAI, &Rinex3Nav::DataBDSCNAV::svHealth, &Rinex3Nav::DataBDSCNAV::integrityFlags, &Rinex3Nav::DataBDSCNAV::IODC,
+	&Rinex3Nav::DataBDSCNAV::transmission_time, nullptr, nullptr, &Rinex3Nav::DataBDSCNAV::IODE
+};
+// CNV3 has no IODC and IODE, and one line less
+static double Rinex3Nav::DataBDSCNAV::* const NAV_FIELDS_BDS_CNV3[32] = {
+	&Rinex3Nav::DataBDSCNAV::clockBias, &Rinex3Nav::DataBDSCNAV::clockDrift, &Rinex3Nav::DataBDSCNAV::clockDriftRate,
+	&Rinex3Nav::DataBDSCNAV::ADOT, &Rinex3Nav::DataBDSCNAV::Crs, &Rinex3Nav::DataBDSCNAV::Delta_n, &Rinex3Nav::DataBDSCNAV::Mo,
+	&Rinex3Nav::DataBDSCNAV::Cuc, &Rinex3Nav::DataBDSCNAV::Eccentricity, &Rinex3Nav::DataBDSCNAV::Cus, &Rinex3Nav::DataBDSCNAV::Sqrt_a,
+	&Rinex3Nav::DataBDSCNAV::TOE, &Rinex3Nav::DataBDSCNAV::Cic, &Rinex3Nav::DataBDSCNAV::OMEGA, &Rinex3Nav::DataBDSCNAV::CIS,
+	&Rinex3Nav::DataBDSCNAV::Io, &Rinex3Nav::DataBDSCNAV::Crc, &Rinex3Nav::DataBDSCNAV::Omega, &Rinex3Nav::DataBDSCNAV::Omega_dot,
+	&Rinex3Nav::DataBDSCNAV::IDOT, &Rinex3Nav::DataBDSCNAV::Delta_n_dot, &Rinex3Nav::DataBDSCNAV::satType, &Rinex3Nav::DataBDSCNAV::TOP,
+	&Rinex3Nav::DataBDSCNAV::SISAI_oe, &Rinex3Nav::DataBDSCNAV::SISAI_ocb, &Rinex3Nav::DataBDSCNAV::SISAI_oc1, &Rinex3Nav::DataBDSCNAV::SISAI_oc2,
+	&Rinex3Nav::DataBDSCNAV::SISMAI, &Rinex3Nav::DataBDSCNAV::svHealth, &Rinex3Nav::DataBDSCNAV::integrityFlags, &Rinex3Nav::DataBDSCNAV::TGD_B2bI,
+	&Rinex3Nav::DataBDSCNAV::transmission_time
+};
+
+// Navigation Body Organizer for BEIDOU CNV1, CNV2 and CNV3 records
+template <size_t N>
+void epochNavOrganizerBDSCNAV(const string* block, size_t nLines, Rinex3Nav::DataBDSCNAV& CNAV, double Rinex3Nav::DataBDSCNAV::* const (&fields)[N]) {
+	RINEX_TIME(TIME_CONVERT);
+	CNAV.isAvailable = true;
+	CNAV.PRN = intField(block[0], 1, 2);
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	CNAV.gpsTime = gpsTimeFromBdt(epochInfo);
+	rinex3NavDataSplitter(block, nLines, CNAV, fields);
+}
+
+// System time offset, epoch and offset type on the first line, parameters on the second
+static double Rinex3Nav::DataSTO::* const NAV_FIELDS_STO[7] = {
+	nullptr, nullptr, nullptr,
+	&Rinex3Nav::DataSTO::tTot, &Rinex3Nav::DataSTO::A0, &Rinex3Nav::DataSTO::A1, &Rinex3Nav::DataSTO::A2
+};
+static double Rinex3Nav::DataEOP::* const NAV_FIELDS_EOP[11] = {
+	&Rinex3Nav::DataEOP::xp, &Rinex3Nav::DataEOP::dxp, &Rinex3Nav::DataEOP::ddxp,
+	nullptr, &Rinex3Nav::DataEOP::yp, &Rinex3Nav::DataEOP::dyp, &Rinex3Nav::DataEOP::ddyp,
+	&Rinex3Nav::DataEOP::tTot, &Rinex3Nav::DataEOP::dUT1, &Rinex3Nav::DataEOP::ddUT1, &Rinex3Nav::DataEOP::dddUT1
+};
+
+void epochNavOrganizerSTO(const string* block, char system, int prn, Rinex3Nav& nav) {
+	RINEX_TIME(TIME_CONVERT);
+	nav._navSTO.emplace_back();
+	Rinex3Nav::DataSTO& STO = nav._navSTO.back();
+	STO.system = system;
+	STO.PRN = prn;
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	STO.gpsTime = recordTime(system, epochInfo);
+	string_view type = textField(block[0], 24, 18);
+	type.copy(STO.type, min(type.size(), sizeof(STO.type) - 1));
+	rinex3NavDataSplitter(block, 2, STO, NAV_FIELDS_STO);
+	// GPS to UTC correction as a Rinex 3 header gives it: a0, a1, reference time and week
+	if (type == "GPUT") { nav._headerGPS.GPUT = { STO.A0, STO.A1, STO.tTot, static_cast<double>(STO.gpsTime.week()) }; }
+}
+
+void epochNavOrganizerEOP(const string* block, char system, int prn, Rinex3Nav& nav) {
+	RINEX_TIME(TIME_CONVERT);
+	nav._navEOP.emplace_back();
+	Rinex3Nav::DataEOP& EOP = nav._navEOP.back();
+	EOP.system = system;
+	EOP.PRN = prn;
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	EOP.gpsTime = recordTime(system, epochInfo);
+	rinex3NavDataSplitter(block, 3, EOP, NAV_FIELDS_EOP);
+}
+
+// Ionospheric coefficients in file order, nLines lines long
+void epochNavOrganizerION(const string* block, size_t nLines, char system, int prn, int model, Rinex3Nav& nav) {
+	RINEX_TIME(TIME_CONVERT);
+	nav._navION.emplace_back();
+	Rinex3Nav::DataION& ION = nav._navION.back();
+	ION.system = system;
+	ION.PRN = prn;
+	ION.model = model;
+	double epochInfo[6];
+	rinex3EpochTimeOrganizer(block[0], epochInfo);
+	ION.gpsTime = recordTime(system, epochInfo);
+	size_t n = 0;
+	for (size_t i = 0; i < nLines; i++) {
+		for (size_t col = (i == 0) ? 23 : 4; col < 80 && n < 9; col += 19, n++) {
+			ION.coefficients[n] = floatField(block[i], col, 19);
 		}
 	}
-	// Update the attribute of Navigation Object
-	_navGAL = mapGAL;
+	// GPS Klobuchar parameters, as the IONOSPHERIC CORR lines of a Rinex 3 header give them
+	if (system == 'G' && model == Rinex3Nav::ION_KLOBUCHAR) {
+		nav._headerGPS.ialpha.assign(ION.coefficients, ION.coefficients + 4);
+		nav._headerGPS.ibeta.assign(ION.coefficients + 4, ION.coefficients + 8);
+	}
 }
 
-// Reader for GPS navigation file
-void Rinex3Nav::readMixed(std::ifstream& infile) {
-	// String tokens to look for
-	const string sTokenIALPHA = "ION ALPHA";
-	const string sTokenIBETA = "ION BETA";
-	const string sTokenIONO = "IONOSPHERIC CORR";
-	const string sTokenGPSA = "GPSA";
-	const string sTokenGPSB = "GPSB";
-	const string sTokenCORR = "TIME SYSTEM CORR";
-	const string sTokenEND = "END OF HEADER";
-	const string sTokenCOM = "COMMENT";
-	// A vector to hold block of sentences
-	vector<string> block;
-	// To hold contents of a line from input file
-	string line;
-	int nlines = 0;
-
-	// Reading Header 
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_ALPHA = line.find(sTokenIALPHA);
-		size_t found_BETA = line.find(sTokenIBETA);
-		size_t found_IONO = line.find(sTokenIONO);
-		size_t found_END = line.find(sTokenEND);
-		size_t found_CORR = line.find(sTokenCORR);
-		size_t found_COM = line.find(sTokenCOM);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
+// A kind of Rinex 4 record and its decoder, found from its "> EPH G01 LNAV" line
+struct Record4Kind {
+	const char* type;
+	// Satellite system, blank for any
+	char system;
+	// Message, empty for any
+	const char* message;
+	// Lines after the "> " line, more are allowed and not read
+	size_t nLines;
+	void (*decode)(Rinex3Nav& nav, const string* block, char system, int prn);
+};
+
+// Looked up in order, so the entries for any system or message come after the specific ones
+// The 5th line of GLONASS FDMA records (status flags, L1/L2 group delay, URAI, health flags) is not kept
+static const Record4Kind RECORD4_KINDS[] = {
+	{ "EPH", 'G', "LNAV", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerGPS(block, newNavRecord(nav._navGPS, prn)); } },
+	{ "EPH", 'G', "CNAV", 9, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerCNAV(block, 9, newNavRecord(nav._cnavGPS, prn), NAV_FIELDS_CNAV); } },
+	{ "EPH", 'G', "CNV2", 10, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerCNAV(block, 10, newNavRecord(nav._cnavGPS, prn), NAV_FIELDS_CNV2); } },
+	{ "EPH", 'R', "FDMA", 4, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerGLO(block, newNavRecord(nav._navGLO, prn)); } },
+	{ "EPH", 'E', "INAV", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerGAL(block, newNavRecord(nav._navGAL, prn)); } },
+	{ "EPH", 'E', "FNAV", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerGAL(block, newNavRecord(nav._navGAL, prn)); } },
+	{ "EPH", 'C', "D1", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerBDS(block, newNavRecord(nav._navBDS, prn)); } },
+	{ "EPH", 'C', "D2", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerBDS(block, newNavRecord(nav._navBDS, prn)); } },
+	{ "EPH", 'C', "CNV1", 10, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerBDSCNAV(block, 10, newNavRecord(nav._cnavBDS, prn), NAV_FIELDS_BDS_CNV1); } },
+	{ "EPH", 'C', "CNV2", 10, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerBDSCNAV(block, 10, newNavRecord(nav._cnavBDS, prn), NAV_FIELDS_BDS_CNV2); } },
+	{ "EPH", 'C', "CNV3", 9, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerBDSCNAV(block, 9, newNavRecord(nav._cnavBDS, prn), NAV_FIELDS_BDS_CNV3); } },
+	{ "EPH", 'J', "LNAV", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerQZS(block, newNavRecord(nav._navQZS, prn)); } },
+	{ "EPH", 'J', "CNAV", 9, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerCNAV(block, 9, newNavRecord(nav._cnavQZS, prn), NAV_FIELDS_CNAV); } },
+	{ "EPH", 'J', "CNV2", 10, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerCNAV(block, 10, newNavRecord(nav._cnavQZS, prn), NAV_FIELDS_CNV2); } },
+	{ "EPH", 'I', "LNAV", 8, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerIRN(block, newNavRecord(nav._navIRN, prn)); } },
+	{ "EPH", 'S', "SBAS", 4, [](Rinex3Nav& nav, const string* block, char, int prn) { epochNavOrganizerSBS(block, newNavRecord(nav._navSBS, prn)); } },
+	{ "STO", ' ', "", 2, [](Rinex3Nav& nav, const string* block, char system, int prn) { epochNavOrganizerSTO(block, system, prn, nav); } },
+	{ "EOP", ' ', "", 3, [](Rinex3Nav& nav, const string* block, char system, int prn) { epochNavOrganizerEOP(block, system, prn, nav); } },
+	{ "ION", 'E', "IFNV", 2, [](Rinex3Nav& nav, const string* block, char system, int prn) { epochNavOrganizerION(block, 2, system, prn, Rinex3Nav::ION_NEQUICK_G, nav); } },
+	{ "ION", 'C', "CNVX", 3, [](Rinex3Nav& nav, const string* block, char system, int prn) { epochNavOrganizerION(block, 3, system, prn, Rinex3Nav::ION_BDGIM, nav); } },
+	{ "ION", ' ', "", 3, [](Rinex3Nav& nav, const string* block, char system, int prn) { epochNavOrganizerION(block, 3, system, prn, Rinex3Nav::ION_KLOBUCHAR, nav); } }
+};
+
+// Kind of the record of a "> " line, null for the kinds that are not read
+// > EPH G01 LNAV (A1,1X,A3,1X,A3,1X,A4)
+static const Record4Kind* record4Kind(string_view head, char system) {
+	string_view type = textField(head, 2, 3), message = textField(head, 10, 4);
+	for (const Record4Kind& kind : RECORD4_KINDS) {
+		if (type == kind.type && (kind.system == ' ' || kind.system == system) && (kind.message[0] == '\0' || message == kind.message)) {
+			return &kind;
 		}
-		// Finding Ionophseric Constants as per new format
-		else if (found_IONO != string::npos) {
-			size_t found_GPSA = line.find(sTokenGPSA);
-			size_t found_GPSB = line.find(sTokenGPSB);
-			if (found_GPSA != string::npos) {
-				_headerGPS.ialpha = headerHelperGPS(line);
-			}
-			if (found_GPSB != string::npos) {
-				_headerGPS.ibeta = headerHelperGPS(line);
-			}
+	}
+	return nullptr;
+}
+
+// Reads the next Rinex 4 record, its "> " line into head and the lines up to the next "> " line into block
+// Blank lines are skipped, block grows to the longest record and its strings are reused
+static bool readRecord4(std::istream& infile, string& head, vector<string>& block, size_t& nLines) {
+	do {
+		if (!readLine(infile, head)) { return false; }
+	} while (head.empty() || head[0] != '>');
+	nLines = 0;
+	for (int next = infile.peek(); next != '>' && next != char_traits<char>::eof(); next = infile.peek()) {
+		if (nLines == block.size()) { block.emplace_back(); }
+		if (!readLine(infile, block[nLines])) { break; }
+		if (block[nLines].find_first_not_of(" \r") != string::npos) { nLines++; }
+	}
+	return true;
+}
+
+// Every record is framed by its "> " line, so kinds that are not read or are cut short cannot shift the next ones
+void Rinex3Nav::readRecords4(std::istream& infile) {
+	string head;
+	vector<string> block(10);
+	size_t nLines = 0;
+	while (readRecord4(infile, head, block, nLines)) {
+		char system = (head.size() > 6) ? head[6] : ' ';
+		const Record4Kind* kind = record4Kind(head, system);
+		if (kind == nullptr) { continue; }
+		if (nLines < kind->nLines) {
+			RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+			continue;
 		}
-		// Finding GPS to UTC Time Correction
-		else if (found_CORR != string::npos) {
-			size_t found_GPUT = line.find("GPUT");
-			_headerGPS.GPUT = headerHelperGPS(line);
+		kind->decode(*this, block.data(), system, intField(head, 7, 2));
+	}
+}
+// Floating point navigation parameters of each system in the order they are cached, the week is cached apart
+static double Rinex3Nav::DataGPS::* const CACHE_FIELDS_GPS[] = {
+	&Rinex3Nav::DataGPS::clockBias, &Rinex3Nav::DataGPS::clockDrift, &Rinex3Nav::DataGPS::clockDriftRate,
+	&Rinex3Nav::DataGPS::IODE, &Rinex3Nav::DataGPS::Crs, &Rinex3Nav::DataGPS::Delta_n, &Rinex3Nav::DataGPS::Mo,
+	&Rinex3Nav::DataGPS::Cuc, &Rinex3Nav::DataGPS::Eccentricity, &Rinex3Nav::DataGPS::Cus, &Rinex3Nav::DataGPS::Sqrt_a,
+	&Rinex3Nav::DataGPS::TOE, &Rinex3Nav::DataGPS::Cic, &Rinex3Nav::DataGPS::OMEGA, &Rinex3Nav::DataGPS::CIS,
+	&Rinex3Nav::DataGPS::Io, &Rinex3Nav::DataGPS::Crc, &Rinex3Nav::DataGPS::Omega, &Rinex3Nav::DataGPS::Omega_dot,
+	&Rinex3Nav::DataGPS::IDOT, &Rinex3Nav::DataGPS::L2_codes_channel, &Rinex3Nav::DataGPS::L2_P_data_flag, &Rinex3Nav::DataGPS::svAccuracy, &Rinex3Nav::DataGPS::svHealth,
+	&Rinex3Nav::DataGPS::TGD, &Rinex3Nav::DataGPS::IODC, &Rinex3Nav::DataGPS::transmission_time,
+	&Rinex3Nav::DataGPS::fit_interval
+};
+static double Rinex3Nav::DataGLO::* const CACHE_FIELDS_GLO[] = {
+	&Rinex3Nav::DataGLO::clockBias, &Rinex3Nav::DataGLO::relFreqBias, &Rinex3Nav::DataGLO::messageFrameTime,
+	&Rinex3Nav::DataGLO::satPosX, &Rinex3Nav::DataGLO::satVelX, &Rinex3Nav::DataGLO::satAccX,
+	&Rinex3Nav::DataGLO::satHealth, &Rinex3Nav::DataGLO::satPosY, &Rinex3Nav::DataGLO::satVelY,
+	&Rinex3Nav::DataGLO::satAccZ, &Rinex3Nav::DataGLO::freqNum, &Rinex3Nav::DataGLO::satPosZ,
+	&Rinex3Nav::DataGLO::satVelZ, &Rinex3Nav::DataGLO::satAccY, &Rinex3Nav::DataGLO::infoAge
+};
+static double Rinex3Nav::DataGAL::* const CACHE_FIELDS_GAL[] = {
+	&Rinex3Nav::DataGAL::clockBias, &Rinex3Nav::DataGAL::clockDrift, &Rinex3Nav::DataGAL::clockDriftRate,
+	&Rinex3Nav::DataGAL::IOD, &Rinex3Nav::DataGAL::Crs, &Rinex3Nav::DataGAL::Delta_n, &Rinex3Nav::DataGAL::Mo,
+	&Rinex3Nav::DataGAL::Cuc, &Rinex3Nav::DataGAL::Eccentricity, &Rinex3Nav::DataGAL::Cus, &Rinex3Nav::DataGAL::Sqrt_a,
+	&Rinex3Nav::DataGAL::TOE, &Rinex3Nav::DataGAL::Cic, &Rinex3Nav::DataGAL::OMEGA, &Rinex3Nav::DataGAL::CIS,
+	&Rinex3Nav::DataGAL::Io, &Rinex3Nav::DataGAL::Crc, &Rinex3Nav::DataGAL::Omega, &Rinex3Nav::DataGAL::Omega_dot,
+	&Rinex3Nav::DataGAL::IDOT, &Rinex3Nav::DataGAL::SISA, &Rinex3Nav::DataGAL::svHealth,
+	&Rinex3Nav::DataGAL::BGD_E5a, &Rinex3Nav::DataGAL::BGD_E5b, &Rinex3Nav::DataGAL::transmission_time
+};
+static double Rinex3Nav::DataBDS::* const CACHE_FIELDS_BDS[] = {
+	&Rinex3Nav::DataBDS::clockBias, &Rinex3Nav::DataBDS::clockDrift, &Rinex3Nav::DataBDS::clockDriftRate,
+	&Rinex3Nav::DataBDS::AODE, &Rinex3Nav::DataBDS::Crs, &Rinex3Nav::DataBDS::Delta_n, &Rinex3Nav::DataBDS::Mo,
+	&Rinex3Nav::DataBDS::Cuc, &Rinex3Nav::DataBDS::Eccentricity, &Rinex3Nav::DataBDS::Cus, &Rinex3Nav::DataBDS::Sqrt_a,
+	&Rinex3Nav::DataBDS::TOE, &Rinex3Nav::DataBDS::Cic, &Rinex3Nav::DataBDS::OMEGA, &Rinex3Nav::DataBDS::CIS,
+	&Rinex3Nav::DataBDS::Io, &Rinex3Nav::DataBDS::Crc, &Rinex3Nav::DataBDS::Omega, &Rinex3Nav::DataBDS::Omega_dot,
+	&Rinex3Nav::DataBDS::IDOT, &Rinex3Nav::DataBDS::svAccuracy, &Rinex3Nav::DataBDS::SatH1,
+	&Rinex3Nav::DataBDS::TGD1, &Rinex3Nav::DataBDS::TGD2, &Rinex3Nav::DataBDS::transmission_time,
+	&Rinex3Nav::DataBDS::AODC
+};
+static double Rinex3Nav::DataSBS::* const CACHE_FIELDS_SBS[] = {
+	&Rinex3Nav::DataSBS::clockBias, &Rinex3Nav::DataSBS::relFreqBias, &Rinex3Nav::DataSBS::transmission_time,
+	&Rinex3Nav::DataSBS::satPosX, &Rinex3Nav::DataSBS::satVelX, &Rinex3Nav::DataSBS::satAccX,
+	&Rinex3Nav::DataSBS::satHealth, &Rinex3Nav::DataSBS::satPosY, &Rinex3Nav::DataSBS::satVelY,
+	&Rinex3Nav::DataSBS::satAccY, &Rinex3Nav::DataSBS::URA, &Rinex3Nav::DataSBS::satPosZ,
+	&Rinex3Nav::DataSBS::satVelZ, &Rinex3Nav::DataSBS::satAccZ, &Rinex3Nav::DataSBS::IODN
+};
+// QZSS records are cached like GPS ones, NavIC ones keep their IODEC in IODE
+static double Rinex3Nav::DataGPS::* const CACHE_FIELDS_IRN[] = {
+	&Rinex3Nav::DataGPS::clockBias, &Rinex3Nav::DataGPS::clockDrift, &Rinex3Nav::DataGPS::clockDriftRate,
+	&Rinex3Nav::DataGPS::IODE, &Rinex3Nav::DataGPS::Crs, &Rinex3Nav::DataGPS::Delta_n, &Rinex3Nav::DataGPS::Mo,
+	&Rinex3Nav::DataGPS::Cuc, &Rinex3Nav::DataGPS::Eccentricity, &Rinex3Nav::DataGPS::Cus, &Rinex3Nav::DataGPS::Sqrt_a,
+	&Rinex3Nav::DataGPS::TOE, &Rinex3Nav::DataGPS::Cic, &Rinex3Nav::DataGPS::OMEGA, &Rinex3Nav::DataGPS::CIS,
+	&Rinex3Nav::DataGPS::Io, &Rinex3Nav::DataGPS::Crc, &Rinex3Nav::DataGPS::Omega, &Rinex3Nav::DataGPS::Omega_dot,
+	&Rinex3Nav::DataGPS::IDOT, &Rinex3Nav::DataGPS::svAccuracy, &Rinex3Nav::DataGPS::svHealth,
+	&Rinex3Nav::DataGPS::TGD, &Rinex3Nav::DataGPS::transmission_time
+};
+static double Rinex3Nav::DataCNAV::* const CACHE_FIELDS_CNAV[] = {
+	&Rinex3Nav::DataCNAV::clockBias, &Rinex3Nav::DataCNAV::clockDrift, &Rinex3Nav::DataCNAV::clockDriftRate,
+	&Rinex3Nav::DataCNAV::ADOT, &Rinex3Nav::DataCNAV::Crs, &Rinex3Nav::DataCNAV::Delta_n, &Rinex3Nav::DataCNAV::Mo,
+	&Rinex3Nav::DataCNAV::Cuc, &Rinex3Nav::DataCNAV::Eccentricity, &Rinex3Nav::DataCNAV::Cus, &Rinex3Nav::DataCNAV::Sqrt_a,
+	&Rinex3Nav::DataCNAV::TOP, &Rinex3Nav::DataCNAV::Cic, &Rinex3Nav::DataCNAV::OMEGA, &Rinex3Nav::DataCNAV::CIS,
+	&Rinex3Nav::DataCNAV::Io, &Rinex3Nav::DataCNAV::Crc, &Rinex3Nav::DataCNAV::Omega, &Rinex3Nav::DataCNAV::Omega_dot,
+	&Rinex3Nav::DataCNAV::IDOT, &Rinex3Nav::DataCNAV::Delta_n_dot, &Rinex3Nav::DataCNAV::URAI_NED0, &Rinex3Nav::DataCNAV::URAI_NED1,
+	&Rinex3Nav::DataCNAV::URAI_ED, &Rinex3Nav::DataCNAV::svHealth, &Rinex3Nav::DataCNAV::TGD, &Rinex3Nav::DataCNAV::URAI_NED2,
+	&Rinex3Nav::DataCNAV::ISC_L1CA, &Rinex3Nav::DataCNAV::ISC_L2C, &Rinex3Nav::DataCNAV::ISC_L5I5, &Rinex3Nav::DataCNAV::ISC_L5Q5,
+	&Rinex3Nav::DataCNAV::ISC_L1Cd, &Rinex3Nav::DataCNAV::ISC_L1Cp, &Rinex3Nav::DataCNAV::transmission_time
+};
+static double Rinex3Nav::DataBDSCNAV::* const CACHE_FIELDS_BDSCNAV[] = {
+	&Rinex3Nav::DataBDSCNAV::clockBias, &Rinex3Nav::DataBDSCNAV::clockDrift, &Rinex3Nav::DataBDSCNAV::clockDriftRate,
+	&Rinex3Nav::DataBDSCNAV::ADOT, &Rinex3Nav::DataBDSCNAV::Crs, &Rinex3Nav::DataBDSCNAV::Delta_n, &Rinex3Nav::DataBDSCNAV::Mo,
+	&Rinex3Nav::DataBDSCNAV::Cuc, &Rinex3Nav::DataBDSCNAV::Eccentricity, &Rinex3Nav::DataBDSCNAV::Cus, &Rinex3Nav::DataBDSCNAV::Sqrt_a,
+	&Rinex3Nav::DataBDSCNAV::TOE, &Rinex3Nav::DataBDSCNAV::Cic, &Rinex3Nav::DataBDSCNAV::OMEGA, &Rinex3Nav::DataBDSCNAV::CIS,
+	&Rinex3Nav::DataBDSCNAV::Io, &Rinex3Nav::DataBDSCNAV::Crc, &Rinex3Nav::DataBDSCNAV::Omega, &Rinex3Nav::DataBDSCNAV::Omega_dot,
+	&Rinex3Nav::DataBDSCNAV::IDOT, &Rinex3Nav::DataBDSCNAV::Delta_n_dot, &Rinex3Nav::DataBDSCNAV::satType, &Rinex3Nav::DataBDSCNAV::TOP,
+	&Rinex3Nav::DataBDSCNAV::SISAI_oe, &Rinex3Nav::DataBDSCNAV::SISAI_ocb, &Rinex3Nav::DataBDSCNAV::SISAI_oc1, &Rinex3Nav::DataBDSCNAV::SISAI_oc2,
+	&Rinex3Nav::DataBDSCNAV::ISC_B1Cd, &Rinex3Nav::DataBDSCNAV::ISC_B2ad, &Rinex3Nav::DataBDSCNAV::TGD_B1Cp, &Rinex3Nav::DataBDSCNAV::TGD_B2ap,
+	&Rinex3Nav::DataBDSCNAV::TGD_B2bI, &Rinex3Nav::DataBDSCNAV::SISMAI, &Rinex3Nav::DataBDSCNAV::svHealth,
+	&Rinex3Nav::DataBDSCNAV::integrityFlags, &Rinex3Nav::DataBDSCNAV::IODC, &Rinex3Nav::DataBDSCNAV::IODE,
+	&Rinex3Nav::DataBDSCNAV::transmission_time
+};
+
+// One cached navigation record, fixed size for each system
+template <size_t N>
+struct NavCacheRecord {
+	int32_t prn;
+	int32_t isAvailable;
+	int64_t gpsTime;
+	int32_t week;
+	int32_t reserved;
+	double parameters[N];
+};
+
+// Records of one PRN in the records section
+struct NavCacheIndex {
+	int32_t prn;
+	uint32_t count;
+	uint64_t first;
+};
+
+// Adds the records of one system and their per-PRN index to a cache
+template <typename Eph, size_t N>
+static void cacheNav(CacheWriter& cache, uint32_t recordsId, uint32_t indexId,
+	const map<int, vector<Eph>>& nav, double Eph::* const (&fields)[N], int Eph::* week) {
+	vector<NavCacheRecord<N>> records;
+	vector<NavCacheIndex> index;
+	for (const auto& prnNav : nav) {
+		NavCacheIndex entry = { prnNav.first, static_cast<uint32_t>(prnNav.second.size()), records.size() };
+		index.push_back(entry);
+		for (const Eph& eph : prnNav.second) {
+			NavCacheRecord<N> record = {};
+			record.prn = eph.PRN;
+			record.isAvailable = eph.isAvailable ? 1 : 0;
+			record.gpsTime = eph.gpsTime.nanoseconds();
+			record.week = (week != nullptr) ? eph.*week : 0;
+			for (size_t i = 0; i < N; i++) { record.parameters[i] = eph.*fields[i]; }
+			records.push_back(record);
 		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
+	}
+	cache.add(recordsId, records);
+	cache.add(indexId, index);
+}
+
+// Rebuilds the records of one system from a cache
+template <typename Eph, size_t N>
+static bool uncacheNav(const CacheReader& cache, uint32_t recordsId, uint32_t indexId,
+	map<int, vector<Eph>>& nav, double Eph::* const (&fields)[N], int Eph::* week) {
+	Span<NavCacheRecord<N>> records = cache.records<NavCacheRecord<N>>(recordsId);
+	Span<NavCacheIndex> index = cache.records<NavCacheIndex>(indexId);
+	if (!cache.has(indexId)) { return false; }
+	nav.clear();
+	for (const NavCacheIndex& entry : index) {
+		if (entry.first + entry.count > records.size) { return false; }
+		vector<Eph>& ephemerides = nav[entry.prn];
+		ephemerides.resize(entry.count);
+		for (size_t j = 0; j < entry.count; j++) {
+			const NavCacheRecord<N>& record = records[entry.first + j];
+			Eph& eph = ephemerides[j];
+			eph.PRN = record.prn;
+			eph.isAvailable = record.isAvailable != 0;
+			eph.gpsTime = GpsTime::fromNanoseconds(record.gpsTime);
+			if (week != nullptr) { eph.*week = record.week; }
+			for (size_t i = 0; i < N; i++) { eph.*fields[i] = record.parameters[i]; }
 		}
 	}
+	return true;
+}
 
-	// Create GPS Navigation data holder
-	map<int, vector<Rinex3Nav::DataGPS>> mapGPS;
-	map<int, vector<Rinex3Nav::DataGLO>> mapGLO;
-	map<int, vector<Rinex3Nav::DataGAL>> mapGAL;
+// Parameters of the Rinex 4 STO and EOP records in the order they are cached
+static double Rinex3Nav::DataSTO::* const CACHE_FIELDS_STO[] = {
+	&Rinex3Nav::DataSTO::tTot, &Rinex3Nav::DataSTO::A0, &Rinex3Nav::DataSTO::A1, &Rinex3Nav::DataSTO::A2
+};
+static double Rinex3Nav::DataEOP::* const CACHE_FIELDS_EOP[] = {
+	&Rinex3Nav::DataEOP::xp, &Rinex3Nav::DataEOP::dxp, &Rinex3Nav::DataEOP::ddxp,
+	&Rinex3Nav::DataEOP::yp, &Rinex3Nav::DataEOP::dyp, &Rinex3Nav::DataEOP::ddyp,
+	&Rinex3Nav::DataEOP::tTot, &Rinex3Nav::DataEOP::dUT1, &Rinex3Nav::DataEOP::ddUT1, &Rinex3Nav::DataEOP::dddUT1
+};
+
+// One cached Rinex 4 STO, EOP or ION record, fixed size and free of padding
+// model is the ION model, code the STO time offset type, both are zero for the other records
+template <size_t N>
+struct NavCacheMessage {
+	int32_t prn;
+	int32_t system;
+	int64_t gpsTime;
+	int32_t model;
+	char code[4];
+	double parameters[N];
+};
+
+// Parameters of each record type to and from its cache record
+static void cacheParameters(const Rinex3Nav::DataSTO& STO, NavCacheMessage<4>& record) {
+	memcpy(record.code, STO.type, sizeof(record.code));
+	for (size_t i = 0; i < 4; i++) { record.parameters[i] = STO.*CACHE_FIELDS_STO[i]; }
+}
+static void uncacheParameters(const NavCacheMessage<4>& record, Rinex3Nav::DataSTO& STO) {
+	memcpy(STO.type, record.code, sizeof(record.code));
+	for (size_t i = 0; i < 4; i++) { STO.*CACHE_FIELDS_STO[i] = record.parameters[i]; }
+}
+static void cacheParameters(const Rinex3Nav::DataEOP& EOP, NavCacheMessage<10>& record) {
+	for (size_t i = 0; i < 10; i++) { record.parameters[i] = EOP.*CACHE_FIELDS_EOP[i]; }
+}
+static void uncacheParameters(const NavCacheMessage<10>& record, Rinex3Nav::DataEOP& EOP) {
+	for (size_t i = 0; i < 10; i++) { EOP.*CACHE_FIELDS_EOP[i] = record.parameters[i]; }
+}
+static void cacheParameters(const Rinex3Nav::DataION& ION, NavCacheMessage<9>& record) {
+	record.model = ION.model;
+	for (size_t i = 0; i < 9; i++) { record.parameters[i] = ION.coefficients[i]; }
+}
+static void uncacheParameters(const NavCacheMessage<9>& record, Rinex3Nav::DataION& ION) {
+	ION.model = record.model;
+	for (size_t i = 0; i < 9; i++) { ION.coefficients[i] = record.parameters[i]; }
+}
 
-	// Reading Navigation Data Body
-	while (!(infile >> std::ws).eof()) {
-		// *** Deal with end of file error
-		if (infile.fail()) { break; }
-		// ***
-
-		// Temporarily store line from input file
-		line.clear();
-		getline(infile, line, '\n');
-
-		// Constellation identifier
-		string ID = line.substr(0, 1);
-
-		// GPS
-		if(ID.find('G') != std::string::npos) {
-			nlines = 0;
-			while ((!(infile >> std::ws).eof()) || (nlines <= 8)) {
-				// *** Deal with end of file error
-				if (infile.fail()) { break; }
-				// ***
-
-				if (line.find_first_not_of(' ') == string::npos) { continue; }
-				block.push_back(line); nlines++;
-
-				// New block of navigation message
-				if (nlines == 8) {
-					// Now we must process the block of lines
-					Rinex3Nav::DataGPS GPS = epochNavOrganizerGPS(block);
-					block.clear(); line.clear();
-					// Add organized data to data holder
-					// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-					// Else add new PRN as key and GPS data structure as Value
-					if (mapGPS.find(GPS.PRN) == mapGPS.end()) {
-						// not found, therefore insert PRN and corresponding value
-						vector<DataGPS> mapNavVector; mapNavVector.push_back(GPS);
-						mapGPS.insert(pair<int, vector<DataGPS>>(GPS.PRN, mapNavVector));
-					}
-					else {
-						// found, therefore add to existing PRN
-						mapGPS[GPS.PRN].push_back(GPS);
-					}
-					break;
-				}
-				if (nlines < 8) {
-					line.clear();
-					getline(infile, line, '\n');
-				}
-			}
-		}
+// Adds the records of one Rinex 4 record type to a cache, in file order
+template <size_t N, typename Msg>
+static void cacheMessages(CacheWriter& cache, uint32_t id, const vector<Msg>& messages) {
+	vector<NavCacheMessage<N>> records;
+	records.reserve(messages.size());
+	for (const Msg& msg : messages) {
+		NavCacheMessage<N> record = {};
+		record.prn = msg.PRN;
+		record.system = msg.system;
+		record.gpsTime = msg.gpsTime.nanoseconds();
+		cacheParameters(msg, record);
+		records.push_back(record);
+	}
+	cache.add(id, records);
+}
 
-		// GALILEO
-		if (ID.find('E') != std::string::npos) {
-			nlines = 0;
-			while ((!(infile >> std::ws).eof()) || (nlines <= 8)) {
-				// *** Deal with end of file error
-				if (infile.fail()) { break; }
-				// ***
-
-				if (line.find_first_not_of(' ') == string::npos) { continue; }
-				block.push_back(line); nlines++;
-
-				// New block of navigation message
-				if (nlines == 8) {
-					// Now we must process the block of lines
-					Rinex3Nav::DataGAL GAL = epochNavOrganizerGAL(block);
-					block.clear(); line.clear(); 
-					// Add organized data to data holder
-					// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-					// Else add new PRN as key and GAL data structure as Value
-					if (mapGAL.find(GAL.PRN) == mapGAL.end()) {
-						// not found, therefore insert PRN and corresponding value
-						vector<DataGAL> mapNavVector; mapNavVector.push_back(GAL);
-						mapGAL.insert(pair<int, vector<DataGAL>>(GAL.PRN, mapNavVector));
-					}
-					else {
-						// found, therefore add to existing PRN
-						mapGAL[GAL.PRN].push_back(GAL);
-					}
-					break;
-				}
-				if (nlines < 8) {
-					line.clear();
-					getline(infile, line, '\n');
-				}
-			}
-		}
+// Rebuilds the records of one Rinex 4 record type from a cache
+template <size_t N, typename Msg>
+static bool uncacheMessages(const CacheReader& cache, uint32_t id, vector<Msg>& messages) {
+	if (!cache.has(id)) { return false; }
+	Span<NavCacheMessage<N>> records = cache.records<NavCacheMessage<N>>(id);
+	messages.assign(records.size, Msg());
+	for (size_t j = 0; j < records.size; j++) {
+		const NavCacheMessage<N>& record = records[j];
+		Msg& msg = messages[j];
+		msg.PRN = record.prn;
+		msg.system = static_cast<char>(record.system);
+		msg.gpsTime = GpsTime::fromNanoseconds(record.gpsTime);
+		uncacheParameters(record, msg);
+	}
+	return true;
+}
 
-		// GLONASS
-		if (ID.find('R') != std::string::npos) {
-			nlines = 0;
-			while ((!(infile >> std::ws).eof()) || (nlines <= 4)) {
-				// *** Deal with end of file error
-				if (infile.fail()) { break; }
-				// ***
-
-				if (line.find_first_not_of(' ') == string::npos) { continue; }
-				block.push_back(line); nlines++;
-
-				// New block of navigation message
-				if (nlines == 4) {
-					// Now we must process the block of lines
-					Rinex3Nav::DataGLO GLO = epochNavOrganizerGLO(block);
-					block.clear(); line.clear();
-					// Add organized data to data holder
-					// Save to Map: if PRN exists in map, then add NavInfo to vector of structs
-					// Else add new PRN as key and GLO data structure as Value
-					if (mapGLO.find(GLO.PRN) == mapGLO.end()) {
-						// not found, therefore insert PRN and corresponding value
-						vector<DataGLO> mapNavVector; mapNavVector.push_back(GLO);
-						mapGLO.insert(pair<int, vector<DataGLO>>(GLO.PRN, mapNavVector));
-					}
-					else {
-						// found, therefore add to existing PRN
-						mapGLO[GLO.PRN].push_back(GLO);
-					}
-					break;
-				}
-				if (nlines < 4) {
-					line.clear();
-					getline(infile, line, '\n');
-				}
-			}
-		}
+// Writes the navigation data and the header to a cache file stamped with the source file
+bool Rinex3Nav::saveCache(const std::string& cacheFile, const std::string& sourceFile) const {
+	CacheWriter cache(CACHE_NAV3);
+	cacheNav(cache, SEC_NAV_GPS, SEC_NAV_INDEX_GPS, _navGPS, CACHE_FIELDS_GPS, &Rinex3Nav::DataGPS::GPS_week);
+	cacheNav(cache, SEC_NAV_GLO, SEC_NAV_INDEX_GLO, _navGLO, CACHE_FIELDS_GLO, static_cast<int Rinex3Nav::DataGLO::*>(nullptr));
+	cacheNav(cache, SEC_NAV_GAL, SEC_NAV_INDEX_GAL, _navGAL, CACHE_FIELDS_GAL, &Rinex3Nav::DataGAL::GAL_week);
+	cacheNav(cache, SEC_NAV_BDS, SEC_NAV_INDEX_BDS, _navBDS, CACHE_FIELDS_BDS, &Rinex3Nav::DataBDS::BDT_week);
+	cacheNav(cache, SEC_NAV_QZS, SEC_NAV_INDEX_QZS, _navQZS, CACHE_FIELDS_GPS, &Rinex3Nav::DataGPS::GPS_week);
+	cacheNav(cache, SEC_NAV_SBS, SEC_NAV_INDEX_SBS, _navSBS, CACHE_FIELDS_SBS, static_cast<int Rinex3Nav::DataSBS::*>(nullptr));
+	cacheNav(cache, SEC_NAV_IRN, SEC_NAV_INDEX_IRN, _navIRN, CACHE_FIELDS_IRN, &Rinex3Nav::DataGPS::GPS_week);
+	cacheNav(cache, SEC_NAV_CNAV_GPS, SEC_NAV_INDEX_CNAV_GPS, _cnavGPS, CACHE_FIELDS_CNAV, &Rinex3Nav::DataCNAV::WN_op);
+	cacheNav(cache, SEC_NAV_CNAV_QZS, SEC_NAV_INDEX_CNAV_QZS, _cnavQZS, CACHE_FIELDS_CNAV, &Rinex3Nav::DataCNAV::WN_op);
+	cacheNav(cache, SEC_NAV_CNAV_BDS, SEC_NAV_INDEX_CNAV_BDS, _cnavBDS, CACHE_FIELDS_BDSCNAV, static_cast<int Rinex3Nav::DataBDSCNAV::*>(nullptr));
+	// Rinex 4 records with no PRN index
+	cacheMessages<4>(cache, SEC_NAV_STO, _navSTO);
+	cacheMessages<10>(cache, SEC_NAV_EOP, _navEOP);
+	cacheMessages<9>(cache, SEC_NAV_ION, _navION);
+	cache.add(SEC_NAV_IALPHA, _headerGPS.ialpha);
+	cache.add(SEC_NAV_IBETA, _headerGPS.ibeta);
+	cache.add(SEC_NAV_GPUT, _headerGPS.GPUT);
+	cache.add(SEC_NAV_TIMECORR, _headerGLO.TimeCorr);
+	vector<double> leapSec = { _headerGLO.leapSec, _headerGAL.leapSec };
+	cache.add(SEC_NAV_LEAPSEC, leapSec);
+	return cache.write(cacheFile, sourceFile);
+}
+
+// Reads the navigation data and the header back, false if the cache is missing or stale
+bool Rinex3Nav::loadCache(const std::string& cacheFile, const std::string& sourceFile) {
+	CacheReader cache;
+	if (!cache.open(cacheFile, sourceFile, CACHE_NAV3)) { return false; }
+	vector<double> leapSec;
+	if (!uncacheNav(cache, SEC_NAV_GPS, SEC_NAV_INDEX_GPS, _navGPS, CACHE_FIELDS_GPS, &Rinex3Nav::DataGPS::GPS_week) ||
+		!uncacheNav(cache, SEC_NAV_GLO, SEC_NAV_INDEX_GLO, _navGLO, CACHE_FIELDS_GLO, static_cast<int Rinex3Nav::DataGLO::*>(nullptr)) ||
+		!uncacheNav(cache, SEC_NAV_GAL, SEC_NAV_INDEX_GAL, _navGAL, CACHE_FIELDS_GAL, &Rinex3Nav::DataGAL::GAL_week) ||
+		!uncacheNav(cache, SEC_NAV_BDS, SEC_NAV_INDEX_BDS, _navBDS, CACHE_FIELDS_BDS, &Rinex3Nav::DataBDS::BDT_week) ||
+		!uncacheNav(cache, SEC_NAV_QZS, SEC_NAV_INDEX_QZS, _navQZS, CACHE_FIELDS_GPS, &Rinex3Nav::DataGPS::GPS_week) ||
+		!uncacheNav(cache, SEC_NAV_SBS, SEC_NAV_INDEX_SBS, _navSBS, CACHE_FIELDS_SBS, static_cast<int Rinex3Nav::DataSBS::*>(nullptr)) ||
+		!uncacheNav(cache, SEC_NAV_IRN, SEC_NAV_INDEX_IRN, _navIRN, CACHE_FIELDS_IRN, &Rinex3Nav::DataGPS::GPS_week) ||
+		!uncacheNav(cache, SEC_NAV_CNAV_GPS, SEC_NAV_INDEX_CNAV_GPS, _cnavGPS, CACHE_FIELDS_CNAV, &Rinex3Nav::DataCNAV::WN_op) ||
+		!uncacheNav(cache, SEC_NAV_CNAV_QZS, SEC_NAV_INDEX_CNAV_QZS, _cnavQZS, CACHE_FIELDS_CNAV, &Rinex3Nav::DataCNAV::WN_op) ||
+		!uncacheNav(cache, SEC_NAV_CNAV_BDS, SEC_NAV_INDEX_CNAV_BDS, _cnavBDS, CACHE_FIELDS_BDSCNAV, static_cast<int Rinex3Nav::DataBDSCNAV::*>(nullptr)) ||
+		!uncacheMessages<4>(cache, SEC_NAV_STO, _navSTO) ||
+		!uncacheMessages<10>(cache, SEC_NAV_EOP, _navEOP) ||
+		!uncacheMessages<9>(cache, SEC_NAV_ION, _navION) ||
+		!cache.get(SEC_NAV_LEAPSEC, leapSec) || leapSec.size() != 2) {
+		_navGPS.clear();
+		_navGLO.clear();
+		_navGAL.clear();
+		_navBDS.clear();
+		_navQZS.clear();
+		_navSBS.clear();
+		_navIRN.clear();
+		_cnavGPS.clear();
+		_cnavQZS.clear();
+		_cnavBDS.clear();
+		_navSTO.clear();
+		_navEOP.clear();
+		_navION.clear();
+		return false;
 	}
+	cache.get(SEC_NAV_IALPHA, _headerGPS.ialpha);
+	cache.get(SEC_NAV_IBETA, _headerGPS.ibeta);
+	cache.get(SEC_NAV_GPUT, _headerGPS.GPUT);
+	cache.get(SEC_NAV_TIMECORR, _headerGLO.TimeCorr);
+	_headerGLO.leapSec = leapSec[0];
+	_headerGAL.leapSec = leapSec[1];
+	return true;
+}
 
-	// Update the attribute of Navigation Objects
-	_navGPS = mapGPS;
-	_navGLO = mapGLO;
-	_navGAL = mapGAL;
-}
\ No newline at end of file
+// Parses the file only when its cache is missing or older than the file
+bool Rinex3Nav::readMixedCached(const std::string& filename, const std::string& cacheFile) {
+	string cachePath = cacheFile.empty() ? defaultCacheFile(filename) : cacheFile;
+	if (loadCache(cachePath, filename)) { return true; }
+	InputStream fin(filename);
+	if (!fin.is_open()) { return false; }
+	readMixed(fin);
+	// A cache that cannot be written only costs the next run a parse
+	saveCache(cachePath, filename);
+	return true;
+}
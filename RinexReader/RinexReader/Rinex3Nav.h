@@ -1,7 +1,7 @@
 #pragma once
 /*
 * Rinex3Nav.h
-* Read and organize Rinex v3 ephemeris file in epochwise manner
+* Read and organize Rinex v3 and v4 ephemeris file in epochwise manner
 *  Created on: Jun 12, 2018
 *  Updated on: January 26, 2019
 *      Author: Aaron Boda
@@ -10,6 +10,8 @@
 #include "pch.h"
 #include "TimeUtils.h"
 #include "StringUtils.h"
+#include "RinexHeader.h"
+#include <type_traits>
 
 #ifndef RINEX3NAV_H_
 #define RINEX3NAV_H_
@@ -23,11 +25,14 @@ public:
 	~Rinex3Nav();
 
 	// Data Structures
+	// Ephemeris records are plain fixed size structures (trivially copyable), stored contiguously per satellite
+	// QZSS and NavIC records have the GPS layout and are kept in DataGPS, NavIC leaves the fields it does not
+	// broadcast (L2 codes and flag, IODC, fit interval) at zero and gives its IODEC in IODE
 	struct DataGPS {
 		bool isAvailable;
 		int PRN;
-		std::vector<double> epochInfo;
-		double gpsTime;
+		// Epoch of the record (time of clock) in the GPS time scale
+		GpsTime gpsTime;
 		double clockBias; 
 		double clockDrift; 
 		double clockDriftRate; 
@@ -49,7 +54,7 @@ public:
 		double Omega_dot;  
 		double IDOT;  
 		double L2_codes_channel;  
-		double GPS_week;  
+		int GPS_week;
 		double L2_P_data_flag;  
 		double svAccuracy;  
 		double svHealth;  
@@ -62,8 +67,8 @@ public:
 	struct DataGLO {
 		bool isAvailable;
 		int PRN;
-		std::vector<double> epochInfo;
-		double gpsTime;
+		// Epoch of the record (time of clock) in the GPS time scale
+		GpsTime gpsTime;
 		double clockBias;
 		double relFreqBias;
 		double messageFrameTime;
@@ -84,8 +89,8 @@ public:
 	struct DataGAL {
 		bool isAvailable;
 		int PRN;
-		std::vector<double> epochInfo;
-		double gpsTime;
+		// Epoch of the record (time of clock) in the GPS time scale
+		GpsTime gpsTime;
 		double clockBias; 
 		double clockDrift; 
 		double clockDriftRate;
@@ -106,7 +111,7 @@ public:
 		double Omega;
 		double Omega_dot;
 		double IDOT;
-		double GAL_week;
+		int GAL_week;
 		double SISA;
 		double svHealth;
 		double BGD_E5a;
@@ -114,6 +119,199 @@ public:
 		double transmission_time;
 	}; struct dataGAL;
 
+	struct DataBDS {
+		bool isAvailable;
+		int PRN;
+		// Epoch of the record (time of clock) in the GPS time scale, the file gives it in BeiDou Time
+		GpsTime gpsTime;
+		double clockBias;
+		double clockDrift;
+		double clockDriftRate;
+		double AODE;
+		double Crs;
+		double Delta_n;
+		double Mo;
+		double Cuc;
+		double Eccentricity;
+		double Cus;
+		double Sqrt_a;
+		// Seconds of the BDT week
+		double TOE;
+		double Cic;
+		double OMEGA;
+		double CIS;
+		double Io;
+		double Crc;
+		double Omega;
+		double Omega_dot;
+		double IDOT;
+		int BDT_week;
+		double svAccuracy;
+		double SatH1;
+		double TGD1;
+		double TGD2;
+		double transmission_time;
+		double AODC;
+	};
+
+	// SBAS records are state vectors like the GLONASS ones, epochs in the GPS time scale
+	struct DataSBS {
+		bool isAvailable;
+		int PRN;
+		GpsTime gpsTime;
+		double clockBias;
+		double relFreqBias;
+		double transmission_time;
+		double satPosX;
+		double satVelX;
+		double satAccX;
+		double satHealth;
+		double satPosY;
+		double satVelY;
+		double satAccY;
+		double URA;
+		double satPosZ;
+		double satVelZ;
+		double satAccZ;
+		double IODN;
+	};
+
+	// * Rinex 4 messages, each record starts with a "> EPH G01 LNAV" line giving its type, satellite and message
+	// LNAV, INAV/FNAV, D1/D2, FDMA and SBAS ephemerides are the Rinex 3 records and go to the same maps
+	// Modernized GPS and QZSS ephemerides (CNAV, CNV2), CNV2 adds the L1C group delays
+	struct DataCNAV {
+		bool isAvailable;
+		int PRN;
+		// Epoch of the record (time of clock, also time of ephemeris) in the GPS time scale
+		GpsTime gpsTime;
+		double clockBias;
+		double clockDrift;
+		double clockDriftRate;
+		double ADOT;
+		double Crs;
+		double Delta_n;
+		double Mo;
+		double Cuc;
+		double Eccentricity;
+		double Cus;
+		double Sqrt_a;
+		double TOP;
+		double Cic;
+		double OMEGA;
+		double CIS;
+		double Io;
+		double Crc;
+		double Omega;
+		double Omega_dot;
+		double IDOT;
+		double Delta_n_dot;
+		double URAI_NED0;
+		double URAI_NED1;
+		double URAI_ED;
+		double svHealth;
+		double TGD;
+		double URAI_NED2;
+		double ISC_L1CA;
+		double ISC_L2C;
+		double ISC_L5I5;
+		double ISC_L5Q5;
+		double ISC_L1Cd;
+		double ISC_L1Cp;
+		double transmission_time;
+		int WN_op;
+	};
+
+	// Modernized BEIDOU ephemerides (CNV1 on B1C, CNV2 on B2a, CNV3 on B2b), epochs converted from BDT
+	// Group delays a message does not carry are left at zero
+	struct DataBDSCNAV {
+		bool isAvailable;
+		int PRN;
+		GpsTime gpsTime;
+		double clockBias;
+		double clockDrift;
+		double clockDriftRate;
+		double ADOT;
+		double Crs;
+		double Delta_n;
+		double Mo;
+		double Cuc;
+		double Eccentricity;
+		double Cus;
+		double Sqrt_a;
+		double TOE;
+		double Cic;
+		double OMEGA;
+		double CIS;
+		double Io;
+		double Crc;
+		double Omega;
+		double Omega_dot;
+		double IDOT;
+		double Delta_n_dot;
+		// 1 GEO, 2 IGSO, 3 MEO
+		double satType;
+		double TOP;
+		double SISAI_oe;
+		double SISAI_ocb;
+		double SISAI_oc1;
+		double SISAI_oc2;
+		double ISC_B1Cd;
+		double ISC_B2ad;
+		double TGD_B1Cp;
+		double TGD_B2ap;
+		double TGD_B2bI;
+		double SISMAI;
+		double svHealth;
+		double integrityFlags;
+		double IODC;
+		double IODE;
+		double transmission_time;
+	};
+
+	// System time offset (STO), offset = A0 + A1 (t - tTot) + A2 (t - tTot)^2
+	struct DataSTO {
+		char system;
+		int PRN;
+		// Transmission time of the message
+		GpsTime gpsTime;
+		// Time offset type, for eg: GPUT, GAGP, BDUT
+		char type[5];
+		double tTot;
+		double A0;
+		double A1;
+		double A2;
+	};
+
+	// Earth orientation parameters (EOP), pole coordinates and UT1-UTC with their rates
+	struct DataEOP {
+		char system;
+		int PRN;
+		GpsTime gpsTime;
+		double xp;
+		double dxp;
+		double ddxp;
+		double yp;
+		double dyp;
+		double ddyp;
+		double tTot;
+		double dUT1;
+		double ddUT1;
+		double dddUT1;
+	};
+
+	// Ionospheric model parameters (ION), the meaning of the coefficients depends on the model
+	//  ION_KLOBUCHAR: alpha0-3, beta0-3, region code
+	//  ION_NEQUICK_G: ai0-2, disturbance flags
+	//  ION_BDGIM: alpha1-9
+	enum IonModel { ION_KLOBUCHAR, ION_NEQUICK_G, ION_BDGIM };
+	struct DataION {
+		char system;
+		int PRN;
+		GpsTime gpsTime;
+		int model;
+		double coefficients[9];
+	};
+
 	struct HeaderGPS {
 		// Ionospheric alpha and beta constants
 		std::vector<double> ialpha;
@@ -125,12 +323,12 @@ public:
 	struct HeaderGLO {
 		// Time System correction
 		std::vector<double> TimeCorr;
-		double leapSec;
+		double leapSec = 0;
 	};
 
 	struct HeaderGAL {
 		// Time System correction
-		double leapSec;
+		double leapSec = 0;
 	};
 
 	// Attributes
@@ -139,21 +337,59 @@ public:
 	std::map<int, std::vector<Rinex3Nav::DataGPS>> _navGPS;
 	std::map<int, std::vector<Rinex3Nav::DataGLO>> _navGLO;
 	std::map<int, std::vector<Rinex3Nav::DataGAL>> _navGAL;
+	std::map<int, std::vector<Rinex3Nav::DataBDS>> _navBDS;
+	std::map<int, std::vector<Rinex3Nav::DataGPS>> _navQZS;
+	std::map<int, std::vector<Rinex3Nav::DataSBS>> _navSBS;
+	std::map<int, std::vector<Rinex3Nav::DataGPS>> _navIRN;
+	std::map<int, std::vector<Rinex3Nav::DataCNAV>> _cnavGPS;
+	std::map<int, std::vector<Rinex3Nav::DataCNAV>> _cnavQZS;
+	std::map<int, std::vector<Rinex3Nav::DataBDSCNAV>> _cnavBDS;
+	// * Rinex 4 system time offsets, earth orientation and ionospheric records in file order
+	std::vector<Rinex3Nav::DataSTO> _navSTO;
+	std::vector<Rinex3Nav::DataEOP> _navEOP;
+	std::vector<Rinex3Nav::DataION> _navION;
 
 	// * Header information
 	HeaderGPS _headerGPS;
 	HeaderGLO _headerGLO;
 	HeaderGAL _headerGAL;
+	// Rinex version of the last file read, 0 before
+	double _version = 0;
 
 	// Functions
-	void readGPS(std::ifstream& inputfileGPS); // for separate GPS only navigation files
-	void readGLO(std::ifstream& inputfileGLO); // for separate GLO only navigation files
-	void readGAL(std::ifstream& inputfileGAL); // for separate GAL only navigation files
-	void readMixed(std::ifstream& inputfileMixed); // for mixed navigation files
-	int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGPS> NAV);
-	int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGAL> NAV);
-	int Rinex3Nav::EpochMatcher(double obsTime, std::vector<Rinex3Nav::DataGLO> NAV);
+	void readGPS(std::istream& inputfileGPS); // for separate GPS only navigation files
+	void readGLO(std::istream& inputfileGLO); // for separate GLO only navigation files
+	void readGAL(std::istream& inputfileGAL); // for separate GAL only navigation files
+	void readMixed(std::istream& inputfileMixed); // for mixed navigation files, Rinex 3 or 4
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGPS>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGAL>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataGLO>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataBDS>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataSBS>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataCNAV>& NAV);
+	int EpochMatcher(GpsTime obsTime, const std::vector<Rinex3Nav::DataBDSCNAV>& NAV);
+	// * Binary cache of the parsed navigation data and header, valid until the source file changes
+	bool saveCache(const std::string& cacheFile, const std::string& sourceFile) const;
+	bool loadCache(const std::string& cacheFile, const std::string& sourceFile);
+	// Mixed navigation file read through its cache, parsed and cached again when the cache is stale
+	bool readMixedCached(const std::string& filename, const std::string& cacheFile = "");
+
+private:
+	void navHeaderRecord(HeaderLabel label, std::string_view line);
+	// Body of a Rinex 4 file, records are framed by their "> " lines and dispatched on them
+	void readRecords4(std::istream& infile);
 
 };
 
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataGPS>::value, "GPS ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataGLO>::value, "GLONASS ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataGAL>::value, "GALILEO ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataBDS>::value, "BEIDOU ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataSBS>::value, "SBAS ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataCNAV>::value, "CNAV ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataBDSCNAV>::value, "BEIDOU CNAV ephemeris must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataSTO>::value, "STO record must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataEOP>::value, "EOP record must stay trivially copyable");
+static_assert(std::is_trivially_copyable<Rinex3Nav::DataION>::value, "ION record must stay trivially copyable");
+
 #endif /* RINEX3NAV_H_ */
@@ -7,293 +7,240 @@
 
 #include "pch.h"
 #include "Rinex3Obs.h"
+#include "FieldParser.h"
+#include "Instrumentation.h"
 using namespace std;
 
 // CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
-Rinex3Obs::Rinex3Obs() {}
+Rinex3Obs::Rinex3Obs() { _EpochObs.clear(); _EpochObs.gpsTime = GpsTime(); }
 Rinex3Obs::~Rinex3Obs() {}
 
 // A function to organize specific observation types (for eg: prn - > pseudorange map) 
 // PRN - > Pseudorange Map is used for satellite position
-map<int, double> Rinex3Obs::specificObsMapper(map<int, vector<double>> obsSAT, vector<string> obsTypes, string specificObs) {
+map<int, double> Rinex3Obs::specificObsMapper(const ObsMatrix& obsSAT, const vector<string>& obsTypes, const string& specificObs) {
 	map<int, double> rangeMap;
-	map<int, vector<double>>::iterator it = obsSAT.begin();
 	size_t ind = std::find(obsTypes.begin(), obsTypes.end(), specificObs) - obsTypes.begin();
-	if (ind >= obsTypes.size()) {
+	if (ind >= obsTypes.size() || static_cast<int>(ind) >= obsSAT.nTypes()) {
 		cout << "Requested C1 Observation is Unavailable" << endl;
 	}
-	else if (ind < obsTypes.size()) {
-		for (it = obsSAT.begin(); it != obsSAT.end(); ++it) {
-			rangeMap.insert(std::pair<int, double>(it->first, it->second.at(ind)));
+	else {
+		for (int row = 0; row < obsSAT.nSats(); row++) {
+			rangeMap.insert(std::pair<int, double>(obsSAT.prn(row), obsSAT.value(row, static_cast<int>(ind))));
 		}
 	}
 	return rangeMap;
 }
 
-// A function to organize observation types as stated in header of rinex observation file 
-map<string, vector<string>> obsTypesHeader(vector<string> block) {
-	// Initializing variables to hold information
-	map<string, vector<string>> types;
-	// Satellite system identifier
-	string sys;
-	// Number of observation types
-	int nTypes;
-	// Temporary vars
-	string line; vector<string> temp;
-    for (unsigned int i = 0; i < block.size(); i++) {
-		line = block[i];
-		// Splitting words in the line
-		istringstream iss(line);
-		vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-		// Challenge is to organize based on satellite system identifier
-		// First letter of line gives the satellite system
-		// If number of types > 13, types extended on next line
-		size_t sLength = words[0].length();
-		if (sLength == 1) {
-			sys = words[0];
-			nTypes = stoi(words[1]);
-			if (nTypes > 13) {
-				i++;
-				line = line + block[i];
-				words.clear();
-				istringstream iss2(line);
-				copy(istream_iterator<string>(iss2), istream_iterator<string>(), back_inserter(words));
-			}
-            for (unsigned int i = 2; i < words.size(); i++) {
-				temp.push_back(words[i]);
-			}
-			types[sys] = temp;
-			temp.clear();
+// Handles a single header line
+void Rinex3Obs::obsHeaderRecord(HeaderLabel label, string_view line) {
+	if (obsHeaderCommon(label, line, _Header)) { return; }
+	// Types of Observations, A1,2X,I3,13(1X,A3)
+	// More than 13 types continue on lines with a blank system
+	if (label == HDR_SYS_OBS_TYPES) {
+		if (line[0] != ' ') {
+			_typesSys.assign(1, line[0]);
+			_Header.obsTypes[_typesSys].clear();
+		}
+		if (_typesSys.empty()) { return; }
+		vector<string>& types = _Header.obsTypes[_typesSys];
+		for (size_t col = 7; col + 3 <= 60 && col < line.size(); col += 4) {
+			string_view code = textField(line, col, 3);
+			if (!code.empty()) { types.emplace_back(code); }
 		}
 	}
-	return types;
 }
 
-// Extracts and stores the header information from Rinex v3 File
-void Rinex3Obs::obsHeader(ifstream& infile) {
-	// String tokens to look for
-	const string sTokenVER = "RINEX VERSION / TYPE";
-	const string sTokenPOS = "APPROX POSITION XYZ";
-	const string sTokenDEL = "ANTENNA: DELTA";
-	const string sTokenOBS = "SYS / # / OBS TYPES";
-	const string sTokenCOM = "COMMENT";
-	const string sTokenFIR = "TIME OF FIRST OBS";
-	const string sTokenLAS = "TIME OF LAST OBS";
-	const string sTokenEND = "END OF HEADER";
-	// A vector to hold block of sentences pertaining to observation types
-	vector<string> types;
-	// To hold contents of a line from input file
-	string line;
-
-	// Reading line by line...
-	while (!infile.eof()) {
-		line.clear();
-		// Temporarily store line from input file
-		getline(infile, line, '\n');
-		// Looking for keywords in Header Part...
-		size_t found_VER = line.find(sTokenVER);
-		size_t found_POS = line.find(sTokenPOS);
-		size_t found_DEL = line.find(sTokenDEL);
-		size_t found_OBS = line.find(sTokenOBS);
-		size_t found_COM = line.find(sTokenCOM);
-		size_t found_FIR = line.find(sTokenFIR);
-		size_t found_LAS = line.find(sTokenLAS);
-		size_t found_END = line.find(sTokenEND);
-
-		// Finding Comments, meaning skip!
-		if (found_COM != string::npos) {
-			continue;
-		}
-		// RINEX Version
-		else if (found_VER != string::npos) {
-			istringstream iss(line);
-			// Rinex type should be stored in 4th word of line
-			vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-			_Header.rinexType = words[3];
-			words.clear();
-		}
-		// Approximate Position
-		else if (found_POS != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_Header.approxPosXYZ));
-			// Adding a term for Clock Offset
-			_Header.approxPosXYZ.push_back(0);
-		}
-		// Antenna Delta
-		else if (found_DEL != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_Header.antDeltaHEN));
-		}
-		// Types of Observations
-		else if (found_OBS != string::npos) {
-			// Removing identifier from block of lines
-			eraseSubStr(line, sTokenOBS);
-			// Storing in vector for processing later
-			types.push_back(line);
-		}
-		// Time of First Obs
-		else if (found_FIR != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_Header.firstObsTime));
-		}
-		// Time of Last Obs
-		else if (found_LAS != string::npos) {
-			istringstream iss(line);
-			copy(istream_iterator<double>(iss),
-				istream_iterator<double>(),
-				back_inserter(_Header.lastObsTime));
-		}
-		// Finding End of Header Info
-		else if (found_END != string::npos) {
-			break;
-		}
-	}
-	// Organizing the observation types
-	_Header.obsTypes = obsTypesHeader(types);
+// Organizing the observation types collected from the header
+void Rinex3Obs::obsHeaderTypes() {
+	_typesSys.clear();
 	if (_Header.obsTypes.count("G") > 0) { _obsTypesGPS = _Header.obsTypes["G"]; }
 	if (_Header.obsTypes.count("R") > 0) { _obsTypesGLO = _Header.obsTypes["R"]; }
 	if (_Header.obsTypes.count("E") > 0) { _obsTypesGAL = _Header.obsTypes["E"]; }
+	if (_Header.obsTypes.count("C") > 0) { _obsTypesBDS = _Header.obsTypes["C"]; }
+	if (_Header.obsTypes.count("J") > 0) { _obsTypesQZS = _Header.obsTypes["J"]; }
+	if (_Header.obsTypes.count("S") > 0) { _obsTypesSBS = _Header.obsTypes["S"]; }
+	if (_Header.obsTypes.count("I") > 0) { _obsTypesIRN = _Header.obsTypes["I"]; }
+	// Size the epoch storage of every system declared in the header
+	for (const auto& sysTypes : _Header.obsTypes) {
+		int sys = systemIndex(sysTypes.first[0]);
+		if (sys < 0) { continue; }
+		_EpochObs.observations[sys].setTypes(static_cast<int>(sysTypes.second.size()));
+		_Header.columns[sys].setTypes(sysTypes.second);
+	}
 }
 
-// Splits Epoch Information
-vector<double> rinex3EpochRecordOrganizer(string line) {
-	vector<double> epochRecord;
-	// Splitting words in the line
-	istringstream iss(line);
-	vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-	for (string s : words) {
-		epochRecord.push_back(stod(s));
+// Extracts and stores the header information from Rinex v3 File
+void Rinex3Obs::obsHeader(istream& infile) {
+	_Header.obsTypes.clear();
+	readHeader(infile, [this](HeaderLabel label, string_view line) { obsHeaderRecord(label, line); });
+	// Organizing the observation types
+	obsHeaderTypes();
+}
+
+// Extracts and stores the header information from a memory mapped Rinex v3 File
+// The text view is advanced to the first line after the header
+void Rinex3Obs::obsHeader(string_view& text) {
+	_Header.obsTypes.clear();
+	readHeader(text, [this](HeaderLabel label, string_view line) { obsHeaderRecord(label, line); });
+	obsHeaderTypes();
+}
+
+// Splits Epoch Information from its fixed columns
+// > yyyy mm dd hh mm ss.sssssss  f nnn      clock-offset
+void rinex3EpochRecordOrganizer(string_view line, vector<double>& epochRecord) {
+	RINEX_TIME(TIME_CONVERT);
+	static const size_t cols[][2] = { {2, 4}, {7, 2}, {10, 2}, {13, 2}, {16, 2}, {18, 11}, {31, 1}, {32, 3}, {41, 15} };
+	epochRecord.clear();
+	for (const auto& col : cols) {
+		if (isBlankField(line, col[0], col[1])) { continue; }
+		epochRecord.push_back(floatField(line, col[0], col[1]));
 	}
-	// Return: Vector containing the Epoch Info
-	return epochRecord;
 }
 
 // Epoch Satellite Observation Data Organizer
-void rinex3SatObsOrganizer(string line, map<string, map<int, vector<double>>>& data) {
+// Observations are written straight into the dense matrix of the satellite system
+void rinex3SatObsOrganizer(string_view line, Rinex3Obs::ObsEpochInfo& obs) {
+	RINEX_TIME(TIME_CONVERT);
+	if (line.size() < 3) { return; }
 	// First word contains satellite system and number
-	string sys = line.substr(0, 1);
-	int prn = stoi(line.substr(1, 2));
-	// Rest of the words should contain observations
-	// Obs format is 14.3, 14 for Obs and 3 for S/N
-	line = line.substr(3, line.length());
-	string word;
-	vector<double> obs;
-	for (unsigned i = 0; i < line.length(); i += 16) {
-		word = line.substr(i, 14);
-		if (word.find_first_not_of(' ') == string::npos) {
-			word = "0";
-		}
-		obs.push_back(stod(word));
-		word.clear();
+	int sys = systemIndex(line[0]);
+	if (sys < 0) {
+		RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+		return;
 	}
-	// Update map data
-	data[sys].insert(make_pair(prn, obs));
-}
-
-// This function is used to organize the string block of epoch info into data structure
-void obsOrganizer(vector<string> block, Rinex3Obs::ObsEpochInfo& obs) {
-	// First line contains epoch time information and receiver clock offset
-	obs.epochRecord = rinex3EpochRecordOrganizer(block[0]);
-	obs.recClockOffset = obs.epochRecord.back();
-	// Organize satellite observations in data structure
-	map<string, map<int, vector<double>>> data;
-	string line;
-    for (unsigned int i = 1; i < block.size(); i++) {
-		line.clear(); line = block[i];
-		rinex3SatObsOrganizer(line, data);
+	int prn = intField(line, 1, 2);
+	ObsMatrix& matrix = obs.observations[sys];
+	// Systems without observation types in the header cannot be organized
+	if (matrix.nTypes() == 0) { return; }
+	int row = matrix.addSat(prn);
+	double* values = matrix.values(row);
+	unsigned char* lli = matrix.lli(row);
+	unsigned char* ss = matrix.ss(row);
+	// Rest of the words should contain observations
+	// Obs format is 14.3 followed by LLI and S/N digits, blank observations are stored as zero
+	for (int k = 0; k < matrix.nTypes(); k++) {
+		size_t col = 3 + static_cast<size_t>(k) * 16;
+		if (col >= line.size()) { break; }
+		values[k] = floatField(line, col, 14);
+		lli[k] = static_cast<unsigned char>(intField(line, col + 14, 1));
+		ss[k] = static_cast<unsigned char>(intField(line, col + 15, 1));
 	}
-	obs.observations = data;
-	obs.numSatsGAL = 0;
-	obs.numSatsGLO = 0;
-	obs.numSatsGPS = 0;
-	map<string, map<int, vector<double>>>::iterator it;
-	it = data.find("E");
-	if (it != data.end()) { obs.numSatsGAL = static_cast<int>(it->second.size()); }
-	it = data.find("R");
-	if (it != data.end()) { obs.numSatsGLO = static_cast<int>(it->second.size()); }
-	it = data.find("G");
-	if (it != data.end()) { obs.numSatsGPS = static_cast<int>(it->second.size()); }
+	obs.sats.push_back(packSat(sys, prn));
+	RINEX_COUNT(COUNT_SATELLITES, 1);
 }
 
-// Setting observation attributes for each satellite constellations
-void Rinex3Obs::setObservations(map<string, map<int, vector<double>>> observations) {
-	if (observations.count("G") > 0) { _obsGPS.clear(); _obsGPS = observations["G"]; }
-	if (observations.count("R") > 0) { _obsGLO.clear(); _obsGLO = observations["R"]; }
-	if (observations.count("E") > 0) { _obsGAL.clear(); _obsGAL = observations["E"]; }
+// Counts satellites per constellation of the organized epoch
+void satCounter(Rinex3Obs::ObsEpochInfo& obs) {
+	RINEX_TIME(TIME_ORGANIZE);
+	obs.numSatsGPS = obs.observations[SYS_GPS].nSats();
+	obs.numSatsGLO = obs.observations[SYS_GLO].nSats();
+	obs.numSatsGAL = obs.observations[SYS_GAL].nSats();
+	obs.numSatsBDS = obs.observations[SYS_BDS].nSats();
+	obs.numSatsQZS = obs.observations[SYS_QZS].nSats();
+	obs.numSatsSBS = obs.observations[SYS_SBS].nSats();
+	obs.numSatsIRN = obs.observations[SYS_IRN].nSats();
 }
 
 // This function extracts and stores epochwise observations from file
-void Rinex3Obs::obsEpoch(ifstream& infile) {
+void Rinex3Obs::obsEpoch(istream& infile) {
 	// Rinex v3 special identifier for new epoch of observations
 	const string sTokenEpoch = ">";
-	// Collect the block of observation lines into a vector
-	int nSatsEpoch = 0; int nLinesEpoch = 0; vector<int> blockFirstLine;
+	RINEX_TIME(TIME_TOKENIZE);
+	// Lines are organized as they are read, straight into the epoch storage
+	int nSatsEpoch = 0; int nLinesEpoch = 0;
+	bool foundEpoch = false;
 	streampos pos;
-	string line;
-	vector<string> block;
+	_EpochObs.clear();
 	// Reading line by line...
 	while (!(infile >> std::ws).eof()) {
 		// *** Deal with end of file error
 		if (infile.fail()) { break; }
 		// ***
-		line.clear();
 		pos = infile.tellg();
 		// Temporarily store line from input file
-		getline(infile, line); nLinesEpoch++;
+		readLine(infile, _line); nLinesEpoch++;
 
-		if (line.find_first_not_of(' ') == string::npos) { continue; }
+		if (_line.find_first_not_of(' ') == string::npos) { continue; }
 		// Look for special identifier in line
-		size_t found_ID = line.find(sTokenEpoch);
+		size_t found_ID = _line.find(sTokenEpoch);
 		if ((found_ID != string::npos)) {
-			if (block.size() == 0) {
-				eraseSubStr(line, sTokenEpoch);
+			if (!foundEpoch) {
 				// Find number of sats in epoch
-				istringstream iss(line);
-				vector<string> words{ istream_iterator<string>{iss}, istream_iterator<string>{} };
-				for (string s : words) {
-					blockFirstLine.push_back(stoi(s));
+				nSatsEpoch = intField(_line, 32, 3);
+				// Event flags above 1 are followed by special records instead of observations
+				// Their time fields may be blank, so the flag is read from its column
+				if (intField(_line, 31, 1) > 1) {
+					for (int i = 0; i < nSatsEpoch && readLine(infile, _line); i++) {}
+					nLinesEpoch = 0;
+					continue;
+				}
+				// First line contains epoch time information and receiver clock offset
+				rinex3EpochRecordOrganizer(_line, _EpochObs.epochRecord);
+				if (_EpochObs.epochRecord.size() < 8) {
+					RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+					_EpochObs.epochRecord.clear(); nLinesEpoch = 0;
+					continue;
 				}
-				nSatsEpoch = blockFirstLine[7];
+				_EpochObs.recClockOffset = _EpochObs.epochRecord.back();
+				foundEpoch = true;
 			}
 			else {
 				infile.seekg(pos);
 				break;
 			}
 		}
-		block.push_back(line);
+		else if (foundEpoch) {
+			rinex3SatObsOrganizer(_line, _EpochObs);
+		}
 		// Fail-safe epoch quitter
 		if (nLinesEpoch == nSatsEpoch+1) { break; }
 	}
-	// Now we must process the block of lines
-	_EpochObs.clear();
-	obsOrganizer(block, _EpochObs);
+	satCounter(_EpochObs);
 	_EpochObs.gpsTime = gpsTime(_EpochObs.epochRecord);
-	// Update observation attributes
-	setObservations(_EpochObs.observations);
+	RINEX_COUNT(COUNT_EPOCHS, 1);
+}
+
+// This function extracts and stores epochwise observations from a memory mapped file
+// Fields are parsed directly from the mapped bytes, the text view is advanced past the epoch
+// Returns false once no more epochs are available
+bool Rinex3Obs::obsEpoch(string_view& text) {
+	RINEX_TIME(TIME_TOKENIZE);
+	string_view line;
+	while (nextLine(text, line)) {
+		// Look for special identifier of a new epoch
+		if (line.empty() || line[0] != '>') { continue; }
+		int nSatsEpoch = intField(line, 32, 3);
+		// Event flags above 1 are followed by special records instead of observations
+		// Their time fields may be blank, so the flag is read from its column
+		if (intField(line, 31, 1) > 1) {
+			for (int i = 0; i < nSatsEpoch && nextLine(text, line); i++) {}
+			continue;
+		}
+		_EpochObs.clear();
+		rinex3EpochRecordOrganizer(line, _EpochObs.epochRecord);
+		if (_EpochObs.epochRecord.size() < 8) {
+			RINEX_COUNT(COUNT_PARSE_FAILURES, 1);
+			continue;
+		}
+		_EpochObs.recClockOffset = _EpochObs.epochRecord.back();
+		// Organize satellite observations in data structure
+		for (int i = 0; i < nSatsEpoch && nextLine(text, line); i++) {
+			rinex3SatObsOrganizer(line, _EpochObs);
+		}
+		satCounter(_EpochObs);
+		_EpochObs.gpsTime = gpsTime(_EpochObs.epochRecord);
+		RINEX_COUNT(COUNT_EPOCHS, 1);
+		return true;
+	}
+	return false;
 }
 
 // To clear contents in observation data structure
 void Rinex3Obs::clear(Rinex3Obs::ObsEpochInfo& obs) {
-	obs.epochRecord.clear();
-	obs.numSatsGAL = NULL;
-	obs.numSatsGLO = NULL;
-	obs.numSatsGPS = NULL;
-	obs.observations.clear();
-	obs.recClockOffset = NULL;
+	obs.clear();
 }
 
 // To clear contents in observation data structure
 void Rinex3Obs::clear(Rinex3Obs::ObsHeaderInfo& header) {
-	header.antDeltaHEN.clear();
-	header.approxPosXYZ.clear();
-	header.firstObsTime.clear();
-	header.lastObsTime.clear();
-	header.obsTypes.clear();
-	header.rinexType.clear();
+	header = Rinex3Obs::ObsHeaderInfo();
 }
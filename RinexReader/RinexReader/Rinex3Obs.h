@@ -10,6 +10,11 @@
 #include "pch.h"
 #include "TimeUtils.h"
 #include "StringUtils.h"
+#include "MappedFile.h"
+#include "GnssSystem.h"
+#include "ObsMatrix.h"
+#include "ObsCode.h"
+#include "RinexHeader.h"
 
 #ifndef RINEX3OBS_H_
 #define RINEX3OBS_H_
@@ -24,30 +29,40 @@ public:
 
 	// DATA STRUCTURES
 	// To store important header information
-	struct ObsHeaderInfo {
-		std::string rinexType;
-		std::vector<double> approxPosXYZ;
-		std::vector<double> antDeltaHEN;
-		std::vector<double> firstObsTime;
-		std::vector<double> lastObsTime;
+	struct ObsHeaderInfo : ObsHeaderCommon {
 		std::map<std::string, std::vector<std::string>> obsTypes;
+		// Column of each observation code per satellite system (GnssSystem), built with obsTypes
+		ObsCodeTable columns[SYS_COUNT];
     };
 	// To store observations in an epoch
+	// Storage is flat and reused, clear() keeps the capacity for the next epoch
 	struct ObsEpochInfo {
 		std::vector<double> epochRecord;
 		double recClockOffset;
-		double gpsTime;
+		GpsTime gpsTime;
 		int numSatsGPS; 
 		int numSatsGLO; 
 		int numSatsGAL;
-		std::map<std::string, std::map<int, std::vector<double>>> observations;
+		int numSatsBDS;
+		int numSatsQZS;
+		int numSatsSBS;
+		int numSatsIRN;
+		// Satellites in file order, system and PRN packed by packSat()
+		std::vector<unsigned short> sats;
+		// Dense [satellite x observation type] matrix per satellite system (GnssSystem)
+		ObsMatrix observations[SYS_COUNT];
 		void clear() {
 			epochRecord.clear();
-			numSatsGAL = NULL;
-			numSatsGLO = NULL;
-			numSatsGPS = NULL;
-			observations.clear();
-			recClockOffset = NULL;
+			numSatsGAL = 0;
+			numSatsGLO = 0;
+			numSatsGPS = 0;
+			numSatsBDS = 0;
+			numSatsQZS = 0;
+			numSatsSBS = 0;
+			numSatsIRN = 0;
+			sats.clear();
+			for (ObsMatrix& matrix : observations) { matrix.clear(); }
+			recClockOffset = 0;
 		}
     };
 
@@ -59,21 +74,30 @@ public:
 	std::vector<std::string> _obsTypesGPS;
 	std::vector<std::string> _obsTypesGLO;
 	std::vector<std::string> _obsTypesGAL;
-
-	// * Epoch observations mapped to PRN for ease of use
-	std::map<int, std::vector<double>> _obsGPS;
-	std::map<int, std::vector<double>> _obsGLO;
-	std::map<int, std::vector<double>> _obsGAL;
+	std::vector<std::string> _obsTypesBDS;
+	std::vector<std::string> _obsTypesQZS;
+	std::vector<std::string> _obsTypesSBS;
+	std::vector<std::string> _obsTypesIRN;
 
 	// Functions
-	void obsHeader(std::ifstream& infile);
-    void obsEpoch(std::ifstream& infile);
+	void obsHeader(std::istream& infile);
+    void obsEpoch(std::istream& infile);
+	// * Memory mapped mode, text is a view over a MappedFile and is advanced while reading
+	void obsHeader(std::string_view& text);
+	bool obsEpoch(std::string_view& text);
 	void clear(Rinex3Obs::ObsEpochInfo& obs);
 	void clear(Rinex3Obs::ObsHeaderInfo& header);
-	void setObservations(std::map<std::string, std::map<int, std::vector<double>>> observations);
-	std::map<int, double> specificObsMapper(std::map<int, std::vector<double>> obsGPS, std::vector<std::string> obsTypes, std::string specificObs);
+	// Copies one observation type into a map, per epoch work should look the column up once in
+	// _Header.columns and read ObsMatrix::column() instead
+	std::map<int, double> specificObsMapper(const ObsMatrix& obsSAT, const std::vector<std::string>& obsTypes, const std::string& specificObs);
 
 private:
+	void obsHeaderRecord(HeaderLabel label, std::string_view line);
+	void obsHeaderTypes();
+	// Satellite system of the SYS / # / OBS TYPES line being continued
+	std::string _typesSys;
+	// Line buffer reused between epochs
+	std::string _line;
 
 };
 
@@ -0,0 +1,65 @@
+/*
+* Rinex3ObsStore.cpp
+* Loads a whole Rinex v3 observation file into a columnar ObsStore
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex3ObsStore.h"
+#include "EpochRange.h"
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+Rinex3ObsStore::Rinex3ObsStore() {}
+Rinex3ObsStore::~Rinex3ObsStore() {}
+
+// Streams the file epoch by epoch and transposes every epoch into columns
+bool Rinex3ObsStore::load(const string& filename) {
+	EpochRange<Rinex3Obs> range;
+	if (!range.open(filename)) { return false; }
+	clear();
+	_Header = range.header();
+	_headerText = string(range.headerText());
+	for (const auto& sysTypes : _Header.obsTypes) {
+		int sys = systemIndex(sysTypes.first[0]);
+		if (sys >= 0) { setTypes(sys, sysTypes.second); }
+	}
+	range.forEach([this](const Rinex3Obs::ObsEpochInfo& epoch) {
+		addEpoch(epoch.gpsTime, epoch.recClockOffset);
+		for (int sys = 0; sys < SYS_COUNT; sys++) {
+			addObservations(sys, epoch.observations[sys]);
+		}
+	});
+	finish();
+	return true;
+}
+
+// Reads the cache if it still matches the file
+bool Rinex3ObsStore::loadCached(const string& filename, const string& cacheFile) {
+	string cachePath = cacheFile.empty() ? defaultCacheFile(filename) : cacheFile;
+	CacheReader reader;
+	if (reader.open(cachePath, filename, CACHE_OBS3) && loadCache(reader) && loadHeader(reader)) { return true; }
+	if (!load(filename)) { return false; }
+	// A cache that cannot be written only costs the next run a parse
+	CacheWriter writer(CACHE_OBS3);
+	saveCache(writer);
+	saveHeader(writer);
+	writer.write(cachePath, filename);
+	return true;
+}
+
+// The header is kept as text and parsed again on loading
+void Rinex3ObsStore::saveHeader(CacheWriter& cache) const {
+	cache.add(SEC_OBS_HEADER, _headerText);
+}
+
+bool Rinex3ObsStore::loadHeader(const CacheReader& cache) {
+	if (!cache.get(SEC_OBS_HEADER, _headerText)) { return false; }
+	Rinex3Obs OBS;
+	string_view text(_headerText);
+	OBS.obsHeader(text);
+	_Header = OBS._Header;
+	return true;
+}
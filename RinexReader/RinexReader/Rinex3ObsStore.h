@@ -0,0 +1,40 @@
+#pragma once
+/*
+* Rinex3ObsStore.h
+* Loads a whole Rinex v3 observation file into a columnar ObsStore
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ObsStore.h"
+#include "Rinex3Obs.h"
+
+#ifndef RINEX3OBSSTORE_H_
+#define RINEX3OBSSTORE_H_
+
+class Rinex3ObsStore : public ObsStore
+{
+public:
+	// CONSTRUCTOR
+	Rinex3ObsStore();
+	// DESTRUCTOR
+	~Rinex3ObsStore();
+
+	// Attributes
+	Rinex3Obs::ObsHeaderInfo _Header;
+
+	// Functions
+	bool load(const std::string& filename);
+	// Loads the binary cache of the file when it is up to date, otherwise loads the file and writes the cache
+	bool loadCached(const std::string& filename, const std::string& cacheFile = "");
+
+private:
+	void saveHeader(CacheWriter& cache) const;
+	bool loadHeader(const CacheReader& cache);
+
+	// Header lines of the file, cached and parsed again so a cached store gets the same header
+	std::string _headerText;
+};
+
+#endif /* RINEX3OBSSTORE_H_ */
@@ -0,0 +1,143 @@
+/*
+* Rinex3ObsTail.cpp
+* Follows a Rinex v3 observation file that is still being written, reading only what was appended
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex3ObsTail.h"
+#include "FieldParser.h"
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+
+// CONSTRUCTOR
+Rinex3ObsTail::Rinex3ObsTail() : _headerRead(false), _fileOffset(0), _parsed(0), _readPos(0), _restarts(0) {}
+
+void Rinex3ObsTail::open(const string& filename) {
+	_filename = filename;
+	_restarts = 0;
+	restart();
+}
+
+// Forgets everything read, the next poll starts from the beginning of the file
+void Rinex3ObsTail::restart() {
+	_reader = Rinex3Obs();
+	_headerRead = false;
+	_buffer.clear();
+	_fileOffset = 0;
+	_parsed = 0;
+	_readPos = 0;
+	_lastBytes.clear();
+}
+
+// The file is opened for each read, so the writer is never held up and a replaced file is picked up
+size_t Rinex3ObsTail::poll() {
+	error_code ec;
+	uint64_t size = filesystem::file_size(_filename, ec);
+	if (ec) { return 0; }
+	if (size < _readPos) {
+		restart();
+		_restarts++;
+	}
+	if (size == _readPos) { return 0; }
+	ifstream in(_filename, ios::binary);
+	if (!in.is_open()) { return 0; }
+	// The last bytes read have to be still there, else the file was replaced by one at least as long
+	if (!_lastBytes.empty()) {
+		string check(_lastBytes.size(), '\0');
+		in.seekg(static_cast<streamoff>(_readPos - _lastBytes.size()));
+		in.read(&check[0], static_cast<streamsize>(check.size()));
+		if (check != _lastBytes) {
+			restart();
+			_restarts++;
+		}
+	}
+	in.seekg(static_cast<streamoff>(_readPos));
+	// Parsed bytes are dropped once they are the larger part of the buffer
+	if (_parsed > 0 && _parsed >= _buffer.size() / 2) {
+		_buffer.erase(0, _parsed);
+		_fileOffset += _parsed;
+		_parsed = 0;
+	}
+	size_t old = _buffer.size();
+	_buffer.resize(old + static_cast<size_t>(size - _readPos));
+	in.read(&_buffer[old], static_cast<streamsize>(size - _readPos));
+	size_t got = static_cast<size_t>(in.gcount());
+	_buffer.resize(old + got);
+	_readPos += got;
+	size_t keep = min<size_t>(LAST_BYTES, _buffer.size());
+	_lastBytes.assign(_buffer, _buffer.size() - keep, keep);
+	return got;
+}
+
+// The header is parsed in one go once its END OF HEADER line is complete
+bool Rinex3ObsTail::parseHeader() {
+	string_view text(_buffer);
+	text.remove_prefix(_parsed);
+	size_t pos = 0;
+	for (;;) {
+		size_t eol = text.find('\n', pos);
+		if (eol == string_view::npos) { return false; }
+		if (text.substr(pos, eol - pos).find("END OF HEADER") != string_view::npos) {
+			string_view header = text.substr(0, eol + 1);
+			_reader.obsHeader(header);
+			_parsed += eol + 1;
+			_headerRead = true;
+			return true;
+		}
+		pos = eol + 1;
+	}
+}
+
+// An epoch line gives the number of lines after it, satellites or special records of an event
+// Any other line is a unit of its own, the parser skips it as it does when reading a whole file
+size_t Rinex3ObsTail::completeEpoch(string_view text) {
+	size_t eol = text.find('\n');
+	if (eol == string_view::npos) { return 0; }
+	string_view line = text.substr(0, eol);
+	if (line.empty() || line[0] != '>') { return eol + 1; }
+	int nLines = intField(line, 32, 3);
+	size_t end = eol + 1;
+	for (int i = 0; i < nLines; i++) {
+		eol = text.find('\n', end);
+		if (eol == string_view::npos) { return 0; }
+		end = eol + 1;
+	}
+	return end;
+}
+
+bool Rinex3ObsTail::next() {
+	bool polled = false;
+	for (;;) {
+		if (!_headerRead) { parseHeader(); }
+		if (_headerRead) {
+			string_view text(_buffer);
+			text.remove_prefix(_parsed);
+			for (size_t len = completeEpoch(text); len > 0; len = completeEpoch(text)) {
+				string_view unit = text.substr(0, len);
+				text.remove_prefix(len);
+				_parsed += len;
+				// Events do not give an epoch
+				if (_reader.obsEpoch(unit)) { return true; }
+			}
+		}
+		if (polled || poll() == 0) { return false; }
+		polled = true;
+	}
+}
+
+bool Rinex3ObsTail::wait(int timeoutMs, int intervalMs) {
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+	for (;;) {
+		error_code ec;
+		uint64_t size = filesystem::file_size(_filename, ec);
+		if (!ec && size != _readPos) { return true; }
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (now >= deadline) { return false; }
+		this_thread::sleep_for(min<chrono::steady_clock::duration>(chrono::milliseconds(max(1, intervalMs)), deadline - now));
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*
+* Rinex3ObsTail.h
+* Follows a Rinex v3 observation file that is still being written, reading only what was appended
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex3Obs.h"
+
+#ifndef RINEX3OBSTAIL_H_
+#define RINEX3OBSTAIL_H_
+
+// Keeps its place in the file between calls, new bytes are read once and only complete epochs are parsed
+// An epoch is complete when its epoch line and all of its satellite lines end with a newline,
+// a partially written one stays in the buffer until the rest arrives
+//   Rinex3ObsTail tail;
+//   tail.open("STAT00XXX_R_20261234500_01H_30S_MO.rnx");
+//   for (;;) {
+//       while (tail.next()) { use(tail.epoch()); }
+//       tail.wait(1000);
+//   }
+class Rinex3ObsTail
+{
+public:
+	// CONSTRUCTOR
+	Rinex3ObsTail();
+
+	// Functions
+	// Nothing is read yet, the file does not have to exist
+	void open(const std::string& filename);
+	// Reads the bytes appended since the last call, returns how many
+	// A file that became shorter or whose last bytes read changed was replaced (eg: rotated),
+	// it is then followed again from its start
+	size_t poll();
+	// Parses the next complete epoch, polling first when none is buffered
+	// False when there is none yet, it can be called again later
+	bool next();
+	// Blocks until the file grows or the time runs out, polling every interval milliseconds
+	// True when there is something new to read
+	bool wait(int timeoutMs, int intervalMs = 50);
+
+	bool headerRead() const { return _headerRead; }
+	const Rinex3Obs::ObsHeaderInfo& header() const { return _reader._Header; }
+	const Rinex3Obs::ObsEpochInfo& epoch() const { return _reader._EpochObs; }
+	// Reader holding the observation types
+	const Rinex3Obs& reader() const { return _reader; }
+	// File offset of the first byte not parsed yet
+	uint64_t offset() const { return _fileOffset + _parsed; }
+	// Times the file was found replaced and read again from the start
+	size_t restarts() const { return _restarts; }
+
+private:
+	static constexpr size_t LAST_BYTES = 64;
+
+	void restart();
+	bool parseHeader();
+	// Length of the complete epoch (or event) at the start of text, 0 if it is not all there yet
+	static size_t completeEpoch(std::string_view text);
+
+	// Attributes
+	std::string _filename;
+	Rinex3Obs _reader;
+	bool _headerRead;
+	// * Bytes read but not parsed, _buffer starts at _fileOffset in the file
+	std::string _buffer;
+	uint64_t _fileOffset;
+	size_t _parsed;
+	// * File position of the next read and the bytes just before it, to notice a replaced file
+	uint64_t _readPos;
+	std::string _lastBytes;
+	size_t _restarts;
+};
+
+#endif /* RINEX3OBSTAIL_H_ */
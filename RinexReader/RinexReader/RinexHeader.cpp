@@ -0,0 +1,172 @@
+/*
+* RinexHeader.cpp
+* Header labels of Rinex files and the line reader shared by the observation and navigation readers
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "RinexHeader.h"
+#include "FieldParser.h"
+#include "GnssSystem.h"
+
+using namespace std;
+
+// Label text of each HeaderLabel
+static const char* const LABEL_NAMES[HDR_COUNT] = {
+	"",
+	"RINEX VERSION / TYPE", "PGM / RUN BY / DATE", "COMMENT",
+	"MARKER NAME", "MARKER NUMBER", "MARKER TYPE", "OBSERVER / AGENCY", "REC # / TYPE / VERS", "ANT # / TYPE",
+	"APPROX POSITION XYZ", "ANTENNA: DELTA H/E/N", "ANTENNA: DELTA X/Y/Z", "ANTENNA: PHASECENTER",
+	"ANTENNA: B.SIGHT XYZ", "ANTENNA: ZERODIR AZI", "ANTENNA: ZERODIR XYZ", "CENTER OF MASS: XYZ",
+	"WAVELENGTH FACT L1/2", "# / TYPES OF OBSERV", "SYS / # / OBS TYPES", "SIGNAL STRENGTH UNIT", "INTERVAL",
+	"TIME OF FIRST OBS", "TIME OF LAST OBS", "RCV CLOCK OFFS APPL", "SYS / DCBS APPLIED", "SYS / PCVS APPLIED",
+	"SYS / SCALE FACTOR", "SYS / PHASE SHIFT", "GLONASS SLOT / FRQ #", "GLONASS COD/PHS/BIS", "LEAP SECONDS",
+	"# OF SATELLITES", "PRN / # OF OBS", "DOI", "LICENSE OF USE", "STATION INFORMATION",
+	"ION ALPHA", "ION BETA", "DELTA-UTC: A0,A1,T,W", "CORR TO SYSTEM TIME", "D-UTC A0,A1,T,W,S,U",
+	"IONOSPHERIC CORR", "TIME SYSTEM CORR", "MERGED FILE",
+	"END OF HEADER"
+};
+
+// FNV-1a over the label text
+static size_t labelHash(string_view label) {
+	uint32_t h = 2166136261u;
+	for (char c : label) { h = (h ^ static_cast<unsigned char>(c)) * 16777619u; }
+	return h;
+}
+
+// Open addressing table over the label hashes, built once
+// A lookup is one hash and, for a standard label, one comparison
+struct LabelTable {
+	static const size_t SIZE = 256;
+	unsigned char slots[SIZE];
+
+	LabelTable() {
+		memset(slots, 0, sizeof(slots));
+		for (int label = 1; label < HDR_COUNT; label++) {
+			size_t h = labelHash(LABEL_NAMES[label]) % SIZE;
+			while (slots[h] != 0) { h = (h + 1) % SIZE; }
+			slots[h] = static_cast<unsigned char>(label);
+		}
+	}
+};
+
+HeaderLabel headerLabel(string_view line) {
+	static const LabelTable table;
+	if (line.size() <= 60) { return HDR_UNKNOWN; }
+	string_view label = line.substr(60, 20);
+	size_t end = label.find_last_not_of(" \r");
+	if (end == string_view::npos) { return HDR_UNKNOWN; }
+	label = label.substr(0, end + 1);
+	for (size_t h = labelHash(label) % LabelTable::SIZE; table.slots[h] != 0; h = (h + 1) % LabelTable::SIZE) {
+		if (label == LABEL_NAMES[table.slots[h]]) { return static_cast<HeaderLabel>(table.slots[h]); }
+	}
+	return HDR_UNKNOWN;
+}
+
+const char* headerLabelName(HeaderLabel label) {
+	return (label > HDR_UNKNOWN && label < HDR_COUNT) ? LABEL_NAMES[label] : "";
+}
+
+// Calendar time of TIME OF FIRST/LAST OBS (5I6,F13.7,5X,A3)
+static void headerObsTime(string_view line, vector<double>& time) {
+	time.clear();
+	for (size_t col = 0; col < 30; col += 6) { time.push_back(intField(line, col, 6)); }
+	time.push_back(floatField(line, 30, 13));
+}
+
+bool obsHeaderCommon(HeaderLabel label, string_view line, ObsHeaderCommon& header) {
+	switch (label) {
+	// F9.2,11X,A1,19X,A1, a blank satellite system means GPS
+	case HDR_VERSION:
+		header.version = floatField(line, 0, 9);
+		header.rinexType = string(textField(line, 40, 1));
+		if (header.rinexType.empty()) { header.rinexType = "G"; }
+		return true;
+	case HDR_PGM:
+		header.program = string(textField(line, 0, 20));
+		header.runBy = string(textField(line, 20, 20));
+		return true;
+	case HDR_MARKER_NAME:
+		header.markerName = string(textField(line, 0, 60));
+		return true;
+	case HDR_MARKER_NUMBER:
+		header.markerNumber = string(textField(line, 0, 20));
+		return true;
+	case HDR_MARKER_TYPE:
+		header.markerType = string(textField(line, 0, 20));
+		return true;
+	case HDR_OBSERVER:
+		header.observer = string(textField(line, 0, 20));
+		header.agency = string(textField(line, 20, 40));
+		return true;
+	case HDR_RECEIVER:
+		header.receiverNumber = string(textField(line, 0, 20));
+		header.receiverType = string(textField(line, 20, 20));
+		header.receiverVersion = string(textField(line, 40, 20));
+		return true;
+	case HDR_ANTENNA:
+		header.antennaNumber = string(textField(line, 0, 20));
+		header.antennaType = string(textField(line, 20, 20));
+		return true;
+	// 3F14.4, the position gets a fourth term for the receiver clock offset
+	case HDR_APPROX_POS:
+		header.approxPosXYZ = { floatField(line, 0, 14), floatField(line, 14, 14), floatField(line, 28, 14), 0 };
+		return true;
+	case HDR_ANT_DELTA_HEN:
+		header.antDeltaHEN = { floatField(line, 0, 14), floatField(line, 14, 14), floatField(line, 28, 14) };
+		return true;
+	case HDR_INTERVAL:
+		header.interval = floatField(line, 0, 10);
+		return true;
+	case HDR_TIME_OF_FIRST_OBS:
+		headerObsTime(line, header.firstObsTime);
+		header.timeSystem = string(textField(line, 48, 3));
+		return true;
+	case HDR_TIME_OF_LAST_OBS:
+		headerObsTime(line, header.lastObsTime);
+		return true;
+	case HDR_LEAP_SECONDS:
+		header.leapSeconds = intField(line, 0, 6);
+		return true;
+	case HDR_NUM_SATELLITES:
+		header.nSatellites = intField(line, 0, 6);
+		return true;
+	case HDR_RCV_CLOCK_OFFS_APPL:
+		header.rcvClockOffsApplied = intField(line, 0, 6);
+		return true;
+	case HDR_SIGNAL_STRENGTH_UNIT:
+		header.signalStrengthUnit = string(textField(line, 0, 20));
+		return true;
+	// I3,1X,8(A1,I2.2,1X,I2,1X), continuation lines leave the count blank
+	case HDR_GLONASS_SLOT_FRQ:
+		for (size_t col = 4; col + 6 <= 60; col += 7) {
+			if (isBlankField(line, col, 3)) { continue; }
+			header.glonassSlots[intField(line, col + 1, 2)] = intField(line, col + 4, 2);
+		}
+		return true;
+	// 4(1X,A3,1X,F8.3)
+	case HDR_GLONASS_COD_PHS_BIS:
+		for (size_t col = 0; col < 52; col += 13) {
+			string_view code = textField(line, col + 1, 3);
+			if (!code.empty()) { header.glonassBiases[string(code)] = floatField(line, col + 5, 8); }
+		}
+		return true;
+	// A1,1X,A3,1X,F8.5,2X,I2.2,10(1X,A3), continuation lines leave the system blank and list more satellites
+	case HDR_SYS_PHASE_SHIFT:
+		if (line[0] != ' ') {
+			header.phaseShifts.push_back(PhaseShift{ line[0], string(textField(line, 2, 3)), floatField(line, 6, 8), {} });
+		}
+		if (!header.phaseShifts.empty()) {
+			PhaseShift& shift = header.phaseShifts.back();
+			for (size_t col = 19; col + 3 <= 60; col += 4) {
+				if (isBlankField(line, col, 3)) { continue; }
+				int sys = systemIndex(line[col]);
+				if (sys >= 0) { shift.sats.push_back(packSat(sys, intField(line, col + 1, 2))); }
+			}
+		}
+		return true;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+/*
+* RinexHeader.h
+* Header labels of Rinex files and the line reader shared by the observation and navigation readers
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "StringUtils.h"
+
+#ifndef RINEXHEADER_H_
+#define RINEXHEADER_H_
+
+// Standard header labels of Rinex 2.11, 3.05 and 4.00 observation and navigation files (columns 61-80)
+enum HeaderLabel {
+	HDR_UNKNOWN = 0,
+	HDR_VERSION,				// RINEX VERSION / TYPE
+	HDR_PGM,					// PGM / RUN BY / DATE
+	HDR_COMMENT,
+	HDR_MARKER_NAME,
+	HDR_MARKER_NUMBER,
+	HDR_MARKER_TYPE,
+	HDR_OBSERVER,				// OBSERVER / AGENCY
+	HDR_RECEIVER,				// REC # / TYPE / VERS
+	HDR_ANTENNA,				// ANT # / TYPE
+	HDR_APPROX_POS,				// APPROX POSITION XYZ
+	HDR_ANT_DELTA_HEN,			// ANTENNA: DELTA H/E/N
+	HDR_ANT_DELTA_XYZ,			// ANTENNA: DELTA X/Y/Z
+	HDR_ANT_PHASECENTER,		// ANTENNA: PHASECENTER
+	HDR_ANT_BSIGHT,				// ANTENNA: B.SIGHT XYZ
+	HDR_ANT_ZERODIR_AZI,		// ANTENNA: ZERODIR AZI
+	HDR_ANT_ZERODIR_XYZ,		// ANTENNA: ZERODIR XYZ
+	HDR_CENTER_OF_MASS,			// CENTER OF MASS: XYZ
+	HDR_WAVELENGTH_FACT,		// WAVELENGTH FACT L1/2
+	HDR_TYPES_OF_OBSERV,		// # / TYPES OF OBSERV (Rinex 2)
+	HDR_SYS_OBS_TYPES,			// SYS / # / OBS TYPES (Rinex 3)
+	HDR_SIGNAL_STRENGTH_UNIT,
+	HDR_INTERVAL,
+	HDR_TIME_OF_FIRST_OBS,
+	HDR_TIME_OF_LAST_OBS,
+	HDR_RCV_CLOCK_OFFS_APPL,
+	HDR_SYS_DCBS_APPLIED,
+	HDR_SYS_PCVS_APPLIED,
+	HDR_SYS_SCALE_FACTOR,
+	HDR_SYS_PHASE_SHIFT,
+	HDR_GLONASS_SLOT_FRQ,		// GLONASS SLOT / FRQ #
+	HDR_GLONASS_COD_PHS_BIS,	// GLONASS COD/PHS/BIS
+	HDR_LEAP_SECONDS,
+	HDR_NUM_SATELLITES,			// # OF SATELLITES
+	HDR_PRN_NUM_OBS,			// PRN / # OF OBS
+	HDR_DOI,
+	HDR_LICENSE,				// LICENSE OF USE
+	HDR_STATION_INFORMATION,
+	HDR_ION_ALPHA,				// Rinex 2 navigation
+	HDR_ION_BETA,
+	HDR_DELTA_UTC,				// DELTA-UTC: A0,A1,T,W
+	HDR_CORR_TO_SYSTEM_TIME,	// Rinex 2 GLONASS navigation
+	HDR_D_UTC,					// D-UTC A0,A1,T,W,S,U (Rinex 2 SBAS navigation)
+	HDR_IONOSPHERIC_CORR,		// Rinex 3 navigation
+	HDR_TIME_SYSTEM_CORR,
+	HDR_MERGED_FILE,			// Rinex 4 navigation
+	HDR_END_OF_HEADER,
+	HDR_COUNT
+};
+
+// Functions
+// Label of a header line, read once from its label field, HDR_UNKNOWN when it is not a standard label
+HeaderLabel headerLabel(std::string_view line);
+const char* headerLabelName(HeaderLabel label);
+
+// Reads header lines up to and including END OF HEADER, handing each to handle(label, line)
+template <typename Handler>
+void readHeader(std::istream& in, Handler&& handle) {
+	std::string line;
+	while (!in.eof()) {
+		line.clear();
+		readLine(in, line);
+		HeaderLabel label = headerLabel(line);
+		handle(label, std::string_view(line));
+		if (label == HDR_END_OF_HEADER) { break; }
+	}
+}
+// Same over memory mapped text, which is advanced to the first line after the header
+template <typename Handler>
+void readHeader(std::string_view& text, Handler&& handle) {
+	std::string_view line;
+	while (nextLine(text, line)) {
+		HeaderLabel label = headerLabel(line);
+		handle(label, line);
+		if (label == HDR_END_OF_HEADER) { break; }
+	}
+}
+
+// Phase shift of one observation code (SYS / PHASE SHIFT), for all satellites of the system when sats is empty
+struct PhaseShift {
+	char sys;
+	std::string code;
+	double correction;
+	// Satellites packed by packSat()
+	std::vector<unsigned short> sats;
+};
+
+// Header information common to Rinex v2 and v3 observation files
+struct ObsHeaderCommon {
+	double version = 0;
+	// Satellite system of the file (G, R, E, M,...)
+	std::string rinexType;
+	std::string program;
+	std::string runBy;
+	std::string markerName;
+	std::string markerNumber;
+	std::string markerType;
+	std::string observer;
+	std::string agency;
+	std::string receiverNumber;
+	std::string receiverType;
+	std::string receiverVersion;
+	std::string antennaNumber;
+	std::string antennaType;
+	// X, Y, Z and a term for the receiver clock offset
+	std::vector<double> approxPosXYZ;
+	std::vector<double> antDeltaHEN;
+	// Year, month, day, hour, minute, second
+	std::vector<double> firstObsTime;
+	std::vector<double> lastObsTime;
+	// Time system of the observation times (GPS, GLO, GAL,...)
+	std::string timeSystem;
+	// Observation interval in seconds, 0 if not given
+	double interval = 0;
+	int leapSeconds = 0;
+	int nSatellites = 0;
+	int rcvClockOffsApplied = 0;
+	std::string signalStrengthUnit;
+	// GLONASS frequency number of each slot
+	std::map<int, int> glonassSlots;
+	std::vector<PhaseShift> phaseShifts;
+	// GLONASS code-phase bias of each code in metres
+	std::map<std::string, double> glonassBiases;
+};
+
+// Fills header from a label line, returns false for labels it does not handle
+// (observation types, end of header and the labels that carry nothing kept, like COMMENT)
+bool obsHeaderCommon(HeaderLabel label, std::string_view line, ObsHeaderCommon& header);
+
+#endif /* RINEXHEADER_H_ */
@@ -10,14 +10,16 @@
 #include "Rinex2Obs.h"
 #include "Rinex3Nav.h"
 #include "Rinex3Obs.h"
+#include "EphemerisIndex.h"
+#include "SppEngine.h"
 #include "TimeUtils.h"
 
 using namespace std;
 
 // Helper function to read Rinex 2.x Files
-void ReadRinex2(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log);
+void ReadRinex2(istream &fin_obs, istream &fin_nav, ofstream &fout_log);
 // Helper function to read Rinex 3.x Files
-void ReadRinex3(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log);
+void ReadRinex3(istream &fin_obs, istream &fin_nav, ofstream &fout_log);
 
 // The program starts and ends inside main.
 int main()
@@ -31,8 +33,8 @@ int main()
 	
 	// *** CREATE FILE POINTER
 	FileIO FIO;
-	// Input File Streams
-	ifstream fin_obs, fin_nav;
+	// Input File Streams, compressed files (.gz, .Z, Compact Rinex) are expanded while reading
+	InputStream fin_obs, fin_nav;
 	ofstream fout_log;
 	
 	// Setting up the pointers, handling errors
@@ -57,7 +59,8 @@ int main()
 			cout << "ERROR: Rinex 2 File Reader only supports GPS files.\n";
 		}
 	}
-	if ((rinex_version == 3)) {
+	// Rinex 4 observation files have the Rinex 3 layout
+	if ((rinex_version == 3) || (rinex_version == 4)) {
 		ReadRinex3(fin_obs, fin_nav, fout_log);
 	}
 
@@ -66,19 +69,21 @@ int main()
 }
 
 // Helper function to read Rinex 2 Files
-void ReadRinex2(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
+void ReadRinex2(istream &fin_obs, istream &fin_nav, ofstream &fout_log) {
 	// *** NAVIGATION FILE DATA OBJECT
 	Rinex2Nav NAV;
 	// Read and store ephemeris file
 	NAV.readNav(fin_nav);
-	// Navigation data storage variables
-	vector<Rinex2Nav::DataGPS> vecNav;
-	Rinex2Nav::DataGPS epochNav;
+	// Per-satellite time index over the navigation data
+	EphemerisIndex<Rinex2Nav::DataGPS> ephGPS(NAV._navDataGPS);
 
 	// *** OBSERVATION FILE DATA OBJECT
 	Rinex2Obs OBS;
 	// Read Obs Header from input file
 	OBS.obsHeader(fin_obs);
+	// Columns of the observations used, looked up once
+	const int colC1 = OBS._header.columns.column("C1"); // Code
+	if (colC1 < 0) { cout << "Requested C1 Observation is Unavailable" << endl; }
 
 	// *** LOOP THROUGH OBSERVATION FILE IN EPOCHWISE MANNER
 	while (!(fin_obs >> std::ws).eof()) {
@@ -93,29 +98,22 @@ void ReadRinex2(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
 		string obsTimeHMS = HHMMSS(OBS._obsDataGPS.epochRecord[3], OBS._obsDataGPS.epochRecord[4], OBS._obsDataGPS.epochRecord[5]);
 		cout << "OBS Time : " << obsTimeHMS << "\n";
 
-		// Extract Observations
-		map<int, double> obsC1 = OBS.specificObsMapper(OBS._obsGPS, OBS._obsTypesGPS, "C1"); // Code 
-		map<int, double> obsL1 = OBS.specificObsMapper(OBS._obsGPS, OBS._obsTypesGPS, "L1"); // L1 Phase
+		// Extract Observations, views over the epoch storage
+		const ObsMatrix& obsGPS = OBS._obsDataGPS.observations;
+		Span<int> prns = obsGPS.prns();
+		StridedSpan<double> obsC1 = obsGPS.column(colC1);
 
 		// *** FIND RELEVANT EPHEMERIS DATA
-		map<int, double>::iterator itOBS = obsC1.begin();
-		map<int, vector<Rinex2Nav::DataGPS>>::iterator itNAV;
-
 		// Iterate through PRN's to find corresponding ephemeris data
-		for (itOBS = obsC1.begin(); itOBS != obsC1.end(); itOBS++) {
+		for (size_t i = 0; i < obsC1.size; i++) {
 			// Current Satellite PRN
-			int prn = itOBS->first;
-
-			// Extract corresponding PRN Navigation data
-			itNAV = NAV._navDataGPS.find(prn);
-			if (itNAV != NAV._navDataGPS.end()) { vecNav = itNAV->second; }
-			else { continue; }
+			int prn = prns[i];
 
 			// Find most appropriate navigation data based on time comparison
-			int idx = NAV.EpochMatcher(OBS._obsDataGPS.gpsTime, vecNav);
-			epochNav = vecNav[idx];
+			const Rinex2Nav::DataGPS* epochNav = ephGPS.next(prn, OBS._obsDataGPS.gpsTime);
+			if (epochNav == nullptr) { continue; }
 
-			cout << "\t" << "PRN: " << epochNav.PRN << "\t\t" << "NAV GPS Time: " << epochNav.gpsTime << "\n";
+			cout << "\t" << "PRN: " << epochNav->PRN << "\t\t" << "NAV GPS Time: " << epochNav->gpsTime.sow() << "\n";
 
 			// *** DO REQUIRED PROCESSING HERE
 			// 1 ) Compute Satellite Position
@@ -135,19 +133,24 @@ void ReadRinex2(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
 }
 
 // Helper function to read Rinex 3 Files
-void ReadRinex3(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
+void ReadRinex3(istream &fin_obs, istream &fin_nav, ofstream &fout_log) {
 	// *** NAVIGATION FILE DATA OBJECT
 	Rinex3Nav NAV;
 	// Read and store ephemeris file
 	NAV.readMixed(fin_nav);
-	// Navigation data storage variables
-	vector<Rinex3Nav::DataGPS> vecNavGPS;
-	Rinex3Nav::DataGPS epochNavGPS;
+	// Per-satellite time index over the navigation data
+	EphemerisIndex<Rinex3Nav::DataGPS> ephGPS(NAV._navGPS);
 
 	// *** OBSERVATION FILE DATA OBJECT
 	Rinex3Obs OBS;
 	// Read Obs Header from input file
 	OBS.obsHeader(fin_obs);
+	// Columns of the observations used, looked up once
+	const int colC1 = OBS._Header.columns[SYS_GPS].column("C1C"); // Code
+	if (colC1 < 0) { cout << "Requested C1 Observation is Unavailable" << endl; }
+	// Single point positioning on the C1C codes of GPS, GLONASS and GALILEO
+	SppEngine SPP(NAV, OBS._Header);
+	SppSolution solution;
 
 	// *** LOOP THROUGH OBSERVATION FILE IN EPOCHWISE MANNER
 	while (!(fin_obs >> std::ws).eof()) {
@@ -162,29 +165,22 @@ void ReadRinex3(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
 		string obsTimeHMS = HHMMSS(OBS._EpochObs.epochRecord[3], OBS._EpochObs.epochRecord[4], OBS._EpochObs.epochRecord[5]);
 		cout << "OBS Time : " << obsTimeHMS << "\n";
 
-		// Extract Observations
-		map<int, double> obsC1 = OBS.specificObsMapper(OBS._obsGPS, OBS._obsTypesGPS, "C1C"); // Code 
-		map<int, double> obsL1 = OBS.specificObsMapper(OBS._obsGPS, OBS._obsTypesGPS, "L1C"); // L1 Phase
+		// Extract Observations, views over the epoch storage
+		const ObsMatrix& obsGPS = OBS._EpochObs.observations[SYS_GPS];
+		Span<int> prns = obsGPS.prns();
+		StridedSpan<double> obsC1 = obsGPS.column(colC1);
 
 		// *** FIND RELEVANT EPHEMERIS DATA
-		map<int, double>::iterator itOBS = obsC1.begin();
-		map<int, vector<Rinex3Nav::DataGPS>>::iterator itNAV;
-
 		// Iterate through PRN's to find corresponding ephemeris data
-		for (itOBS = obsC1.begin(); itOBS != obsC1.end(); itOBS++) {
+		for (size_t i = 0; i < obsC1.size; i++) {
 			// Current Satellite PRN
-			int prn = itOBS->first;
-
-			// Extract corresponding PRN Navigation data
-			itNAV = NAV._navGPS.find(prn);
-			if (itNAV != NAV._navGPS.end()) { vecNavGPS = itNAV->second; }
-			else { continue; }
+			int prn = prns[i];
 
 			// Find most appropriate navigation data based on time comparison
-			int idx = NAV.EpochMatcher(OBS._EpochObs.gpsTime, vecNavGPS);
-			epochNavGPS = vecNavGPS[idx];
+			const Rinex3Nav::DataGPS* epochNavGPS = ephGPS.next(prn, OBS._EpochObs.gpsTime);
+			if (epochNavGPS == nullptr) { continue; }
 
-			cout << "\t" << "PRN: " << epochNavGPS.PRN << "\t\t" << "NAV GPS Time: " << epochNavGPS.gpsTime << "\n";
+			cout << "\t" << "PRN: " << epochNavGPS->PRN << "\t\t" << "NAV GPS Time: " << epochNavGPS->gpsTime.sow() << "\n";
 
 			// *** DO REQUIRED PROCESSING HERE
 			// 1 ) Compute Satellite Position
@@ -192,9 +188,16 @@ void ReadRinex3(ifstream &fin_obs, ifstream &fin_nav, ofstream &fout_log) {
 
 		}
 
+		// *** Compute Receiver Position (Least Squares)
+		if (SPP.solve(OBS._EpochObs, solution)) {
+			streamsize precision = cout.precision();
+			cout << fixed << setprecision(3) << "\t" << "XYZ: " << solution.pos[0] << " " << solution.pos[1] << " " << solution.pos[2]
+				<< "\t" << "Sats: " << solution.nSats << "\t" << "PDOP: " << setprecision(2) << solution.pdop << "\n";
+			cout.unsetf(ios::floatfield);
+			cout.precision(precision);
+		}
 		// *** DO REQUIRED PROCESSING HERE
-		// 1 ) Compute Receiver Position (Least Squares / KF)
-		// 2 ) Output Solution to file 
+		// 1 ) Output Solution to file 
 
 		cout << endl;
 
@@ -0,0 +1,40 @@
+#pragma once
+/*
+* Span.h
+* Non-owning view over contiguous values, returned by the stores instead of copies
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+
+#ifndef SPAN_H_
+#define SPAN_H_
+
+template <typename T>
+struct Span {
+	const T* data;
+	size_t size;
+
+	Span() : data(nullptr), size(0) {}
+	Span(const T* d, size_t n) : data(d), size(n) {}
+	bool empty() const { return size == 0; }
+	const T* begin() const { return data; }
+	const T* end() const { return data + size; }
+	const T& operator[](size_t i) const { return data[i]; }
+};
+
+// Non-owning view over every stride-th value, for eg: one column of a row major matrix
+template <typename T>
+struct StridedSpan {
+	const T* data;
+	size_t size;
+	size_t stride;
+
+	StridedSpan() : data(nullptr), size(0), stride(1) {}
+	StridedSpan(const T* d, size_t n, size_t s) : data(d), size(n), stride(s) {}
+	bool empty() const { return size == 0; }
+	const T& operator[](size_t i) const { return data[i * stride]; }
+};
+
+#endif /* SPAN_H_ */
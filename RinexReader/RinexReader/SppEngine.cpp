@@ -0,0 +1,325 @@
+/*
+* SppEngine.cpp
+* Single point positioning from code observations of Rinex v3 epochs and broadcast ephemerides
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "SppEngine.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+static const double SPEED_OF_LIGHT = 299792458.0;
+static const double OMEGA_EARTH = 7.2921151467e-5;
+static const double PI = 3.1415926535897932;
+// Ionospheric delays scale with 1/f^2, Klobuchar gives them for L1 (1575.42 MHz), GLONASS G1 is near 1602 MHz
+static const double IONO_SCALE_GLO = (1575.42 / 1602.0) * (1575.42 / 1602.0);
+
+// Latitude, longitude (rad) and ellipsoidal height (m) on WGS84
+static void ecefToGeodetic(const double* x, double& lat, double& lon, double& h) {
+	const double a = 6378137.0;
+	const double e2 = 6.69437999014e-3;
+	double p = sqrt(x[0] * x[0] + x[1] * x[1]);
+	lon = atan2(x[1], x[0]);
+	lat = atan2(x[2], p * (1.0 - e2));
+	for (int i = 0; i < 5; i++) {
+		double sinLat = sin(lat);
+		double N = a / sqrt(1.0 - e2 * sinLat * sinLat);
+		h = p / cos(lat) - N;
+		lat = atan2(x[2], p * (1.0 - e2 * N / (N + h)));
+	}
+	double sinLat = sin(lat);
+	h = p / cos(lat) - a / sqrt(1.0 - e2 * sinLat * sinLat);
+}
+
+// Saastamoinen zenith delays with a standard atmosphere (relative humidity 70%), mapped by 1/cos(zenith)
+static double tropoDelay(double lat, double h, double elevation) {
+	if (h < -100.0 || h > 1.0e4 || elevation <= 0) { return 0; }
+	double hgt = (h < 0) ? 0 : h;
+	double pressure = 1013.25 * pow(1.0 - 2.2557e-5 * hgt, 5.2568);
+	double temp = 15.0 - 6.5e-3 * hgt + 273.16;
+	double e = 6.108 * 0.7 * exp((17.15 * temp - 4684.0) / (temp - 38.45));
+	double cosz = cos(PI / 2 - elevation);
+	double dry = 0.0022768 * pressure / (1.0 - 0.00266 * cos(2.0 * lat) - 0.00028 * hgt / 1e3) / cosz;
+	double wet = 0.002277 * (1255.0 / temp + 0.05) * e / cosz;
+	return dry + wet;
+}
+
+// Klobuchar delay on L1 in metres (IS-GPS-200 20.3.3.5.2.5), tow is the GPS time of week
+static double klobuchar(const double* alpha, const double* beta, double lat, double lon,
+	double azimuth, double elevation, double tow) {
+	// Angles in semicircles
+	double el = elevation / PI;
+	double psi = 0.0137 / (el + 0.11) - 0.022;
+	double phi = lat / PI + psi * cos(azimuth);
+	if (phi > 0.416) { phi = 0.416; }
+	else if (phi < -0.416) { phi = -0.416; }
+	double lam = lon / PI + psi * sin(azimuth) / cos(phi * PI);
+	double phim = phi + 0.064 * cos((lam - 1.617) * PI);
+	double t = 43200.0 * lam + tow;
+	t -= floor(t / 86400.0) * 86400.0;
+	double F = 1.0 + 16.0 * pow(0.53 - el, 3.0);
+	double amp = alpha[0] + phim * (alpha[1] + phim * (alpha[2] + phim * alpha[3]));
+	double per = beta[0] + phim * (beta[1] + phim * (beta[2] + phim * beta[3]));
+	if (amp < 0) { amp = 0; }
+	if (per < 72000.0) { per = 72000.0; }
+	double x = 2.0 * PI * (t - 50400.0) / per;
+	double delay = (fabs(x) < 1.57) ? 5e-9 + amp * (1.0 + x * x * (-0.5 + x * x / 24.0)) : 5e-9;
+	return SPEED_OF_LIGHT * F * delay;
+}
+
+// Cholesky factor of the upper-left n x n block in place (lower triangle), false if not positive definite
+static bool cholesky(double (&A)[SppEngine::MAX_UNKNOWNS][SppEngine::MAX_UNKNOWNS], int n) {
+	for (int j = 0; j < n; j++) {
+		double d = A[j][j];
+		for (int k = 0; k < j; k++) { d -= A[j][k] * A[j][k]; }
+		if (d <= 0) { return false; }
+		A[j][j] = sqrt(d);
+		for (int i = j + 1; i < n; i++) {
+			double s = A[i][j];
+			for (int k = 0; k < j; k++) { s -= A[i][k] * A[j][k]; }
+			A[i][j] = s / A[j][j];
+		}
+	}
+	return true;
+}
+
+// Solves L L^T x = b in place
+static void choleskySolve(const double (&L)[SppEngine::MAX_UNKNOWNS][SppEngine::MAX_UNKNOWNS], int n, double* b) {
+	for (int i = 0; i < n; i++) {
+		for (int k = 0; k < i; k++) { b[i] -= L[i][k] * b[k]; }
+		b[i] /= L[i][i];
+	}
+	for (int i = n - 1; i >= 0; i--) {
+		for (int k = i + 1; k < n; k++) { b[i] -= L[k][i] * b[k]; }
+		b[i] /= L[i][i];
+	}
+}
+
+// CONSTRUCTOR
+SppEngine::SppEngine(const Rinex3Nav& nav, const Rinex3Obs::ObsHeaderInfo& header)
+	: SppEngine(nav, header, Options()) {}
+
+SppEngine::SppEngine(const Rinex3Nav& nav, const Rinex3Obs::ObsHeaderInfo& header, const Options& options)
+	: _options(options), _ephGPS(nav._navGPS), _ephGAL(nav._navGAL), _glonass(nav._navGLO), _nSats(0) {
+	for (int i = 0; i < 3; i++) { _apriori[i] = (i < static_cast<int>(header.approxPosXYZ.size())) ? header.approxPosXYZ[i] : 0; }
+	_hasIono = nav._headerGPS.ialpha.size() == 4 && nav._headerGPS.ibeta.size() == 4;
+	for (int i = 0; i < 4; i++) {
+		_alpha[i] = _hasIono ? nav._headerGPS.ialpha[i] : 0;
+		_beta[i] = _hasIono ? nav._headerGPS.ibeta[i] : 0;
+	}
+	for (int sys = 0; sys < SYS_COUNT; sys++) { _codeColumn[sys] = -1; }
+	if (options.useGPS) { _codeColumn[SYS_GPS] = header.columns[SYS_GPS].column(options.codeGPS); }
+	if (options.useGLO) { _codeColumn[SYS_GLO] = header.columns[SYS_GLO].column(options.codeGLO); }
+	if (options.useGAL) { _codeColumn[SYS_GAL] = header.columns[SYS_GAL].column(options.codeGAL); }
+	_kepler.reserve(MAX_SATS);
+	_keplerTimes.reserve(MAX_SATS);
+	_keplerStates.reserve(MAX_SATS);
+	_glonassStates.reserve(MAX_SATS);
+}
+
+// Gathers the satellites with a code observation and a usable ephemeris
+int SppEngine::collect(const Rinex3Obs::ObsEpochInfo& epoch) {
+	_nSats = 0;
+	_kepler.clear();
+	const int systems[] = { SYS_GPS, SYS_GLO, SYS_GAL };
+	for (int sys : systems) {
+		int col = _codeColumn[sys];
+		if (col < 0) { continue; }
+		const ObsMatrix& matrix = epoch.observations[sys];
+		if (col >= matrix.nTypes()) { continue; }
+		for (int row = 0; row < matrix.nSats() && _nSats < MAX_SATS; row++) {
+			int prn = matrix.prn(row);
+			double code = matrix.value(row, col);
+			if (code <= 0) { continue; }
+			SatObs& sat = _sats[_nSats];
+			sat.sys = sys;
+			sat.prn = prn;
+			sat.code = code;
+			_tgd[_nSats] = 0;
+			if (sys == SYS_GPS) {
+				const Rinex3Nav::DataGPS* eph = _ephGPS.next(prn, epoch.gpsTime);
+				if (eph == nullptr) { continue; }
+				_kepler.add(*eph);
+				_tgd[_nSats] = eph->TGD;
+			}
+			else if (sys == SYS_GAL) {
+				// E1 group delay relative to E5b (I/NAV)
+				const Rinex3Nav::DataGAL* eph = _ephGAL.next(prn, epoch.gpsTime);
+				if (eph == nullptr) { continue; }
+				_kepler.add(*eph);
+				_tgd[_nSats] = eph->BGD_E5b;
+			}
+			_nSats++;
+		}
+	}
+	return _nSats;
+}
+
+// Satellite positions and clocks at transmission time, t is the receiver time of the epoch
+// The transmission time is the receive time less the code travel time, and then less the satellite clock
+void SppEngine::satStates(GpsTime t) {
+	for (int pass = 0; pass < 2; pass++) {
+		int nKepler = 0, nGlonass = 0;
+		_keplerTimes.clear();
+		for (int i = 0; i < _nSats; i++) {
+			GpsTime tx = t - _sats[i].code / SPEED_OF_LIGHT;
+			if (pass == 1 && !std::isnan(_sats[i].clock)) { tx = tx - _sats[i].clock; }
+			if (_sats[i].sys == SYS_GLO) {
+				_gloTime[nGlonass] = tx;
+				_gloPRN[nGlonass] = _sats[i].prn;
+				_glonassSat[nGlonass++] = i;
+			}
+			else {
+				_keplerTimes.push_back(tx);
+				_keplerSat[nKepler++] = i;
+			}
+		}
+		if (nKepler > 0) { _kepler.compute(_keplerTimes.data(), _keplerStates); }
+		if (nGlonass > 0) { _glonass.compute(_gloPRN, _gloTime, nGlonass, _glonassStates); }
+		for (int j = 0; j < nKepler; j++) {
+			SatObs& sat = _sats[_keplerSat[j]];
+			sat.pos[0] = _keplerStates.x[j];
+			sat.pos[1] = _keplerStates.y[j];
+			sat.pos[2] = _keplerStates.z[j];
+			sat.clock = _keplerStates.clockBias[j] - _tgd[_keplerSat[j]];
+		}
+		for (int j = 0; j < nGlonass; j++) {
+			SatObs& sat = _sats[_glonassSat[j]];
+			sat.pos[0] = _glonassStates.x[j];
+			sat.pos[1] = _glonassStates.y[j];
+			sat.pos[2] = _glonassStates.z[j];
+			sat.clock = _glonassStates.clockBias[j];
+		}
+	}
+}
+
+bool SppEngine::solve(const Rinex3Obs::ObsEpochInfo& epoch, SppSolution& solution) {
+	solution.time = epoch.gpsTime;
+	solution.valid = false;
+	solution.nSats = 0;
+	solution.iterations = 0;
+	solution.pdop = 0;
+	solution.rms = 0;
+	for (int i = 0; i < 3; i++) { solution.pos[i] = _apriori[i]; }
+	for (int sys = 0; sys < SYS_COUNT; sys++) { solution.clock[sys] = 0; }
+	if (collect(epoch) < 4) { return false; }
+	satStates(epoch.gpsTime);
+
+	double x[3] = { _apriori[0], _apriori[1], _apriori[2] };
+	// Receiver clocks in metres
+	double clock[SYS_COUNT] = {};
+	double N[MAX_UNKNOWNS][MAX_UNKNOWNS];
+	double Q[MAX_UNKNOWNS][MAX_UNKNOWNS];
+	double b[MAX_UNKNOWNS];
+	int param[SYS_COUNT];
+	double tow = epoch.gpsTime.sow();
+	bool converged = false;
+	int nUsed = 0, nUnknowns = 0;
+	double sumWeighted = 0, sumWeights = 0;
+	for (int iter = 0; iter < _options.maxIterations && !converged; iter++) {
+		// Elevations, masks and atmosphere only once the position is near the earth's surface
+		bool located = sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]) > 6.0e6;
+		double lat = 0, lon = 0, h = 0;
+		if (located) { ecefToGeodetic(x, lat, lon, h); }
+		double sinLat = sin(lat), cosLat = cos(lat), sinLon = sin(lon), cosLon = cos(lon);
+		for (int i = 0; i < MAX_UNKNOWNS; i++) {
+			b[i] = 0;
+			for (int j = 0; j < MAX_UNKNOWNS; j++) { N[i][j] = 0; Q[i][j] = 0; }
+		}
+		for (int sys = 0; sys < SYS_COUNT; sys++) { param[sys] = -1; }
+		nUsed = 0;
+		nUnknowns = 3;
+		sumWeighted = 0;
+		sumWeights = 0;
+		for (int i = 0; i < _nSats; i++) {
+			SatObs& sat = _sats[i];
+			if (std::isnan(sat.pos[0])) { continue; }
+			// Earth rotation during the travel time
+			double dx0 = sat.pos[0] - x[0], dy0 = sat.pos[1] - x[1], dz0 = sat.pos[2] - x[2];
+			double theta = OMEGA_EARTH * sqrt(dx0 * dx0 + dy0 * dy0 + dz0 * dz0) / SPEED_OF_LIGHT;
+			double rs[3] = { cos(theta) * sat.pos[0] + sin(theta) * sat.pos[1],
+				-sin(theta) * sat.pos[0] + cos(theta) * sat.pos[1], sat.pos[2] };
+			double e[3] = { rs[0] - x[0], rs[1] - x[1], rs[2] - x[2] };
+			double range = sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+			for (int k = 0; k < 3; k++) { e[k] /= range; }
+			double weight = 1.0;
+			double atmosphere = 0;
+			if (located) {
+				double east = -sinLon * e[0] + cosLon * e[1];
+				double north = -sinLat * cosLon * e[0] - sinLat * sinLon * e[1] + cosLat * e[2];
+				double up = cosLat * cosLon * e[0] + cosLat * sinLon * e[1] + sinLat * e[2];
+				sat.elevation = asin(up);
+				sat.azimuth = atan2(east, north);
+				if (sat.elevation < _options.elevationMask * PI / 180.0) { continue; }
+				weight = up * up;
+				atmosphere = tropoDelay(lat, h, sat.elevation);
+				if (_hasIono) {
+					double iono = klobuchar(_alpha, _beta, lat, lon, sat.azimuth, sat.elevation, tow);
+					atmosphere += (sat.sys == SYS_GLO) ? iono * IONO_SCALE_GLO : iono;
+				}
+			}
+			if (param[sat.sys] < 0) { param[sat.sys] = nUnknowns++; }
+			double v = sat.code - (range + clock[sat.sys] - SPEED_OF_LIGHT * sat.clock + atmosphere);
+			double H[MAX_UNKNOWNS] = { -e[0], -e[1], -e[2], 0, 0, 0 };
+			H[param[sat.sys]] = 1.0;
+			for (int r = 0; r < nUnknowns; r++) {
+				b[r] += weight * H[r] * v;
+				for (int c = 0; c <= r; c++) {
+					N[r][c] += weight * H[r] * H[c];
+					Q[r][c] += H[r] * H[c];
+				}
+			}
+			sumWeighted += weight * v * v;
+			sumWeights += weight;
+			nUsed++;
+		}
+		if (nUsed < nUnknowns || !cholesky(N, nUnknowns)) { return false; }
+		choleskySolve(N, nUnknowns, b);
+		for (int k = 0; k < 3; k++) { x[k] += b[k]; }
+		for (int sys = 0; sys < SYS_COUNT; sys++) {
+			if (param[sys] >= 0) { clock[sys] += b[param[sys]]; }
+		}
+		solution.iterations = iter + 1;
+		converged = sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]) < 1e-4;
+	}
+	if (!converged) { return false; }
+
+	// PDOP from the unweighted geometry of the last iteration
+	if (cholesky(Q, nUnknowns)) {
+		double pdop2 = 0;
+		for (int k = 0; k < 3; k++) {
+			double unit[MAX_UNKNOWNS] = {};
+			unit[k] = 1.0;
+			choleskySolve(Q, nUnknowns, unit);
+			pdop2 += unit[k];
+		}
+		solution.pdop = sqrt(pdop2);
+	}
+	for (int k = 0; k < 3; k++) { solution.pos[k] = x[k]; }
+	for (int sys = 0; sys < SYS_COUNT; sys++) { solution.clock[sys] = clock[sys] / SPEED_OF_LIGHT; }
+	solution.nSats = nUsed;
+	solution.rms = (sumWeights > 0) ? sqrt(sumWeighted / sumWeights) : 0;
+	solution.valid = true;
+	return true;
+}
+
+void SppEngine::solveBatch(const std::vector<Rinex3Obs::ObsEpochInfo>& epochs, std::vector<SppSolution>& solutions,
+	unsigned nThreads) const {
+	solutions.resize(epochs.size());
+	if (epochs.empty()) { return; }
+	ThreadPool pool(nThreads);
+	// A few chunks per worker evens out the load, each chunk has its own engine
+	size_t nChunks = min(epochs.size(), static_cast<size_t>(pool.size()) * 4);
+	for (size_t c = 0; c < nChunks; c++) {
+		size_t first = epochs.size() * c / nChunks;
+		size_t last = epochs.size() * (c + 1) / nChunks;
+		pool.submit([this, &epochs, &solutions, first, last]() {
+			SppEngine worker(*this);
+			for (size_t i = first; i < last; i++) { worker.solve(epochs[i], solutions[i]); }
+		});
+	}
+	pool.wait();
+}
@@ -0,0 +1,117 @@
+#pragma once
+/*
+* SppEngine.h
+* Single point positioning from code observations of Rinex v3 epochs and broadcast ephemerides
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "Rinex3Nav.h"
+#include "Rinex3Obs.h"
+#include "EphemerisIndex.h"
+#include "KeplerBatch.h"
+#include "GlonassOrbit.h"
+
+#ifndef SPPENGINE_H_
+#define SPPENGINE_H_
+
+// Receiver solution of one epoch
+struct SppSolution {
+	GpsTime time;
+	bool valid;
+	// ECEF position in metres
+	double pos[3];
+	// Receiver clock offset of each satellite system in seconds (GnssSystem), 0 for systems not used
+	double clock[SYS_COUNT];
+	int nSats;
+	int iterations;
+	double pdop;
+	// RMS of the weighted code residuals in metres
+	double rms;
+};
+
+// Iterative weighted least squares on single frequency code, one clock per satellite system
+// Models: satellite clock with relativity and group delay, earth rotation during signal travel,
+// Saastamoinen troposphere and, when the navigation header has them, Klobuchar ionosphere
+// Each epoch starts from the same a priori position (the header's, or the earth's centre), so a solution
+// never depends on the epochs before it and batches give the same results on any number of threads
+// The matrices are fixed size and the per-satellite buffers are reused, solving does not allocate once warmed up
+class SppEngine
+{
+public:
+	// Settings, the code types are looked up in the header's observation types of each system
+	struct Options {
+		bool useGPS = true;
+		bool useGLO = true;
+		bool useGAL = true;
+		std::string codeGPS = "C1C";
+		std::string codeGLO = "C1C";
+		std::string codeGAL = "C1C";
+		// Satellites below it are left out once the position is known, in degrees
+		double elevationMask = 10.0;
+		int maxIterations = 10;
+	};
+
+	// Largest number of satellites used in one epoch
+	static const int MAX_SATS = 96;
+	// Position and one clock for each of GPS, GLONASS and GALILEO
+	static const int MAX_UNKNOWNS = 6;
+
+	// CONSTRUCTOR
+	// The navigation data is referenced and not copied, it has to outlive the engine
+	SppEngine(const Rinex3Nav& nav, const Rinex3Obs::ObsHeaderInfo& header);
+	SppEngine(const Rinex3Nav& nav, const Rinex3Obs::ObsHeaderInfo& header, const Options& options);
+
+	// Functions
+	bool solve(const Rinex3Obs::ObsEpochInfo& epoch, SppSolution& solution);
+	// Solves many epochs on a thread pool, solutions[i] belongs to epochs[i]
+	// Consecutive epochs go to the same worker so the ephemeris lookups keep walking forward
+	// Zero threads picks one per hardware thread
+	void solveBatch(const std::vector<Rinex3Obs::ObsEpochInfo>& epochs, std::vector<SppSolution>& solutions,
+		unsigned nThreads = 0) const;
+
+private:
+	// Satellites of the current epoch with their code, state and corrections
+	struct SatObs {
+		int sys;
+		int prn;
+		double code;
+		double pos[3];
+		double clock;
+		double elevation;
+		double azimuth;
+	};
+
+	int collect(const Rinex3Obs::ObsEpochInfo& epoch);
+	void satStates(GpsTime t);
+
+	// Attributes
+	Options _options;
+	double _apriori[3];
+	// * Klobuchar coefficients, used when hasIono
+	bool _hasIono;
+	double _alpha[4];
+	double _beta[4];
+	// * Column of the code observation of each system, -1 if missing or disabled
+	int _codeColumn[SYS_COUNT];
+	// * Ephemeris selection and orbits
+	EphemerisIndex<Rinex3Nav::DataGPS> _ephGPS;
+	EphemerisIndex<Rinex3Nav::DataGAL> _ephGAL;
+	GlonassPropagator _glonass;
+	KeplerBatch _kepler;
+	// * Per epoch buffers, reused
+	SatObs _sats[MAX_SATS];
+	int _nSats;
+	// * Positions in _sats of the satellites of each orbit type, and the GLONASS requests
+	int _keplerSat[MAX_SATS];
+	int _glonassSat[MAX_SATS];
+	int _gloPRN[MAX_SATS];
+	double _tgd[MAX_SATS];
+	GpsTime _gloTime[MAX_SATS];
+	OrbitStates _keplerStates;
+	OrbitStates _glonassStates;
+	std::vector<GpsTime> _keplerTimes;
+};
+
+#endif /* SPPENGINE_H_ */
@@ -7,6 +7,7 @@
 
 #include "pch.h"
 #include "StringUtils.h"
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -37,4 +38,38 @@ string HHMMSS(double hours, double mins, double secs) {
 	ss << std::setw(2) << std::setfill('0') << (int)secs;
 	string hms = ss.str();
 	return hms;
-}
\ No newline at end of file
+}
+
+// A function to take the next line off the front of a text view (no copies)
+// Returns false once the text is exhausted, trailing carriage returns are dropped
+bool nextLine(string_view& text, string_view& line) {
+	if (text.empty()) { return false; }
+	size_t pos = text.find('\n');
+	if (pos == string_view::npos) {
+		line = text;
+		text = string_view();
+	}
+	else {
+		line = text.substr(0, pos);
+		text.remove_prefix(pos + 1);
+	}
+	RINEX_COUNT(COUNT_LINES, 1);
+	RINEX_COUNT(COUNT_BYTES, (pos == string_view::npos) ? line.size() : pos + 1);
+	if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+	return true;
+}
+
+// A function to read the next line of a stream, counted and timed as I/O by the instrumentation
+istream& readLine(istream& in, string& line) {
+	RINEX_TIME(TIME_IO);
+	if (getline(in, line)) {
+		RINEX_COUNT(COUNT_LINES, 1);
+		RINEX_COUNT(COUNT_BYTES, line.size() + 1);
+	}
+	return in;
+}
+
+// A function to check if a string holds nothing but blanks
+bool isBlank(string_view str) {
+	return str.find_first_not_of(' ') == string_view::npos;
+}
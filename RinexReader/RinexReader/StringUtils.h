@@ -15,5 +15,8 @@
 std::string replaceChars(std::string str, char ch1, char ch2);
 void eraseSubStr(std::string & mainStr, const std::string & toErase);
 std::string HHMMSS(double hours, double mins, double secs);
+bool nextLine(std::string_view& text, std::string_view& line);
+std::istream& readLine(std::istream& in, std::string& line);
+bool isBlank(std::string_view str);
 
 #endif /* STRINGUTILS_H_ */
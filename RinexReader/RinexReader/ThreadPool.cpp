@@ -0,0 +1,64 @@
+/*
+* ThreadPool.cpp
+* Fixed set of worker threads consuming a shared task queue
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// CONSTRUCTOR AND DESTRUCTOR DEFINITIONS
+ThreadPool::ThreadPool(unsigned nThreads) : _pending(0), _stopping(false) {
+	if (nThreads == 0) { nThreads = max(1u, thread::hardware_concurrency()); }
+	_workers.reserve(nThreads);
+	for (unsigned i = 0; i < nThreads; i++) {
+		_workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_taskReady.notify_all();
+	for (thread& worker : _workers) { worker.join(); }
+}
+
+// Queues a task for the next free worker
+void ThreadPool::submit(function<void()> task) {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_tasks.push_back(std::move(task));
+		_pending++;
+	}
+	_taskReady.notify_one();
+}
+
+// Blocks until every submitted task has completed
+void ThreadPool::wait() {
+	unique_lock<mutex> lock(_mutex);
+	_allDone.wait(lock, [this] { return _pending == 0; });
+}
+
+// Takes tasks off the queue until the pool is destroyed
+void ThreadPool::workerLoop() {
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(_mutex);
+			_taskReady.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+			if (_tasks.empty()) { return; }
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+		{
+			lock_guard<mutex> lock(_mutex);
+			_pending--;
+			if (_pending == 0) { _allDone.notify_all(); }
+		}
+	}
+}
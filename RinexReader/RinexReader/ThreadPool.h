@@ -0,0 +1,49 @@
+#pragma once
+/*
+* ThreadPool.h
+* Fixed set of worker threads consuming a shared task queue
+*  Created on: Oct 17, 2026
+*      Author: Aaron Boda
+*/
+
+#include "pch.h"
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+class ThreadPool
+{
+public:
+	// CONSTRUCTOR
+	// Zero threads picks one per hardware thread
+	explicit ThreadPool(unsigned nThreads = 0);
+	// DESTRUCTOR
+	// Finishes the queued tasks before the workers are joined
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Functions
+	void submit(std::function<void()> task);
+	// Blocks until every submitted task has completed
+	void wait();
+	unsigned size() const { return static_cast<unsigned>(_workers.size()); }
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> _workers;
+	std::deque<std::function<void()>> _tasks;
+	std::mutex _mutex;
+	std::condition_variable _taskReady;
+	std::condition_variable _allDone;
+	size_t _pending;
+	bool _stopping;
+};
+
+#endif /* THREADPOOL_H_ */
@@ -10,35 +10,37 @@
 
 using namespace std;
 
-// Source: BOOK called GPS Theory Algorithm & Applications by Guochang Xu (Pg 18-20)
-double gpsTime(std::vector<double> epochInfo) {
+// Full year of a Rinex epoch, Rinex 2 files only carry two digits
+static int fullYear(double y) {
+	int year = static_cast<int>(y);
+	if (year < 80) { return year + 2000; }
+	if (year < 100) { return year + 1900; }
+	return year;
+}
+
+// Calendar conversion is done in integers, see GpsTime::fromCalendar
+GpsTime gpsTime(const std::vector<double>& epochInfo) {
 	// As precaution, check if we have required epoch info
-	if (epochInfo.size() < 6) {
-		// If so, we dont have enough epoch info to work with
-		// We need to exit prematurely
-		exit(1);
-	}
-	// Year Month Day of epoch
-	double y = epochInfo.at(0); double m = epochInfo.at(1); double d = epochInfo.at(2);
-	// Hour Minute Second of epoch
-	double hr = epochInfo.at(3); double min = epochInfo.at(4); double sec = epochInfo.at(5);
-	// UTC time in hours
-	double UTC = hr + min / 60. + sec / 3600.;
-	// Taking care of month and year conditioning
-	if (m > 2) {
-		y = y + 2000;
-	}
-	else {
-		y = y + 2000 - 1;
-		m = m + 12;
-	}
-	// Julian Date
-	double jDate = floor(365.25*y) + floor(30.6001*(m + 1)) + d + (UTC / 24) + 1720981.5;
-	// GPS Week
-	double gpsWeek = floor((jDate - 2444244.5) / 7);
-	// GPS Time
-	double gpsTime = round(((((jDate - 2444244.5) / 7) - gpsWeek) * 7 * 24 * 3600) * 100) / 100;
-	// Return GPS Time in seconds
-	return gpsTime;
+	if (epochInfo.size() < 6) { return GpsTime(); }
+	return gpsTime(epochInfo.data());
+}
+GpsTime gpsTime(const double* epochInfo) {
+	return GpsTime::fromCalendar(fullYear(epochInfo[0]), static_cast<int>(epochInfo[1]), static_cast<int>(epochInfo[2]),
+		static_cast<int>(epochInfo[3]), static_cast<int>(epochInfo[4]), epochInfo[5]);
 }
 
+// GPS time of an epoch given in UTC
+GpsTime gpsTimeFromUtc(const std::vector<double>& epochInfo) {
+	if (epochInfo.size() < 6) { return GpsTime(); }
+	return gpsTimeFromUtc(epochInfo.data());
+}
+GpsTime gpsTimeFromUtc(const double* epochInfo) {
+	return GpsTime::fromUtc(fullYear(epochInfo[0]), static_cast<int>(epochInfo[1]), static_cast<int>(epochInfo[2]),
+		static_cast<int>(epochInfo[3]), static_cast<int>(epochInfo[4]), epochInfo[5]);
+}
+
+// GPS time of an epoch given in BeiDou Time
+GpsTime gpsTimeFromBdt(const double* epochInfo) {
+	return GpsTime::fromBdt(fullYear(epochInfo[0]), static_cast<int>(epochInfo[1]), static_cast<int>(epochInfo[2]),
+		static_cast<int>(epochInfo[3]), static_cast<int>(epochInfo[4]), epochInfo[5]);
+}
@@ -7,11 +7,131 @@
 */
 
 #include "pch.h"
+#include <cstdint>
 
 #ifndef TIMEUTILS_H_
 #define TIMEUTILS_H_
 
+// Continuous GPS time, integer nanoseconds since the GPS epoch (1980-01-06 00:00:00)
+// Trivially copyable and free of week rollover, differences across weeks and days are exact
+class GpsTime
+{
+public:
+	static constexpr int64_t NS_PER_SEC = 1000000000LL;
+	static constexpr int64_t SEC_PER_DAY = 86400;
+	static constexpr int64_t SEC_PER_WEEK = 604800;
+	// Galileo System Time week 0 starts on GPS week 1024 (1999-08-22)
+	static constexpr int GST_WEEK_OFFSET = 1024;
+	// BeiDou Time starts on 2006-01-01 00:00:00 UTC, GPS week 1356, and runs 14 s behind GPS time
+	static constexpr int BDT_WEEK_OFFSET = 1356;
+	static constexpr int BDT_GPS_SECONDS = 14;
+
+	// CONSTRUCTOR
+	constexpr GpsTime() : _ns(0) {}
+
+	// Conversions
+	static constexpr GpsTime fromNanoseconds(int64_t ns) { return GpsTime(ns); }
+	static constexpr GpsTime fromSeconds(double sec) { return GpsTime(roundNs(sec)); }
+	static constexpr GpsTime fromWeekSow(int week, double sow) {
+		return GpsTime(week * SEC_PER_WEEK * NS_PER_SEC + roundNs(sow));
+	}
+	// Galileo System Time is steered to GPS time, only the week numbering differs
+	static constexpr GpsTime fromGalWeekSow(int galWeek, double sow) { return fromWeekSow(galWeek + GST_WEEK_OFFSET, sow); }
+	static constexpr GpsTime fromBdtWeekSow(int bdtWeek, double sow) { return fromWeekSow(bdtWeek + BDT_WEEK_OFFSET, sow + BDT_GPS_SECONDS); }
+	// Calendar date and time of day already in the GPS time scale, full year (eg: 2019)
+	static constexpr GpsTime fromCalendar(int y, int m, int d, int hr, int min, double sec) {
+		int64_t days = daysFromCivil(y, m, d) - daysFromCivil(1980, 1, 6);
+		return GpsTime((days * SEC_PER_DAY + hr * 3600 + min * 60) * NS_PER_SEC + roundNs(sec));
+	}
+	// UTC calendar time, GPS time runs ahead of UTC by the accumulated leap seconds
+	static constexpr GpsTime fromUtc(int y, int m, int d, int hr, int min, double sec) {
+		GpsTime t = fromCalendar(y, m, d, hr, min, sec);
+		return t + static_cast<double>(leapSeconds(t));
+	}
+	// BeiDou Time calendar, a fixed 14 s behind GPS time
+	static constexpr GpsTime fromBdt(int y, int m, int d, int hr, int min, double sec) {
+		return fromCalendar(y, m, d, hr, min, sec) + static_cast<double>(BDT_GPS_SECONDS);
+	}
+	// GLONASS time is UTC(SU) + 3 hours
+	static constexpr GpsTime fromGlonass(int y, int m, int d, int hr, int min, double sec) {
+		return fromUtc(y, m, d, hr, min, sec) - 3.0 * 3600;
+	}
+
+	// Accessors
+	constexpr int64_t nanoseconds() const { return _ns; }
+	// Continuous seconds since the GPS epoch
+	constexpr double seconds() const { return static_cast<double>(_ns) / NS_PER_SEC; }
+	constexpr int week() const { return static_cast<int>(floorDiv(_ns, SEC_PER_WEEK * NS_PER_SEC)); }
+	constexpr double sow() const {
+		return static_cast<double>(_ns - floorDiv(_ns, SEC_PER_WEEK * NS_PER_SEC) * SEC_PER_WEEK * NS_PER_SEC) / NS_PER_SEC;
+	}
+	constexpr int galWeek() const { return week() - GST_WEEK_OFFSET; }
+	// UTC and GLONASS views of this instant, as continuous seconds on the GPS epoch
+	constexpr GpsTime toUtc() const { return *this - static_cast<double>(leapSeconds(*this)); }
+	constexpr GpsTime toGlonass() const { return toUtc() + 3.0 * 3600; }
+
+	// Operators, differences are in seconds
+	constexpr double operator-(GpsTime rhs) const { return static_cast<double>(_ns - rhs._ns) / NS_PER_SEC; }
+	constexpr GpsTime operator+(double sec) const { return GpsTime(_ns + roundNs(sec)); }
+	constexpr GpsTime operator-(double sec) const { return GpsTime(_ns - roundNs(sec)); }
+	constexpr bool operator==(GpsTime rhs) const { return _ns == rhs._ns; }
+	constexpr bool operator!=(GpsTime rhs) const { return _ns != rhs._ns; }
+	constexpr bool operator<(GpsTime rhs) const { return _ns < rhs._ns; }
+	constexpr bool operator<=(GpsTime rhs) const { return _ns <= rhs._ns; }
+	constexpr bool operator>(GpsTime rhs) const { return _ns > rhs._ns; }
+	constexpr bool operator>=(GpsTime rhs) const { return _ns >= rhs._ns; }
+
+	// GPS - UTC in seconds at a given time
+	static constexpr int leapSeconds(GpsTime t) {
+		// Dates at which a leap second took effect, in GPS days since the epoch
+		const int64_t steps[] = {
+			daysFromCivil(1981, 7, 1), daysFromCivil(1982, 7, 1), daysFromCivil(1983, 7, 1),
+			daysFromCivil(1985, 7, 1), daysFromCivil(1988, 1, 1), daysFromCivil(1990, 1, 1),
+			daysFromCivil(1991, 1, 1), daysFromCivil(1992, 7, 1), daysFromCivil(1993, 7, 1),
+			daysFromCivil(1994, 7, 1), daysFromCivil(1996, 1, 1), daysFromCivil(1997, 7, 1),
+			daysFromCivil(1999, 1, 1), daysFromCivil(2006, 1, 1), daysFromCivil(2009, 1, 1),
+			daysFromCivil(2012, 7, 1), daysFromCivil(2015, 7, 1), daysFromCivil(2017, 1, 1) };
+		int64_t day = floorDiv(t._ns, SEC_PER_DAY * NS_PER_SEC) + daysFromCivil(1980, 1, 6);
+		int leap = 0;
+		for (int64_t step : steps) { if (day >= step) { leap++; } }
+		return leap;
+	}
+
+private:
+	constexpr explicit GpsTime(int64_t ns) : _ns(ns) {}
+
+	// Days since 1970-01-01 of a proleptic Gregorian date
+	static constexpr int64_t daysFromCivil(int64_t y, int64_t m, int64_t d) {
+		y -= (m <= 2) ? 1 : 0;
+		int64_t era = floorDiv(y, 400);
+		int64_t yoe = y - era * 400;
+		int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+		int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + doe - 719468;
+	}
+	static constexpr int64_t floorDiv(int64_t a, int64_t b) {
+		return (a >= 0) ? a / b : -((-a + b - 1) / b);
+	}
+	// Seconds to nanoseconds, rounded to the nearest
+	static constexpr int64_t roundNs(double sec) {
+		double ns = sec * NS_PER_SEC;
+		return static_cast<int64_t>(ns < 0 ? ns - 0.5 : ns + 0.5);
+	}
+
+	int64_t _ns;
+};
+
 // Functions
-double gpsTime(std::vector<double> epochInfo);
+// Epoch as read from a file: year month day hour minute second, in the GPS time scale
+// Two digit years follow the Rinex 2 rule, 80-99 is 19xx and 00-79 is 20xx
+// An incomplete epoch gives the GPS epoch
+GpsTime gpsTime(const std::vector<double>& epochInfo);
+// Same for a fixed array of the 6 values
+GpsTime gpsTime(const double* epochInfo);
+// Same for an epoch given in UTC, for eg: GLONASS navigation records
+GpsTime gpsTimeFromUtc(const std::vector<double>& epochInfo);
+GpsTime gpsTimeFromUtc(const double* epochInfo);
+// Same for an epoch given in BeiDou Time
+GpsTime gpsTimeFromBdt(const double* epochInfo);
 
 #endif /* TIMEUTILS_H_ */
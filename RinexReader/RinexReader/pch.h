@@ -3,12 +3,16 @@
 
 // TODO: add pre-compiled headers here
 #include <iostream>
-#include <iomanip>  
+#include <iomanip>
 #include <string>
+#include <string_view>
 #include <fstream>
-#include <sstream> 
+#include <sstream>
 #include <iterator>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 #endif //PCH_H